@@ -1,5 +1,5 @@
 #
-# Copyright (c) 2013-2018, ARM Limited and Contributors. All rights reserved.
+# Copyright (c) 2013-2019, ARM Limited and Contributors. All rights reserved.
 #
 # SPDX-License-Identifier: BSD-3-Clause
 #
@@ -25,4 +25,9 @@ ifeq (${TRUSTED_BOARD_BOOT},1)
 BL1_SOURCES		+=	bl1/bl1_fwu.c
 endif
 
+# The generic DMA interface serialises the use of the engine with a spinlock
+ifeq (${USE_DMA_MEMCPY},1)
+BL1_SOURCES		+=	lib/locks/exclusive/${ARCH}/spinlock.S
+endif
+
 BL1_LINKERFILE		:=	bl1/bl1.ld.S
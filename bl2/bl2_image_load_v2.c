@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -19,9 +19,48 @@
 
 #include "bl2_private.h"
 
+/*******************************************************************************
+ * Call the platform hook that handles the information of a loaded image.
+ ******************************************************************************/
+static void bl2_post_image_load(const bl_load_info_node_t *node)
+{
+	int err;
+
+	err = bl2_plat_handle_post_image_load(node->image_id);
+	if (err) {
+		ERROR("BL2: Failure in post image load handling (%i)\n", err);
+		plat_error_handler(err);
+	}
+}
+
+#if BL2_OVERLAP_IMAGE_LOAD
+/*******************************************************************************
+ * Complete the loading of an image given the result of its authentication. If
+ * that failed, load the image again from the next boot source, if any.
+ ******************************************************************************/
+static void bl2_finish_image(const bl_load_info_node_t *node, int err)
+{
+	if ((err != 0) && (plat_try_next_boot_source() != 0)) {
+		err = load_auth_image(node->image_id, node->image_info);
+	}
+	if (err) {
+		ERROR("BL2: Failed to load image (%i)\n", err);
+		plat_error_handler(err);
+	}
+
+	bl2_post_image_load(node);
+}
+#endif /* BL2_OVERLAP_IMAGE_LOAD */
+
 /*******************************************************************************
  * This function loads SCP_BL2/BL3x images and returns the ep_info for
  * the next executable image.
+ *
+ * If BL2_OVERLAP_IMAGE_LOAD is enabled, the read of each image is started
+ * before the previous image is authenticated, so that a device that reads
+ * with DMA transfers the image while the CPU authenticates the previous one.
+ * The images are still read one at a time, and the parents of an image in
+ * the chain of trust are loaded and authenticated before its read starts.
  ******************************************************************************/
 struct entry_point_info *bl2_load_images(void)
 {
@@ -30,6 +69,17 @@ struct entry_point_info *bl2_load_images(void)
 	const bl_load_info_node_t *bl2_node_info;
 	int plat_setup_done = 0;
 	int err;
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+	unsigned long long start_cnt = read_cntpct_el0();
+	u_register_t cnt_freq;
+#endif
+#if BL2_OVERLAP_IMAGE_LOAD
+	/* Image that has been read but not authenticated yet */
+	const bl_load_info_node_t *pending_node = NULL;
+	image_load_req_t req[2];
+	unsigned int cur_req = 0U;
+	int started;
+#endif
 
 	/*
 	 * Get information about the images to load.
@@ -63,6 +113,44 @@ struct entry_point_info *bl2_load_images(void)
 			plat_error_handler(err);
 		}
 
+#if BL2_OVERLAP_IMAGE_LOAD
+		started = 0;
+		if (!(bl2_node_info->image_info->h.attr & IMAGE_ATTRIB_SKIP_LOADING)) {
+			INFO("BL2: Loading image id %d\n", bl2_node_info->image_id);
+			started = (load_auth_image_start(bl2_node_info->image_id,
+					bl2_node_info->image_info,
+					&req[cur_req]) == 0);
+		}
+
+		/* Authenticate the previous image while this one is read */
+		if (pending_node != NULL) {
+			err = load_auth_image_verify(&req[cur_req ^ 1U]);
+		}
+		if (started) {
+			started = (load_auth_image_wait(&req[cur_req]) == 0);
+		}
+		if (pending_node != NULL) {
+			bl2_finish_image(pending_node, err);
+			pending_node = NULL;
+		}
+
+		if (bl2_node_info->image_info->h.attr & IMAGE_ATTRIB_SKIP_LOADING) {
+			INFO("BL2: Skip loading image id %d\n", bl2_node_info->image_id);
+			bl2_post_image_load(bl2_node_info);
+		} else if (started) {
+			pending_node = bl2_node_info;
+			cur_req ^= 1U;
+		} else {
+			/* Fall back to loading the image synchronously */
+			err = load_auth_image(bl2_node_info->image_id,
+				bl2_node_info->image_info);
+			if (err) {
+				ERROR("BL2: Failed to load image (%i)\n", err);
+				plat_error_handler(err);
+			}
+			bl2_post_image_load(bl2_node_info);
+		}
+#else
 		if (!(bl2_node_info->image_info->h.attr & IMAGE_ATTRIB_SKIP_LOADING)) {
 			INFO("BL2: Loading image id %d\n", bl2_node_info->image_id);
 			err = load_auth_image(bl2_node_info->image_id,
@@ -76,16 +164,30 @@ struct entry_point_info *bl2_load_images(void)
 		}
 
 		/* Allow platform to handle image information. */
-		err = bl2_plat_handle_post_image_load(bl2_node_info->image_id);
-		if (err) {
-			ERROR("BL2: Failure in post image load handling (%i)\n", err);
-			plat_error_handler(err);
-		}
+		bl2_post_image_load(bl2_node_info);
+#endif /* BL2_OVERLAP_IMAGE_LOAD */
 
 		/* Go to next image */
 		bl2_node_info = bl2_node_info->next_load_info;
 	}
 
+#if BL2_OVERLAP_IMAGE_LOAD
+	if (pending_node != NULL) {
+		bl2_finish_image(pending_node,
+				 load_auth_image_verify(&req[cur_req ^ 1U]));
+	}
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+	/* CNTFRQ is only valid if the platform has programmed it */
+	cnt_freq = read_cntfrq_el0();
+	if (cnt_freq != 0U) {
+		INFO("BL2: Images loaded in %llu us\n",
+		     ((read_cntpct_el0() - start_cnt) * 1000000ULL) /
+		     cnt_freq);
+	}
+#endif
+
 	/*
 	 * Get information to pass to the next image.
 	 */
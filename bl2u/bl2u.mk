@@ -1,5 +1,5 @@
 #
-# Copyright (c) 2015-2017, ARM Limited and Contributors. All rights reserved.
+# Copyright (c) 2015-2019, ARM Limited and Contributors. All rights reserved.
 #
 # SPDX-License-Identifier: BSD-3-Clause
 #
@@ -12,4 +12,9 @@ ifeq (${ARCH},aarch64)
 BL2U_SOURCES		+=	common/aarch64/early_exceptions.S
 endif
 
+# The generic DMA interface serialises the use of the engine with a spinlock
+ifeq (${USE_DMA_MEMCPY},1)
+BL2U_SOURCES		+=	lib/locks/exclusive/${ARCH}/spinlock.S
+endif
+
 BL2U_LINKERFILE		:=	bl2u/bl2u.ld.S
@@ -47,6 +47,19 @@ ifeq (${EL3_EXCEPTION_HANDLING},1)
 BL31_SOURCES		+=	bl31/ehf.c
 endif
 
+ifeq (${ENABLE_EHF_STATS},1)
+ifeq (${EL3_EXCEPTION_HANDLING},0)
+  $(error EL3_EXCEPTION_HANDLING must be 1 for ENABLE_EHF_STATS)
+endif
+ifeq (${ENABLE_PMF},0)
+  $(error ENABLE_PMF must be 1 for ENABLE_EHF_STATS)
+endif
+endif
+
+ifeq (${ENABLE_EL3_TRACE},1)
+BL31_SOURCES		+=	lib/el3_trace/el3_trace.c
+endif
+
 ifeq (${SDEI_SUPPORT},1)
 ifeq (${EL3_EXCEPTION_HANDLING},0)
   $(error EL3_EXCEPTION_HANDLING must be 1 for SDEI support)
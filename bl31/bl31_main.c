@@ -16,6 +16,7 @@
 #include <common/runtime_svc.h>
 #include <drivers/console.h>
 #include <lib/el3_runtime/context_mgmt.h>
+#include <lib/el3_trace/el3_trace.h>
 #include <lib/pmf/pmf.h>
 #include <lib/runtime_instr.h>
 #include <plat/common/platform.h>
@@ -61,6 +62,10 @@ uintptr_t get_arm_std_svc_args(unsigned int svc_mask)
 void __init bl31_lib_init(void)
 {
 	cm_init();
+
+#if ENABLE_EL3_TRACE
+	el3_trace_init();
+#endif
 }
 
 /*******************************************************************************
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -11,6 +11,7 @@
 #include <assert.h>
 #include <stdbool.h>
 
+#include <arch_helpers.h>
 #include <bl31/ehf.h>
 #include <bl31/interrupt_mgmt.h>
 #include <context.h>
@@ -19,6 +20,8 @@
 #include <lib/el3_runtime/context_mgmt.h>
 #include <lib/el3_runtime/cpu_data.h>
 #include <lib/el3_runtime/pubsub_events.h>
+#include <lib/el3_trace/el3_trace.h>
+#include <lib/pmf/pmf.h>
 #include <plat/common/platform.h>
 
 /* Output EHF logs as verbose */
@@ -50,6 +53,98 @@
 /* To be defined by the platform */
 extern const ehf_priorities_t exception_data;
 
+CASSERT(EHF_MAX_PRIORITIES == (sizeof(ehf_pri_bits_t) * 8U),
+	assert_ehf_max_priorities_mismatch);
+
+#if ENABLE_EHF_STATS
+PMF_REGISTER_SERVICE_SMC(ehf_svc, PMF_EHF_STAT_SVC_ID, EHF_STAT_TOTAL_IDS,
+	PMF_STORE_ENABLE)
+
+static unsigned long long ehf_stat_read(unsigned int tid)
+{
+	unsigned long long val;
+
+	PMF_GET_TIMESTAMP_BY_INDEX(ehf_svc, tid, plat_my_core_pos(),
+			PMF_NO_CACHE_MAINT, val);
+
+	return val;
+}
+
+static void ehf_stat_inc(unsigned int tid)
+{
+	unsigned long long val = ehf_stat_read(tid) + 1ULL;
+
+	PMF_WRITE_TIMESTAMP(ehf_svc, tid, PMF_NO_CACHE_MAINT, val);
+}
+
+/* Record the time a priority level was held for, if it's the longest yet */
+static void ehf_stat_hold(unsigned int idx, unsigned long long start)
+{
+	unsigned long long hold = read_cntpct_el0() - start;
+
+	if (hold > ehf_stat_read(EHF_STAT_ID_MAX_HOLD(idx))) {
+		PMF_WRITE_TIMESTAMP(ehf_svc, EHF_STAT_ID_MAX_HOLD(idx),
+				PMF_NO_CACHE_MAINT, hold);
+	}
+}
+
+static void ehf_stat_activate(unsigned int idx, bool nested)
+{
+	if (nested)
+		ehf_stat_inc(EHF_STAT_ID_NESTED);
+	ehf_stat_inc(EHF_STAT_ID_ACTIVATE(idx));
+	PMF_CAPTURE_TIMESTAMP(ehf_svc, EHF_STAT_ID_START(idx),
+			PMF_NO_CACHE_MAINT);
+}
+
+static void ehf_stat_deactivate(unsigned int idx)
+{
+	ehf_stat_hold(idx, ehf_stat_read(EHF_STAT_ID_START(idx)));
+}
+
+static unsigned long long ehf_stat_intr_enter(unsigned int idx, bool nested)
+{
+	if (nested)
+		ehf_stat_inc(EHF_STAT_ID_NESTED);
+	ehf_stat_inc(EHF_STAT_ID_INTR(idx));
+
+	return read_cntpct_el0();
+}
+
+static void ehf_stat_intr_exit(unsigned int idx, unsigned long long start)
+{
+	ehf_stat_hold(idx, start);
+}
+
+static void ehf_stat_ns_preempt(void)
+{
+	ehf_stat_inc(EHF_STAT_ID_NS_PREEMPT);
+}
+#else
+static inline void ehf_stat_activate(unsigned int idx, bool nested)
+{
+}
+
+static inline void ehf_stat_deactivate(unsigned int idx)
+{
+}
+
+static inline unsigned long long ehf_stat_intr_enter(unsigned int idx,
+		bool nested)
+{
+	return 0ULL;
+}
+
+static inline void ehf_stat_intr_exit(unsigned int idx,
+		unsigned long long start)
+{
+}
+
+static inline void ehf_stat_ns_preempt(void)
+{
+}
+#endif /* ENABLE_EHF_STATS */
+
 /* Translate priority to the index in the priority array */
 static unsigned int pri_to_idx(unsigned int priority)
 {
@@ -150,6 +245,11 @@ void ehf_activate_priority(unsigned int priority)
 	if (cur_pri_idx == EHF_INVALID_IDX)
 		pe_data->init_pri_mask = (uint8_t) old_mask;
 
+	ehf_stat_activate(idx, cur_pri_idx != EHF_INVALID_IDX);
+
+	EL3_TRACE2(EL3_TRACE_EV_EHF_ACTIVATE, priority,
+			pe_data->active_pri_bits);
+
 	EHF_LOG("activate prio=%d\n", get_pe_highest_active_idx(pe_data));
 }
 
@@ -195,6 +295,8 @@ void ehf_deactivate_priority(unsigned int priority)
 		panic();
 	}
 
+	ehf_stat_deactivate(idx);
+
 	/* Clear bit corresponding to highest priority */
 	pe_data->active_pri_bits &= (pe_data->active_pri_bits - 1u);
 
@@ -214,6 +316,9 @@ void ehf_deactivate_priority(unsigned int priority)
 		panic();
 	}
 
+	EL3_TRACE2(EL3_TRACE_EV_EHF_DEACTIVATE, priority,
+			pe_data->active_pri_bits);
+
 	EHF_LOG("deactivate prio=%d\n", get_pe_highest_active_idx(pe_data));
 }
 
@@ -356,6 +461,8 @@ void ehf_allow_ns_preemption(uint64_t preempt_ret_code)
 	EHF_LOG("Priority Mask: 0x%x => 0x%x\n", old_pmr, pe_data->ns_pri_mask);
 
 	pe_data->ns_pri_mask = 0;
+
+	ehf_stat_ns_preempt();
 }
 
 /*
@@ -396,6 +503,7 @@ static uint64_t ehf_el3_interrupt_handler(uint32_t id, uint32_t flags,
 	int ret = 0;
 	uint32_t intr_raw;
 	unsigned int intr, pri, idx;
+	unsigned long long start;
 	ehf_handler_t handler;
 
 	/*
@@ -440,12 +548,19 @@ static uint64_t ehf_el3_interrupt_handler(uint32_t id, uint32_t flags,
 		panic();
 	}
 
+	EL3_TRACE2(EL3_TRACE_EV_EHF_INTR, intr_raw, pri);
+
+	start = ehf_stat_intr_enter(idx,
+			has_valid_pri_activations(this_cpu_data()));
+
 	/*
 	 * Call registered handler. Pass the raw interrupt value to registered
 	 * handlers.
 	 */
 	ret = handler(intr_raw, flags, handle, cookie);
 
+	ehf_stat_intr_exit(idx, start);
+
 	return (uint64_t) ret;
 }
 
@@ -7,9 +7,11 @@
 #include <assert.h>
 #include <errno.h>
 
+#include <arch_helpers.h>
 #include <common/bl_common.h>
 #include <bl31/interrupt_mgmt.h>
 #include <lib/el3_runtime/context_mgmt.h>
+#include <lib/el3_trace/el3_trace.h>
 #include <plat/common/platform.h>
 
 /*******************************************************************************
@@ -222,6 +224,8 @@ interrupt_type_handler_t get_interrupt_type_handler(uint32_t type)
 	if (validate_interrupt_type(type) != 0)
 		return NULL;
 
+	EL3_TRACE2(EL3_TRACE_EV_INTR_ROUTE, type, read_scr_el3() & SCR_NS_BIT);
+
 	return intr_type_descs[type].handler;
 }
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -59,25 +59,25 @@ uintptr_t page_align(uintptr_t value, unsigned dir)
 }
 
 /*******************************************************************************
- * Internal function to load an image at a specific address given
- * an image ID and extents of free memory.
- *
- * If the load is successful then the image information is updated.
+ * Internal function to start loading an image at a specific address given
+ * an image ID and extents of free memory. The image is read with a split-phase
+ * read that completes in load_image_wait().
  *
  * Returns 0 on success, a negative error code otherwise.
  ******************************************************************************/
-static int load_image(unsigned int image_id, image_info_t *image_data)
+static int load_image_start(unsigned int image_id, image_info_t *image_data,
+			    image_load_req_t *req)
 {
 	uintptr_t dev_handle;
 	uintptr_t image_handle;
 	uintptr_t image_spec;
 	uintptr_t image_base;
 	size_t image_size;
-	size_t bytes_read;
 	int io_result;
 
 	assert(image_data != NULL);
 	assert(image_data->h.version >= VERSION_2);
+	assert(req != NULL);
 
 	image_base = image_data->image_base;
 
@@ -121,55 +121,96 @@ static int load_image(unsigned int image_id, image_info_t *image_data)
 	image_data->image_size = (uint32_t)image_size;
 
 	/* We have enough space so load the image now */
-	/* TODO: Consider whether to try to recover/retry a partially successful read */
-	io_result = io_read(image_handle, image_base, image_size, &bytes_read);
-	if ((io_result != 0) || (bytes_read < image_size)) {
+	io_result = io_read_start(image_handle, image_base, image_size);
+	if (io_result != 0) {
 		WARN("Failed to load image id=%u (%i)\n", image_id, io_result);
 		goto exit;
 	}
 
-	INFO("Image id=%u loaded: 0x%lx - 0x%lx\n", image_id, image_base,
-	     (uintptr_t)(image_base + image_size));
+	req->image_id = image_id;
+	req->image_data = image_data;
+	req->dev_handle = dev_handle;
+	req->image_handle = image_handle;
+
+	return 0;
 
 exit:
 	(void)io_close(image_handle);
+	(void)io_dev_close(dev_handle);
+
+	return io_result;
+}
+
+/*******************************************************************************
+ * Wait for the end of the read started by load_image_start() and release the
+ * image and device handles.
+ *
+ * Returns 0 on success, a negative error code otherwise.
+ ******************************************************************************/
+static int load_image_wait(image_load_req_t *req)
+{
+	image_info_t *image_data = req->image_data;
+	size_t bytes_read;
+	int io_result;
+
+	/* TODO: Consider whether to try to recover/retry a partially successful read */
+	io_result = io_read_wait(req->image_handle, &bytes_read);
+	if ((io_result != 0) || (bytes_read < image_data->image_size)) {
+		WARN("Failed to load image id=%u (%i)\n", req->image_id,
+		     io_result);
+		if (io_result == 0) {
+			io_result = -EIO;
+		}
+		goto exit;
+	}
+
+	INFO("Image id=%u loaded: 0x%lx - 0x%lx\n", req->image_id,
+	     image_data->image_base,
+	     (uintptr_t)(image_data->image_base + image_data->image_size));
+
+exit:
+	(void)io_close(req->image_handle);
 	/* Ignore improbable/unrecoverable error in 'close' */
 
 	/* TODO: Consider maintaining open device connection from this bootloader stage */
-	(void)io_dev_close(dev_handle);
+	(void)io_dev_close(req->dev_handle);
 	/* Ignore improbable/unrecoverable error in 'dev_close' */
 
 	return io_result;
 }
 
-static int load_auth_image_internal(unsigned int image_id,
-				    image_info_t *image_data,
-				    int is_parent_image)
+/*******************************************************************************
+ * Internal function to load an image at a specific address given
+ * an image ID and extents of free memory.
+ *
+ * If the load is successful then the image information is updated.
+ *
+ * Returns 0 on success, a negative error code otherwise.
+ ******************************************************************************/
+static int load_image(unsigned int image_id, image_info_t *image_data)
 {
-	int rc;
-
-#if TRUSTED_BOARD_BOOT
-	if (dyn_is_auth_disabled() == 0) {
-		unsigned int parent_id;
+	image_load_req_t req;
+	int io_result;
 
-		/* Use recursion to authenticate parent images */
-		rc = auth_mod_get_parent_id(image_id, &parent_id);
-		if (rc == 0) {
-			rc = load_auth_image_internal(parent_id, image_data, 1);
-			if (rc != 0) {
-				return rc;
-			}
-		}
+	io_result = load_image_start(image_id, image_data, &req);
+	if (io_result != 0) {
+		return io_result;
 	}
-#endif /* TRUSTED_BOARD_BOOT */
 
-	/* Load the image */
-	rc = load_image(image_id, image_data);
-	if (rc != 0) {
-		return rc;
-	}
+	return load_image_wait(&req);
+}
 
+/*
+ * Authenticate a loaded image, then flush it to main memory so that it can be
+ * executed later by any CPU, regardless of cache and MMU state. Parent images
+ * (certificates) are not flushed.
+ */
+static int auth_loaded_image(unsigned int image_id, image_info_t *image_data,
+			     int is_parent_image)
+{
 #if TRUSTED_BOARD_BOOT
+	int rc;
+
 	if (dyn_is_auth_disabled() == 0) {
 		/* Authenticate it */
 		rc = auth_mod_verify_img(image_id,
@@ -186,21 +227,44 @@ static int load_auth_image_internal(unsigned int image_id,
 	}
 #endif /* TRUSTED_BOARD_BOOT */
 
-	/*
-	 * Flush the image to main memory so that it can be executed later by
-	 * any CPU, regardless of cache and MMU state. If TBB is enabled, then
-	 * the file has been successfully loaded and authenticated and flush
-	 * only for child images, not for the parents (certificates).
-	 */
 	if (is_parent_image == 0) {
 		flush_dcache_range(image_data->image_base,
 				   image_data->image_size);
 	}
 
-
 	return 0;
 }
 
+static int load_auth_image_internal(unsigned int image_id,
+				    image_info_t *image_data,
+				    int is_parent_image)
+{
+	int rc;
+
+#if TRUSTED_BOARD_BOOT
+	if (dyn_is_auth_disabled() == 0) {
+		unsigned int parent_id;
+
+		/* Use recursion to authenticate parent images */
+		rc = auth_mod_get_parent_id(image_id, &parent_id);
+		if (rc == 0) {
+			rc = load_auth_image_internal(parent_id, image_data, 1);
+			if (rc != 0) {
+				return rc;
+			}
+		}
+	}
+#endif /* TRUSTED_BOARD_BOOT */
+
+	/* Load the image */
+	rc = load_image(image_id, image_data);
+	if (rc != 0) {
+		return rc;
+	}
+
+	return auth_loaded_image(image_id, image_data, is_parent_image);
+}
+
 /*******************************************************************************
  * Generic function to load and authenticate an image. The image is actually
  * loaded by calling the 'load_image()' function. Therefore, it returns the
@@ -219,6 +283,44 @@ int load_auth_image(unsigned int image_id, image_info_t *image_data)
 	return err;
 }
 
+/*******************************************************************************
+ * Split-phase version of load_auth_image(). load_auth_image_start() loads and
+ * authenticates the parent images, then starts reading the image itself.
+ * load_auth_image_wait() waits for the end of the read, after which the
+ * device can be used to load other images. load_auth_image_verify() then
+ * authenticates the image. The boot source is not changed on failure.
+ ******************************************************************************/
+int load_auth_image_start(unsigned int image_id, image_info_t *image_data,
+			  image_load_req_t *req)
+{
+#if TRUSTED_BOARD_BOOT
+	if (dyn_is_auth_disabled() == 0) {
+		unsigned int parent_id;
+		int rc;
+
+		rc = auth_mod_get_parent_id(image_id, &parent_id);
+		if (rc == 0) {
+			rc = load_auth_image_internal(parent_id, image_data, 1);
+			if (rc != 0) {
+				return rc;
+			}
+		}
+	}
+#endif /* TRUSTED_BOARD_BOOT */
+
+	return load_image_start(image_id, image_data, req);
+}
+
+int load_auth_image_wait(image_load_req_t *req)
+{
+	return load_image_wait(req);
+}
+
+int load_auth_image_verify(image_load_req_t *req)
+{
+	return auth_loaded_image(req->image_id, req->image_data, 0);
+}
+
 /*******************************************************************************
  * Print the content of an entry_point_info_t structure.
  ******************************************************************************/
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2018-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -7,12 +7,357 @@
 /* Helper functions to offer easier navigation of Device Tree Blob */
 
 #include <assert.h>
+#include <stdbool.h>
 #include <string.h>
 
 #include <libfdt.h>
 
 #include <common/debug.h>
 #include <common/fdt_wrappers.h>
+#include <lib/cassert.h>
+#include <lib/utils_def.h>
+
+#if FDT_INDEX
+/*
+ * Index of the nodes of a DTB, built in one pass by fdtw_index_build(). Hash
+ * tables map the paths, compatible strings and phandles of the nodes to their
+ * offsets, so that the fdtw_*_offset() lookups don't walk the whole DTB. The
+ * lookups fall back to libfdt when the index doesn't cover the DTB they are
+ * given, or when it couldn't record all the nodes.
+ */
+#ifndef FDT_INDEX_MAX_NODES
+#define FDT_INDEX_MAX_NODES	U(256)
+#endif
+#ifndef FDT_INDEX_MAX_COMPAT
+#define FDT_INDEX_MAX_COMPAT	U(256)
+#endif
+#define FDT_INDEX_MAX_DEPTH	16
+/* Longest path checked against the index, longer ones are left to libfdt */
+#define FDT_INDEX_MAX_PATH	128
+
+/* The hash tables are kept at most half full */
+#define FDT_INDEX_NODE_BUCKETS		(2U * FDT_INDEX_MAX_NODES)
+#define FDT_INDEX_COMPAT_BUCKETS	(2U * FDT_INDEX_MAX_COMPAT)
+
+CASSERT(((FDT_INDEX_MAX_NODES & (FDT_INDEX_MAX_NODES - 1U)) == 0U) &&
+	(FDT_INDEX_MAX_NODES < U(0x4000)), assert_fdt_index_max_nodes);
+CASSERT(((FDT_INDEX_MAX_COMPAT & (FDT_INDEX_MAX_COMPAT - 1U)) == 0U) &&
+	(FDT_INDEX_MAX_COMPAT < U(0x4000)), assert_fdt_index_max_compat);
+
+#define FDT_INDEX_HASH_INIT	2166136261U
+
+static struct {
+	/* DTB covered by the index, NULL if the index is invalid */
+	const void *dtb;
+
+	/* false if some nodes or compatible strings couldn't be recorded */
+	bool nodes_complete;
+	bool compat_complete;
+
+	unsigned int num_nodes;
+	struct {
+		int offset;
+		uint32_t path_hash;
+		uint32_t phandle;
+	} node[FDT_INDEX_MAX_NODES];
+
+	/* Nodes with the same compatible string are chained in DTB order */
+	unsigned int num_compat;
+	struct {
+		int offset;
+		uint32_t hash;
+		int16_t next;
+		int16_t last;
+	} compat[FDT_INDEX_MAX_COMPAT];
+
+	/* Indices in node[] and compat[], -1 for an empty bucket */
+	int16_t path_bucket[FDT_INDEX_NODE_BUCKETS];
+	int16_t phandle_bucket[FDT_INDEX_NODE_BUCKETS];
+	int16_t compat_bucket[FDT_INDEX_COMPAT_BUCKETS];
+} fdt_index;
+
+/* FNV-1a hash */
+static uint32_t fdt_index_hash(uint32_t hash, const char *str, size_t len)
+{
+	size_t i;
+
+	for (i = 0U; i < len; i++) {
+		hash ^= (uint8_t)str[i];
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
+static void fdt_index_add_node(int offset, uint32_t path_hash,
+			       uint32_t phandle)
+{
+	unsigned int idx = fdt_index.num_nodes;
+	unsigned int b;
+
+	if (idx == FDT_INDEX_MAX_NODES) {
+		fdt_index.nodes_complete = false;
+		return;
+	}
+
+	fdt_index.num_nodes++;
+	fdt_index.node[idx].offset = offset;
+	fdt_index.node[idx].path_hash = path_hash;
+	fdt_index.node[idx].phandle = phandle;
+
+	for (b = path_hash & (FDT_INDEX_NODE_BUCKETS - 1U);
+	     fdt_index.path_bucket[b] >= 0;
+	     b = (b + 1U) & (FDT_INDEX_NODE_BUCKETS - 1U))
+		;
+	fdt_index.path_bucket[b] = (int16_t)idx;
+
+	if (phandle == 0U)
+		return;
+
+	for (b = phandle & (FDT_INDEX_NODE_BUCKETS - 1U);
+	     fdt_index.phandle_bucket[b] >= 0;
+	     b = (b + 1U) & (FDT_INDEX_NODE_BUCKETS - 1U))
+		;
+	fdt_index.phandle_bucket[b] = (int16_t)idx;
+}
+
+static void fdt_index_add_compat(int offset, const char *compat, size_t len)
+{
+	uint32_t hash = fdt_index_hash(FDT_INDEX_HASH_INIT, compat, len);
+	unsigned int idx = fdt_index.num_compat;
+	unsigned int b;
+	int16_t head;
+
+	if (idx == FDT_INDEX_MAX_COMPAT) {
+		fdt_index.compat_complete = false;
+		return;
+	}
+
+	fdt_index.num_compat++;
+	fdt_index.compat[idx].offset = offset;
+	fdt_index.compat[idx].hash = hash;
+	fdt_index.compat[idx].next = -1;
+	fdt_index.compat[idx].last = (int16_t)idx;
+
+	/* Append the node to the chain of the string, if it exists */
+	for (b = hash & (FDT_INDEX_COMPAT_BUCKETS - 1U);
+	     (head = fdt_index.compat_bucket[b]) >= 0;
+	     b = (b + 1U) & (FDT_INDEX_COMPAT_BUCKETS - 1U)) {
+		if (fdt_index.compat[head].hash == hash) {
+			fdt_index.compat[fdt_index.compat[head].last].next =
+				(int16_t)idx;
+			fdt_index.compat[head].last = (int16_t)idx;
+			return;
+		}
+	}
+
+	fdt_index.compat_bucket[b] = (int16_t)idx;
+}
+
+/*
+ * Build the index of the given DTB, replacing the index of any other DTB. The
+ * DTB must not be modified afterwards, other than through
+ * fdtw_write_inplace_cells(), which invalidates the index. Returns 0 on
+ * success, and -1 upon error, in which case the lookups use libfdt.
+ */
+int fdtw_index_build(const void *dtb)
+{
+	uint32_t path_hash[FDT_INDEX_MAX_DEPTH + 1];
+	const char *name, *compat;
+	int offset, depth = 0, len;
+	size_t slen;
+
+	assert(dtb != NULL);
+
+	fdtw_index_invalidate();
+
+	fdt_index.nodes_complete = true;
+	fdt_index.compat_complete = true;
+	fdt_index.num_nodes = 0U;
+	fdt_index.num_compat = 0U;
+	(void)memset(fdt_index.path_bucket, 0xff,
+		     sizeof(fdt_index.path_bucket));
+	(void)memset(fdt_index.phandle_bucket, 0xff,
+		     sizeof(fdt_index.phandle_bucket));
+	(void)memset(fdt_index.compat_bucket, 0xff,
+		     sizeof(fdt_index.compat_bucket));
+
+	/* The walk ends after the root node, with a negative depth */
+	for (offset = 0; (offset >= 0) && (depth >= 0);
+	     offset = fdt_next_node(dtb, offset, &depth)) {
+		if (depth > FDT_INDEX_MAX_DEPTH) {
+			fdt_index.nodes_complete = false;
+			fdt_index.compat_complete = false;
+			continue;
+		}
+
+		name = fdt_get_name(dtb, offset, &len);
+		if (name == NULL) {
+			return -1;
+		}
+
+		/* The path of a node is the path of its parent, '/', name */
+		if (depth == 0) {
+			path_hash[0] = FDT_INDEX_HASH_INIT;
+		} else {
+			path_hash[depth] = fdt_index_hash(
+				fdt_index_hash(path_hash[depth - 1], "/", 1U),
+				name, (size_t)len);
+		}
+
+		fdt_index_add_node(offset, path_hash[depth],
+				   fdt_get_phandle(dtb, offset));
+
+		compat = fdt_getprop(dtb, offset, "compatible", &len);
+		while ((compat != NULL) && (len > 0)) {
+			slen = strnlen(compat, (size_t)len);
+			fdt_index_add_compat(offset, compat, slen);
+			compat += slen + 1U;
+			len -= (int)slen + 1;
+		}
+	}
+
+	if ((offset < 0) && (offset != -FDT_ERR_NOTFOUND)) {
+		WARN("Couldn't index the dtb (%d)\n", offset);
+		return -1;
+	}
+
+	fdt_index.dtb = dtb;
+
+	VERBOSE("Indexed %u nodes and %u compatible strings of the dtb\n",
+		fdt_index.num_nodes, fdt_index.num_compat);
+
+	return 0;
+}
+
+void fdtw_index_invalidate(void)
+{
+	fdt_index.dtb = NULL;
+}
+#endif /* FDT_INDEX */
+
+/*
+ * Same as fdt_node_offset_by_compatible(), using the index if it covers the
+ * DTB.
+ */
+int fdtw_node_offset_by_compatible(const void *dtb, int startoffset,
+		const char *compat)
+{
+#if FDT_INDEX
+	uint32_t hash;
+	unsigned int b;
+	int16_t idx;
+
+	if ((dtb == fdt_index.dtb) && fdt_index.compat_complete) {
+		hash = fdt_index_hash(FDT_INDEX_HASH_INIT, compat,
+				      strlen(compat));
+
+		for (b = hash & (FDT_INDEX_COMPAT_BUCKETS - 1U);
+		     (idx = fdt_index.compat_bucket[b]) >= 0;
+		     b = (b + 1U) & (FDT_INDEX_COMPAT_BUCKETS - 1U)) {
+			if (fdt_index.compat[idx].hash != hash) {
+				continue;
+			}
+
+			/* Skip the other strings with the same hash */
+			for (; idx >= 0; idx = fdt_index.compat[idx].next) {
+				int offset = fdt_index.compat[idx].offset;
+
+				if ((offset > startoffset) &&
+				    (fdt_node_check_compatible(dtb, offset,
+							       compat) == 0)) {
+					return offset;
+				}
+			}
+			break;
+		}
+
+		return -FDT_ERR_NOTFOUND;
+	}
+#endif
+
+	return fdt_node_offset_by_compatible(dtb, startoffset, compat);
+}
+
+/*
+ * Same as fdt_path_offset(), using the index if it covers the DTB. Aliases,
+ * and node names given without their unit address, are resolved by libfdt.
+ */
+int fdtw_path_offset(const void *dtb, const char *path)
+{
+#if FDT_INDEX
+	char node_path[FDT_INDEX_MAX_PATH];
+	size_t len = strlen(path);
+	uint32_t hash;
+	unsigned int b;
+	int16_t idx;
+
+	if ((dtb == fdt_index.dtb) && (path[0] == '/')) {
+		/* Ignore trailing slashes */
+		while ((len > 1U) && (path[len - 1U] == '/')) {
+			len--;
+		}
+
+		if (len == 1U) {
+			len = 0U;
+		}
+
+		hash = fdt_index_hash(FDT_INDEX_HASH_INIT, path, len);
+
+		for (b = hash & (FDT_INDEX_NODE_BUCKETS - 1U);
+		     (idx = fdt_index.path_bucket[b]) >= 0;
+		     b = (b + 1U) & (FDT_INDEX_NODE_BUCKETS - 1U)) {
+			int offset = fdt_index.node[idx].offset;
+
+			if (fdt_index.node[idx].path_hash != hash) {
+				continue;
+			}
+
+			/*
+			 * Paths with the same hash are told apart by the full
+			 * path of the node, the root node's being "/".
+			 */
+			if ((fdt_get_path(dtb, offset, node_path,
+					  sizeof(node_path)) == 0) &&
+			    (strlen(node_path) == ((len == 0U) ? 1U : len)) &&
+			    (memcmp(node_path, path, strlen(node_path)) == 0)) {
+				return offset;
+			}
+		}
+	}
+#endif
+
+	return fdt_path_offset(dtb, path);
+}
+
+/*
+ * Same as fdt_node_offset_by_phandle(), using the index if it covers the DTB.
+ */
+int fdtw_node_offset_by_phandle(const void *dtb, uint32_t phandle)
+{
+#if FDT_INDEX
+	unsigned int b;
+	int16_t idx;
+
+	if ((dtb == fdt_index.dtb) && fdt_index.nodes_complete &&
+	    (phandle != 0U) && (phandle != UINT32_MAX)) {
+		for (b = phandle & (FDT_INDEX_NODE_BUCKETS - 1U);
+		     (idx = fdt_index.phandle_bucket[b]) >= 0;
+		     b = (b + 1U) & (FDT_INDEX_NODE_BUCKETS - 1U)) {
+			int offset = fdt_index.node[idx].offset;
+
+			if ((fdt_index.node[idx].phandle == phandle) &&
+			    (fdt_get_phandle(dtb, offset) == phandle)) {
+				return offset;
+			}
+		}
+
+		return -FDT_ERR_NOTFOUND;
+	}
+#endif
+
+	return fdt_node_offset_by_phandle(dtb, phandle);
+}
 
 /*
  * Read cells from a given property of the given node. At most 2 cells of the
@@ -158,6 +503,12 @@ int fdtw_write_inplace_cells(void *dtb, int node, const char *prop,
 
 	len = (int)cells * 4;
 
+#if FDT_INDEX
+	if (dtb == fdt_index.dtb) {
+		fdtw_index_invalidate();
+	}
+#endif
+
 	/* Set property value in place */
 	err = fdt_setprop_inplace(dtb, node, prop, value, len);
 	if (err != 0) {
@@ -25,6 +25,12 @@ uint8_t rt_svc_descs_indices[MAX_RT_SVCS];
 #define RT_SVC_DECS_NUM		((RT_SVC_DESCS_END - RT_SVC_DESCS_START)\
 					/ sizeof(rt_svc_desc_t))
 
+#if SMC_LEAF_FAST_PATH
+#define RT_SVC_LEAF_DESCS_NUM	((RT_SVC_LEAF_DESCS_END - \
+					RT_SVC_LEAF_DESCS_START) \
+					/ sizeof(rt_svc_leaf_desc_t))
+#endif
+
 /*******************************************************************************
  * Function to invoke the registered `handle` corresponding to the smc_fid in
  * AArch32 mode.
@@ -80,6 +86,37 @@ static int32_t validate_rt_svc_desc(const rt_svc_desc_t *desc)
 	return 0;
 }
 
+#if SMC_LEAF_FAST_PATH
+/*******************************************************************************
+ * Sanity check the leaf runtime service descriptors. They are matched by
+ * smc_handler64 before the regular dispatch, so each of them must handle a
+ * fast SMC that belongs to a runtime service which has been successfully
+ * initialised. Otherwise the leaf handler would bypass the SMC_UNK response
+ * that the caller gets without the fast path.
+ ******************************************************************************/
+static void __init validate_rt_svc_leaf_descs(void)
+{
+	unsigned int index;
+	const rt_svc_leaf_desc_t *leaf;
+
+	assert(RT_SVC_LEAF_DESCS_END >= RT_SVC_LEAF_DESCS_START);
+
+	leaf = (const rt_svc_leaf_desc_t *) RT_SVC_LEAF_DESCS_START;
+	for (index = 0U; index < RT_SVC_LEAF_DESCS_NUM; index++) {
+		uint32_t fid = leaf[index].smc_fid;
+
+		if ((leaf[index].handle == NULL) ||
+		    (GET_SMC_TYPE(fid) != SMC_TYPE_FAST) ||
+		    (rt_svc_descs_indices[get_unique_oen_from_smc_fid(fid)] >=
+				RT_SVC_DECS_NUM)) {
+			ERROR("Invalid leaf runtime service %s (0x%x)\n",
+				leaf[index].name, fid);
+			panic();
+		}
+	}
+}
+#endif /* SMC_LEAF_FAST_PATH */
+
 /*******************************************************************************
  * This function calls the initialisation routine in the descriptor exported by
  * a runtime service. Once a descriptor has been validated, its start & end
@@ -151,4 +188,8 @@ void __init runtime_svc_init(void)
 		for (; start_idx <= end_idx; start_idx++)
 			rt_svc_descs_indices[start_idx] = index;
 	}
+
+#if SMC_LEAF_FAST_PATH
+	validate_rt_svc_leaf_descs();
+#endif
 }
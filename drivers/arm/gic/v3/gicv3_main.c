@@ -11,6 +11,7 @@
 #include <common/debug.h>
 #include <common/interrupt_props.h>
 #include <drivers/arm/gicv3.h>
+#include <lib/cassert.h>
 #include <lib/spinlock.h>
 
 #include "gicv3_private.h"
@@ -33,25 +34,77 @@ static spinlock_t gic_lock;
 #pragma weak gicv3_rdistif_on
 
 
+/*
+ * The Distributor context is saved and restored in blocks of 32 SPIs, the
+ * granularity of GICD_IGROUPR. Only the blocks set in the 'gicd_spi_blocks'
+ * bitmap of the context are accessed.
+ */
+#define GICD_SPI_BLOCK(int_id)	(((int_id) - MIN_SPI_ID) >> IGROUPR_SHIFT)
+#define GICD_NUM_SPI_BLOCKS	GICD_NUM_REGS(IGROUPR)
+
+CASSERT(GICD_NUM_SPI_BLOCKS <= 32U, assert_gicd_spi_blocks_fit_bitmap);
+
 /* Helper macros to save and restore GICD registers to and from the context */
 #define RESTORE_GICD_REGS(base, ctx, intr_num, reg, REG)		\
 	do {								\
 		for (unsigned int int_id = MIN_SPI_ID; int_id < (intr_num); \
 				int_id += (1U << REG##_SHIFT)) {	\
+			if ((ctx->gicd_spi_blocks &			\
+			     BIT_32(GICD_SPI_BLOCK(int_id))) == 0U)	\
+				continue;				\
 			gicd_write_##reg(base, int_id,			\
 				ctx->gicd_##reg[(int_id - MIN_SPI_ID) >> REG##_SHIFT]); \
 		}							\
 	} while (false)
 
+/*
+ * Variant of RESTORE_GICD_REGS for the write-1-to-set registers, where writing
+ * zero has no effect and can be skipped.
+ */
+#define RESTORE_GICD_SET_REGS(base, ctx, intr_num, reg, REG)		\
+	do {								\
+		for (unsigned int int_id = MIN_SPI_ID; int_id < (intr_num); \
+				int_id += (1U << REG##_SHIFT)) {	\
+			unsigned int val = ctx->gicd_##reg[		\
+				(int_id - MIN_SPI_ID) >> REG##_SHIFT];	\
+			if (((ctx->gicd_spi_blocks &			\
+			      BIT_32(GICD_SPI_BLOCK(int_id))) == 0U) ||	\
+			    (val == 0U))				\
+				continue;				\
+			gicd_write_##reg(base, int_id, val);		\
+		}							\
+	} while (false)
+
 #define SAVE_GICD_REGS(base, ctx, intr_num, reg, REG)			\
 	do {								\
 		for (unsigned int int_id = MIN_SPI_ID; int_id < (intr_num); \
 				int_id += (1U << REG##_SHIFT)) {	\
+			if ((ctx->gicd_spi_blocks &			\
+			     BIT_32(GICD_SPI_BLOCK(int_id))) == 0U)	\
+				continue;				\
 			ctx->gicd_##reg[(int_id - MIN_SPI_ID) >> REG##_SHIFT] =\
 					gicd_read_##reg(base, int_id);	\
 		}							\
 	} while (false)
 
+/*
+ * Bitmap of the blocks of 32 SPIs that EL3 has configured, either from the
+ * platform interrupt properties or through the runtime configuration APIs. These
+ * blocks are always part of the Distributor context. Updates are serialised by
+ * 'gic_lock'.
+ */
+static unsigned int gicd_el3_spi_blocks;
+
+static void gicv3_mark_el3_spi(unsigned int id)
+{
+	if (id < MIN_SPI_ID)
+		return;
+
+	spin_lock(&gic_lock);
+	gicd_el3_spi_blocks |= BIT_32(GICD_SPI_BLOCK(id));
+	spin_unlock(&gic_lock);
+}
+
 
 /*******************************************************************************
  * This function initialises the ARM GICv3 driver in EL3 with provided platform
@@ -134,6 +187,7 @@ void __init gicv3_driver_init(const gicv3_driver_data_t *plat_driver_data)
 void __init gicv3_distif_init(void)
 {
 	unsigned int bitmap = 0;
+	unsigned int i;
 
 	assert(gicv3_driver_data != NULL);
 	assert(gicv3_driver_data->gicd_base != 0U);
@@ -163,6 +217,10 @@ void __init gicv3_distif_init(void)
 			gicv3_driver_data->interrupt_props,
 			gicv3_driver_data->interrupt_props_num);
 
+	/* Record the SPI blocks holding secure interrupts */
+	for (i = 0U; i < gicv3_driver_data->interrupt_props_num; i++)
+		gicv3_mark_el3_spi(gicv3_driver_data->interrupt_props[i].intr_num);
+
 	/* Enable the secure SPIs now that they have been configured */
 	gicd_set_ctlr(gicv3_driver_data->gicd_base, bitmap, RWP_TRUE);
 }
@@ -524,23 +582,17 @@ void gicv3_rdistif_save(unsigned int proc_num, gicv3_redist_ctx_t * const rdist_
 }
 
 /*****************************************************************************
- * Function to restore the GIC Redistributor register context. We disable
- * LPI and per-cpu interrupts before we start restore of the Redistributor.
- * This function must be invoked after Distributor restore but prior to
- * CPU interface enable. The pending and active interrupts are restored
- * after the interrupts are fully configured and enabled.
+ * The Redistributor restore sequence is split in phases separated by waits for
+ * the Redistributor to complete register writes. This allows the restore of
+ * several Redistributors to be interleaved so that their waits overlap.
+ *
+ * First phase: power on the Redistributor and disable all SGIs/PPIs.
  *****************************************************************************/
-void gicv3_rdistif_init_restore(unsigned int proc_num,
-				const gicv3_redist_ctx_t * const rdist_ctx)
+static void gicv3_rdistif_restore_start(unsigned int proc_num)
 {
 	uintptr_t gicr_base;
-	unsigned int int_id;
 
-	assert(gicv3_driver_data != NULL);
 	assert(proc_num < gicv3_driver_data->rdistif_num);
-	assert(gicv3_driver_data->rdistif_base_addrs != NULL);
-	assert(IS_IN_EL3());
-	assert(rdist_ctx != NULL);
 
 	gicr_base = gicv3_driver_data->rdistif_base_addrs[proc_num];
 
@@ -560,8 +612,19 @@ void gicv3_rdistif_init_restore(unsigned int proc_num,
 	 * GICD_CTLR
 	 */
 	gicr_write_icenabler0(gicr_base, ~0U);
-	/* Wait for pending writes to GICR_ICENABLER */
-	gicr_wait_for_pending_write(gicr_base);
+}
+
+/*****************************************************************************
+ * Second phase, once the write to GICR_ICENABLER0 has completed: restore the
+ * configuration, pending and active state of the SGIs/PPIs.
+ *****************************************************************************/
+static void gicv3_rdistif_restore_config(unsigned int proc_num,
+				const gicv3_redist_ctx_t * const rdist_ctx)
+{
+	uintptr_t gicr_base;
+	unsigned int int_id;
+
+	gicr_base = gicv3_driver_data->rdistif_base_addrs[proc_num];
 
 	/*
 	 * Disable the LPIs to avoid unpredictable behavior when writing to
@@ -588,27 +651,172 @@ void gicv3_rdistif_init_restore(unsigned int proc_num,
 	gicr_write_igrpmodr0(gicr_base, rdist_ctx->gicr_igrpmodr0);
 	gicr_write_nsacr(gicr_base, rdist_ctx->gicr_nsacr);
 
-	/* Restore after group and priorities are set */
-	gicr_write_ispendr0(gicr_base, rdist_ctx->gicr_ispendr0);
-	gicr_write_isactiver0(gicr_base, rdist_ctx->gicr_isactiver0);
-
 	/*
-	 * Wait for all writes to the Distributor to complete before enabling
-	 * the SGI and PPIs.
+	 * Restore after group and priorities are set. Writing zero to these
+	 * set-registers has no effect, so it is skipped.
 	 */
-	gicr_wait_for_upstream_pending_write(gicr_base);
+	if (rdist_ctx->gicr_ispendr0 != 0U)
+		gicr_write_ispendr0(gicr_base, rdist_ctx->gicr_ispendr0);
+	if (rdist_ctx->gicr_isactiver0 != 0U)
+		gicr_write_isactiver0(gicr_base, rdist_ctx->gicr_isactiver0);
+}
+
+/*****************************************************************************
+ * Last phase, once all writes to the Distributor have completed: enable the
+ * SGIs/PPIs and restore GICR_CTLR.
+ *****************************************************************************/
+static void gicv3_rdistif_restore_enable(unsigned int proc_num,
+				const gicv3_redist_ctx_t * const rdist_ctx)
+{
+	uintptr_t gicr_base;
+
+	gicr_base = gicv3_driver_data->rdistif_base_addrs[proc_num];
+
 	gicr_write_isenabler0(gicr_base, rdist_ctx->gicr_isenabler0);
 
 	/*
-	 * Restore GICR_CTLR.Enable_LPIs bit and wait for pending writes in case
-	 * the first write to GICR_CTLR was still in flight (this write only
+	 * Restore GICR_CTLR.Enable_LPIs bit. The first write to GICR_CTLR may
+	 * still be in flight, which the caller waits for (this write only
 	 * restores GICR_CTLR.Enable_LPIs and no waiting is required for this
 	 * bit).
 	 */
 	gicr_write_ctlr(gicr_base, rdist_ctx->gicr_ctlr);
+}
+
+/*****************************************************************************
+ * Function to restore the GIC Redistributor register context. We disable
+ * LPI and per-cpu interrupts before we start restore of the Redistributor.
+ * This function must be invoked after Distributor restore but prior to
+ * CPU interface enable. The pending and active interrupts are restored
+ * after the interrupts are fully configured and enabled.
+ *****************************************************************************/
+void gicv3_rdistif_init_restore(unsigned int proc_num,
+				const gicv3_redist_ctx_t * const rdist_ctx)
+{
+	uintptr_t gicr_base;
+
+	assert(gicv3_driver_data != NULL);
+	assert(proc_num < gicv3_driver_data->rdistif_num);
+	assert(gicv3_driver_data->rdistif_base_addrs != NULL);
+	assert(IS_IN_EL3());
+	assert(rdist_ctx != NULL);
+
+	gicr_base = gicv3_driver_data->rdistif_base_addrs[proc_num];
+
+	gicv3_rdistif_restore_start(proc_num);
+
+	/* Wait for pending writes to GICR_ICENABLER */
+	gicr_wait_for_pending_write(gicr_base);
+
+	gicv3_rdistif_restore_config(proc_num, rdist_ctx);
+
+	/*
+	 * Wait for all writes to the Distributor to complete before enabling
+	 * the SGI and PPIs.
+	 */
+	gicr_wait_for_upstream_pending_write(gicr_base);
+
+	gicv3_rdistif_restore_enable(proc_num, rdist_ctx);
 	gicr_wait_for_pending_write(gicr_base);
 }
 
+/*****************************************************************************
+ * Function to restore the context of the Redistributors 0 to 'rdist_num' - 1
+ * from the 'rdist_ctx' array, indexed by core position. It is equivalent to
+ * calling gicv3_rdistif_init_restore() for each of them, but runs each phase
+ * of the sequence on all Redistributors before waiting for any of them. The
+ * waits for register writes to complete then overlap instead of adding up,
+ * which shortens system resume on platforms that save the context of all
+ * Redistributors.
+ *****************************************************************************/
+void gicv3_rdistif_init_restore_all(const gicv3_redist_ctx_t * const rdist_ctx,
+				    unsigned int rdist_num)
+{
+	const uintptr_t *gicr_bases;
+	unsigned int i;
+
+	assert(gicv3_driver_data != NULL);
+	assert(rdist_num <= gicv3_driver_data->rdistif_num);
+	assert(gicv3_driver_data->rdistif_base_addrs != NULL);
+	assert(IS_IN_EL3());
+	assert(rdist_ctx != NULL);
+
+	gicr_bases = gicv3_driver_data->rdistif_base_addrs;
+
+	for (i = 0U; i < rdist_num; i++)
+		gicv3_rdistif_restore_start(i);
+
+	/* Wait for pending writes to GICR_ICENABLER */
+	for (i = 0U; i < rdist_num; i++)
+		gicr_wait_for_pending_write(gicr_bases[i]);
+
+	for (i = 0U; i < rdist_num; i++)
+		gicv3_rdistif_restore_config(i, &rdist_ctx[i]);
+
+	/*
+	 * Wait for all writes to the Distributor to complete before enabling
+	 * the SGI and PPIs.
+	 */
+	for (i = 0U; i < rdist_num; i++)
+		gicr_wait_for_upstream_pending_write(gicr_bases[i]);
+
+	for (i = 0U; i < rdist_num; i++)
+		gicv3_rdistif_restore_enable(i, &rdist_ctx[i]);
+
+	for (i = 0U; i < rdist_num; i++)
+		gicr_wait_for_pending_write(gicr_bases[i]);
+}
+
+/*****************************************************************************
+ * Compute the bitmap of the blocks of 32 SPIs whose Distributor context must be
+ * saved. Without platform-declared SPI ranges, every implemented block is
+ * saved. Otherwise the context is limited to the blocks that:
+ *  - overlap a range in 'spi_ctx_ranges', or
+ *  - hold an interrupt configured by EL3, or
+ *  - hold an interrupt that is currently enabled, pending or active.
+ *****************************************************************************/
+static unsigned int gicv3_distif_ctx_blocks(uintptr_t gicd_base,
+					    unsigned int num_ints)
+{
+	const gicv3_spi_range_t *range;
+	unsigned int blocks, all_blocks, id, i;
+
+	all_blocks = (unsigned int)(((uint64_t)1U <<
+			GICD_SPI_BLOCK(num_ints)) - 1U);
+
+	if (gicv3_driver_data->spi_ctx_ranges == NULL)
+		return all_blocks;
+
+	blocks = gicd_el3_spi_blocks;
+
+	for (i = 0U; i < gicv3_driver_data->spi_ctx_ranges_num; i++) {
+		range = &gicv3_driver_data->spi_ctx_ranges[i];
+		assert(range->base >= MIN_SPI_ID);
+		assert((range->base + range->num) <= (MAX_SPI_ID + 1U));
+
+		for (id = range->base; id < (range->base + range->num);
+				id += (1U << IGROUPR_SHIFT))
+			blocks |= BIT_32(GICD_SPI_BLOCK(id));
+		if (range->num != 0U) {
+			id = range->base + range->num - 1U;
+			blocks |= BIT_32(GICD_SPI_BLOCK(id));
+		}
+	}
+
+	/* Catch interrupts in use that are outside of the declared ranges */
+	for (id = MIN_SPI_ID; id < num_ints; id += (1U << IGROUPR_SHIFT)) {
+		if ((blocks & BIT_32(GICD_SPI_BLOCK(id))) != 0U)
+			continue;
+
+		if ((gicd_read_isenabler(gicd_base, id) |
+		     gicd_read_ispendr(gicd_base, id) |
+		     gicd_read_isactiver(gicd_base, id)) != 0U)
+			blocks |= BIT_32(GICD_SPI_BLOCK(id));
+	}
+
+	return blocks & all_blocks;
+}
+
 /*****************************************************************************
  * Function to save the GIC Distributor register context. This function
  * must be invoked after CPU interface disable and Redistributor save.
@@ -636,6 +844,9 @@ void gicv3_distif_save(gicv3_dist_ctx_t * const dist_ctx)
 	/* Save the GICD_CTLR */
 	dist_ctx->gicd_ctlr = gicd_read_ctlr(gicd_base);
 
+	/* Select the blocks of SPIs whose configuration must be preserved */
+	dist_ctx->gicd_spi_blocks = gicv3_distif_ctx_blocks(gicd_base, num_ints);
+
 	/* Save GICD_IGROUPR for INTIDs 32 - 1020 */
 	SAVE_GICD_REGS(gicd_base, dist_ctx, num_ints, igroupr, IGROUPR);
 
@@ -708,6 +919,12 @@ void gicv3_distif_init_restore(const gicv3_dist_ctx_t * const dist_ctx)
 
 	assert(num_ints <= (MAX_SPI_ID + 1U));
 
+	/*
+	 * SPIs outside the saved blocks are neither in use nor part of a range
+	 * declared by the platform. They are left untouched, so they keep
+	 * whatever configuration the Distributor retained.
+	 */
+
 	/* Restore GICD_IGROUPR for INTIDs 32 - 1020 */
 	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, igroupr, IGROUPR);
 
@@ -732,13 +949,13 @@ void gicv3_distif_init_restore(const gicv3_dist_ctx_t * const dist_ctx)
 	 */
 
 	/* Restore GICD_ISENABLER for INT_IDs 32 - 1020 */
-	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, isenabler, ISENABLER);
+	RESTORE_GICD_SET_REGS(gicd_base, dist_ctx, num_ints, isenabler, ISENABLER);
 
 	/* Restore GICD_ISPENDR for INTIDs 32 - 1020 */
-	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, ispendr, ISPENDR);
+	RESTORE_GICD_SET_REGS(gicd_base, dist_ctx, num_ints, ispendr, ISPENDR);
 
 	/* Restore GICD_ISACTIVER for INTIDs 32 - 1020 */
-	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, isactiver, ISACTIVER);
+	RESTORE_GICD_SET_REGS(gicd_base, dist_ctx, num_ints, isactiver, ISACTIVER);
 
 	/* Restore the GICD_CTLR */
 	gicd_write_ctlr(gicd_base, dist_ctx->gicd_ctlr);
@@ -866,6 +1083,7 @@ void gicv3_set_interrupt_priority(unsigned int id, unsigned int proc_num,
 		gicr_set_ipriorityr(gicr_base, id, priority);
 	} else {
 		gicd_set_ipriorityr(gicv3_driver_data->gicd_base, id, priority);
+		gicv3_mark_el3_spi(id);
 	}
 }
 
@@ -927,6 +1145,8 @@ void gicv3_set_interrupt_type(unsigned int id, unsigned int proc_num,
 		else
 			gicd_clr_igrpmodr(gicv3_driver_data->gicd_base, id);
 		spin_unlock(&gic_lock);
+
+		gicv3_mark_el3_spi(id);
 	}
 }
 
@@ -993,6 +1213,7 @@ void gicv3_set_spi_routing(unsigned int id, unsigned int irm, u_register_t mpidr
 
 	aff = gicd_irouter_val_from_mpidr(mpidr, irm);
 	gicd_write_irouter(gicv3_driver_data->gicd_base, id, aff);
+	gicv3_mark_el3_spi(id);
 
 	/*
 	 * In implementations that do not require 1 of N distribution of SPIs,
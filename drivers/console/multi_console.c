@@ -10,9 +10,38 @@
 
 #include <drivers/console.h>
 
+#if CONSOLE_LINE_BUFFER
+#include <stdbool.h>
+
+#include <platform_def.h>
+
+#include <arch_helpers.h>
+#include <lib/spinlock.h>
+#include <plat/common/platform.h>
+#endif
+
 console_t *console_list;
 uint8_t console_state = CONSOLE_FLAG_BOOT;
 
+#if CONSOLE_LINE_BUFFER
+/*
+ * Each CPU assembles the characters it prints into a line in a buffer of its
+ * own, and writes the line out to the consoles at once when it is complete or
+ * the buffer is full. Lines are written out under a lock so that the lines of
+ * several CPUs printing at the same time don't interleave. The lock is not held
+ * while a line is being assembled.
+ */
+#define CONSOLE_LINE_SIZE	U(128)
+
+static struct console_line {
+	unsigned int len;
+	bool locked;	/* This CPU holds the lock while writing the line out */
+	char buf[CONSOLE_LINE_SIZE];
+} __aligned(CACHE_WRITEBACK_GRANULE) console_line[PLATFORM_CORE_COUNT];
+
+static spinlock_t console_lock;
+#endif
+
 int console_register(console_t *console)
 {
 	IMPORT_SYM(console_t *, __STACKS_START__, stacks_start)
@@ -58,8 +87,95 @@ int console_is_registered(console_t *to_find)
 	return 0;
 }
 
+#if CONSOLE_LINE_BUFFER
+/* Returns true if the data cache of this CPU is enabled. */
+static bool console_line_cached(void)
+{
+	u_register_t sctlr;
+
+#ifdef __aarch64__
+	sctlr = IS_IN_EL3() ? read_sctlr_el3() : read_sctlr_el1();
+#else
+	sctlr = read_sctlr();
+#endif
+	return (sctlr & SCTLR_C_BIT) != 0U;
+}
+
+/*
+ * The line buffer and the lock are only used with the data cache enabled, as
+ * CPUs running with it disabled wouldn't see a coherent view of them. In the
+ * crash state, the lock may be held by the CPU that crashed.
+ */
+static bool console_line_usable(void)
+{
+	return (console_state != CONSOLE_FLAG_CRASH) && console_line_cached();
+}
+
+/* Write a line out on all consoles registered for the current state. */
+static void console_write_all(const char *buf, unsigned int len)
+{
+	console_t *console;
+	unsigned int i;
+
+	for (console = console_list; console != NULL; console = console->next)
+		if ((console->flags & console_state) && console->putc)
+			for (i = 0U; i < len; i++)
+				(void)console->putc(buf[i], console);
+}
+
+/*
+ * Write out the line buffered by this CPU, if any. The lock isn't taken again
+ * if this CPU already holds it, e.g. when it panics in a console driver while
+ * writing a line out.
+ */
+static void console_line_flush(struct console_line *line)
+{
+	bool locked = line->locked;
+
+	if (line->len == 0U)
+		return;
+
+	if (!locked) {
+		spin_lock(&console_lock);
+		line->locked = true;
+	}
+
+	console_write_all(line->buf, line->len);
+	line->len = 0U;
+
+	if (!locked) {
+		line->locked = false;
+		spin_unlock(&console_lock);
+	}
+}
+
+static void console_line_flush_mine(void)
+{
+	if (console_line_usable())
+		console_line_flush(&console_line[plat_my_core_pos()]);
+}
+#endif
+
 void console_switch_state(unsigned int new_state)
 {
+#if CONSOLE_LINE_BUFFER
+	struct console_line *line;
+
+	if ((new_state == CONSOLE_FLAG_CRASH) && console_line_cached()) {
+		/*
+		 * Write out the pending line on the crash consoles, without the
+		 * lock, which the crashing CPU may hold.
+		 */
+		console_state = new_state;
+		line = &console_line[plat_my_core_pos()];
+		console_write_all(line->buf, line->len);
+		line->len = 0U;
+		return;
+	}
+
+	/* Write out the pending line on the consoles of the current state. */
+	console_line_flush_mine();
+#endif
 	console_state = new_state;
 }
 
@@ -70,7 +186,7 @@ void console_set_scope(console_t *console, unsigned int scope)
 	console->flags = (console->flags & ~CONSOLE_FLAG_SCOPE_MASK) | scope;
 }
 
-int console_putc(int c)
+static int console_putc_all(int c)
 {
 	int err = ERROR_NO_VALID_CONSOLE;
 	console_t *console;
@@ -85,6 +201,38 @@ int console_putc(int c)
 	return err;
 }
 
+#if CONSOLE_LINE_BUFFER
+int console_putc(int c)
+{
+	struct console_line *line;
+	console_t *console;
+
+	if (!console_line_usable())
+		return console_putc_all(c);
+
+	for (console = console_list; console != NULL; console = console->next)
+		if ((console->flags & console_state) && console->putc)
+			break;
+
+	if (console == NULL)
+		return ERROR_NO_VALID_CONSOLE;
+
+	line = &console_line[plat_my_core_pos()];
+	line->buf[line->len] = (char)c;
+	line->len++;
+
+	if ((c == '\n') || (line->len == CONSOLE_LINE_SIZE))
+		console_line_flush(line);
+
+	return c;
+}
+#else
+int console_putc(int c)
+{
+	return console_putc_all(c);
+}
+#endif
+
 int console_getc(void)
 {
 	int err = ERROR_NO_VALID_CONSOLE;
@@ -110,6 +258,10 @@ int console_flush(void)
 	int err = ERROR_NO_VALID_CONSOLE;
 	console_t *console;
 
+#if CONSOLE_LINE_BUFFER
+	console_line_flush_mine();
+#endif
+
 	for (console = console_list; console != NULL; console = console->next)
 		if ((console->flags & console_state) && console->flush) {
 			int ret = console->flush(console);
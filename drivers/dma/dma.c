@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+
+#include <arch_helpers.h>
+#include <drivers/dma.h>
+#include <lib/spinlock.h>
+
+/***********************************************************
+ * The software engine, which copies on the CPU as soon as a
+ * transfer is started.
+ ***********************************************************/
+static int dma_sw_copy_start(uintptr_t dst, uintptr_t src, size_t len)
+{
+	(void)memcpy((void *)dst, (const void *)src, len);
+
+	return 0;
+}
+
+static int dma_sw_fill_start(uintptr_t dst, int val, size_t len)
+{
+	(void)memset((void *)dst, val, len);
+
+	return 0;
+}
+
+static int dma_sw_wait(void)
+{
+	return 0;
+}
+
+const dma_ops_t dma_sw_ops = {
+	.copy_start = dma_sw_copy_start,
+	.fill_start = dma_sw_fill_start,
+	.wait = dma_sw_wait,
+	.min_size = 0U,
+	.coherent = true,
+};
+
+/***********************************************************
+ * The registered engine, if any, and whether it is running
+ * a transfer. dma_busy is claimed and released under
+ * dma_lock, so that the CPUs share the engine.
+ ***********************************************************/
+static const dma_ops_t *dma_ops;
+static bool dma_busy;
+static spinlock_t dma_lock;
+
+/***********************************************************
+ * Start a transfer on the registered engine if it can take
+ * it. Return 0 if the transfer has started, or an error if
+ * the CPU must do it.
+ ***********************************************************/
+static int dma_offload(uintptr_t dst, uintptr_t src, int val, size_t len,
+		       bool fill)
+{
+	int ret;
+
+	if ((dma_ops == NULL) || (len < dma_ops->min_size)) {
+		return -ENOTSUP;
+	}
+
+	if (fill && (dma_ops->fill_start == NULL)) {
+		return -ENOTSUP;
+	}
+
+	spin_lock(&dma_lock);
+	if (dma_busy) {
+		spin_unlock(&dma_lock);
+		return -ENOTSUP;
+	}
+	dma_busy = true;
+	spin_unlock(&dma_lock);
+
+	/*
+	 * Write back the source, and make sure that no dirty line of the
+	 * destination is evicted over the data written by the engine.
+	 */
+	if (!dma_ops->coherent) {
+		if (!fill) {
+			clean_dcache_range(src, len);
+		}
+		flush_dcache_range(dst, len);
+	}
+
+	if (fill) {
+		ret = dma_ops->fill_start(dst, val, len);
+	} else {
+		ret = dma_ops->copy_start(dst, src, len);
+	}
+
+	/* Release the engine if it didn't take the transfer */
+	if (ret != 0) {
+		spin_lock(&dma_lock);
+		dma_busy = false;
+		spin_unlock(&dma_lock);
+	}
+
+	return ret;
+}
+
+/***********************************************************
+ * Start copying 'len' bytes from 'src' to 'dst'. If the
+ * engine doesn't take the transfer, the copy is done before
+ * returning. Returns 0 on success.
+ ***********************************************************/
+int dma_memcpy_start(dma_req_t *req, void *dst, const void *src, size_t len)
+{
+	assert(req != NULL);
+
+	req->dst = (uintptr_t)dst;
+	req->len = len;
+	req->result = 0;
+	req->offloaded = (dma_offload((uintptr_t)dst, (uintptr_t)src, 0, len,
+				      false) == 0);
+
+	if (!req->offloaded) {
+		req->result = dma_sw_copy_start((uintptr_t)dst, (uintptr_t)src,
+						len);
+	}
+
+	return 0;
+}
+
+/***********************************************************
+ * Start filling 'len' bytes at 'dst' with 'val'. If the
+ * engine doesn't take the transfer, the fill is done before
+ * returning. Returns 0 on success.
+ ***********************************************************/
+int dma_memset_start(dma_req_t *req, void *dst, int val, size_t len)
+{
+	assert(req != NULL);
+
+	req->dst = (uintptr_t)dst;
+	req->len = len;
+	req->result = 0;
+	req->offloaded = (dma_offload((uintptr_t)dst, 0U, val, len,
+				      true) == 0);
+
+	if (!req->offloaded) {
+		req->result = dma_sw_fill_start((uintptr_t)dst, val, len);
+	}
+
+	return 0;
+}
+
+/***********************************************************
+ * Wait for a transfer started by dma_memcpy_start() or
+ * dma_memset_start(). Returns 0 if it succeeded.
+ ***********************************************************/
+int dma_wait(dma_req_t *req)
+{
+	assert(req != NULL);
+
+	if (req->offloaded) {
+		assert(dma_busy);
+
+		req->result = dma_ops->wait();
+		req->offloaded = false;
+
+		/* Drop the lines speculatively fetched during the transfer */
+		if (!dma_ops->coherent) {
+			inv_dcache_range(req->dst, req->len);
+		}
+
+		spin_lock(&dma_lock);
+		dma_busy = false;
+		spin_unlock(&dma_lock);
+	}
+
+	return req->result;
+}
+
+int dma_memcpy(void *dst, const void *src, size_t len)
+{
+	dma_req_t req;
+
+	(void)dma_memcpy_start(&req, dst, src, len);
+
+	return dma_wait(&req);
+}
+
+int dma_memset(void *dst, int val, size_t len)
+{
+	dma_req_t req;
+
+	(void)dma_memset_start(&req, dst, val, len);
+
+	return dma_wait(&req);
+}
+
+/***********************************************************
+ * Register the DMA engine. dma_sw_ops may be registered to
+ * go through the same steps as with a DMA engine, but with
+ * the transfers done by the CPU.
+ ***********************************************************/
+void dma_init(const dma_ops_t *ops_ptr)
+{
+	assert((ops_ptr != NULL) &&
+		(ops_ptr->copy_start != NULL) &&
+		(ops_ptr->wait != NULL));
+	assert(!dma_busy);
+
+	dma_ops = ops_ptr;
+}
@@ -1,11 +1,12 @@
 /*
- * Copyright (c) 2016-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
 #include <assert.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <string.h>
 
 #include <platform_def.h>
@@ -15,12 +16,73 @@
 #include <drivers/io/io_driver.h>
 #include <drivers/io/io_storage.h>
 #include <lib/utils.h>
+#include <lib/utils_def.h>
+
+/* Size of a line of the block cache, a multiple of the block size */
+#ifndef IO_BLOCK_CACHE_LINE_SIZE
+#define IO_BLOCK_CACHE_LINE_SIZE	4096U
+#endif
+
+/* Number of lines of each set of the block cache */
+#ifndef IO_BLOCK_CACHE_WAYS
+#define IO_BLOCK_CACHE_WAYS		2U
+#endif
+
+/* Number of lines filled on a miss that continues a sequential access */
+#ifndef IO_BLOCK_CACHE_READ_AHEAD
+#define IO_BLOCK_CACHE_READ_AHEAD	4U
+#endif
+
+/* Reads larger than this bypass the block cache */
+#define BLOCK_CACHE_MAX_READ		(IO_BLOCK_CACHE_LINE_SIZE *	\
+					 IO_BLOCK_CACHE_READ_AHEAD)
+
+typedef struct {
+	int		line;	/* -1 if the line is invalid */
+	unsigned int	stamp;	/* Last use, for LRU replacement */
+} block_cache_tag_t;
+
+/*
+ * Set-associative cache of device lines. The data of way `w` of set `s` is at
+ * `data + ((w * sets) + s) * IO_BLOCK_CACHE_LINE_SIZE`, so that consecutive
+ * lines of the same way are contiguous and can be filled by a single read.
+ */
+typedef struct {
+	uintptr_t		data;
+	block_cache_tag_t	*tags;
+	unsigned int		sets;
+	unsigned int		clock;
+	int			next_line;
+	io_block_cache_stats_t	stats;
+} block_cache_t;
+
+/*
+ * State of a split-phase read. The device buffer is split in two halves that
+ * are filled alternately with chunks of the range [0, total) of device bytes,
+ * which starts `skip` bytes before the file position.
+ */
+typedef struct {
+	uintptr_t		buffer;
+	size_t			length;
+	size_t			skip;
+	size_t			total;
+	size_t			pos;
+	size_t			request;
+	unsigned int		cur_half;
+	int			lba;
+	/* Result of a read that was done synchronously by block_read_start() */
+	bool			done;
+	int			result;
+	size_t			length_read;
+} block_split_read_t;
 
 typedef struct {
 	io_block_dev_spec_t	*dev_spec;
 	uintptr_t		base;
 	size_t			file_pos;
 	size_t			size;
+	block_cache_t		cache;
+	block_split_read_t	split;
 } block_dev_state_t;
 
 #define is_power_of_2(x)	((x != 0) && ((x & (x - 1)) == 0))
@@ -32,6 +94,9 @@ static int block_open(io_dev_info_t *dev_info, const uintptr_t spec,
 static int block_seek(io_entity_t *entity, int mode, ssize_t offset);
 static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		      size_t *length_read);
+static int block_read_start(io_entity_t *entity, uintptr_t buffer,
+			    size_t length);
+static int block_read_wait(io_entity_t *entity, size_t *length_read);
 static int block_write(io_entity_t *entity, const uintptr_t buffer,
 		       size_t length, size_t *length_written);
 static int block_close(io_entity_t *entity);
@@ -48,6 +113,8 @@ static const io_dev_funcs_t block_dev_funcs = {
 	.seek		= block_seek,
 	.size		= NULL,
 	.read		= block_read,
+	.read_start	= block_read_start,
+	.read_wait	= block_read_wait,
 	.write		= block_write,
 	.close		= block_close,
 	.dev_init	= NULL,
@@ -171,6 +238,283 @@ static int block_seek(io_entity_t *entity, int mode, ssize_t offset)
 	return 0;
 }
 
+static void block_cache_init(block_dev_state_t *cur)
+{
+	block_cache_t *cache = &cur->cache;
+	io_block_spec_t *region = &(cur->dev_spec->cache);
+	unsigned int lines, i;
+
+	cache->sets = 0U;
+	if (region->length == 0U) {
+		return;
+	}
+
+	assert(((IO_BLOCK_CACHE_LINE_SIZE % cur->dev_spec->block_size) == 0U) &&
+	       ((region->offset % cur->dev_spec->block_size) == 0U));
+
+	lines = region->length /
+		(IO_BLOCK_CACHE_LINE_SIZE + sizeof(block_cache_tag_t));
+	cache->sets = lines / IO_BLOCK_CACHE_WAYS;
+	assert(cache->sets > 0U);
+
+	lines = cache->sets * IO_BLOCK_CACHE_WAYS;
+	cache->data = region->offset;
+	cache->tags = (block_cache_tag_t *)(region->offset +
+					    (lines * IO_BLOCK_CACHE_LINE_SIZE));
+	for (i = 0U; i < lines; i++) {
+		cache->tags[i].line = -1;
+		cache->tags[i].stamp = 0U;
+	}
+	cache->clock = 0U;
+	cache->next_line = -1;
+	zeromem(&cache->stats, sizeof(cache->stats));
+}
+
+/* Return the index of the cache slot holding `line`, or -1 */
+static int block_cache_find(block_cache_t *cache, int line)
+{
+	unsigned int set = (unsigned int)line % cache->sets;
+	unsigned int way, slot;
+
+	for (way = 0U; way < IO_BLOCK_CACHE_WAYS; way++) {
+		slot = (way * cache->sets) + set;
+		if (cache->tags[slot].line == line) {
+			return (int)slot;
+		}
+	}
+	return -1;
+}
+
+/*
+ * Read `line` from the device into the least recently used way of its set.
+ * If the miss continues a sequential access, the following lines are read
+ * ahead into the same way of the next sets with the same device read.
+ */
+static int block_cache_fill(block_dev_state_t *cur, int line)
+{
+	block_cache_t *cache = &cur->cache;
+	io_block_ops_t *ops = &(cur->dev_spec->ops);
+	unsigned int set = (unsigned int)line % cache->sets;
+	unsigned int way, slot, victim = set;
+	unsigned int count = 1U, filled, i;
+	size_t request;
+
+	for (way = 1U; way < IO_BLOCK_CACHE_WAYS; way++) {
+		slot = (way * cache->sets) + set;
+		if (cache->tags[slot].stamp < cache->tags[victim].stamp) {
+			victim = slot;
+		}
+	}
+
+	if (line == cache->next_line) {
+		while ((count < IO_BLOCK_CACHE_READ_AHEAD) &&
+		       ((set + count) < cache->sets) &&
+		       (block_cache_find(cache, line + (int)count) < 0)) {
+			count++;
+		}
+	}
+
+	request = ops->read(line * (int)(IO_BLOCK_CACHE_LINE_SIZE /
+					 cur->dev_spec->block_size),
+			    cache->data + (victim * IO_BLOCK_CACHE_LINE_SIZE),
+			    count * IO_BLOCK_CACHE_LINE_SIZE);
+	filled = MIN(count,
+		     (unsigned int)(request / IO_BLOCK_CACHE_LINE_SIZE));
+	cache->stats.misses++;
+
+	/* Lines that were only partially read no longer hold valid data */
+	for (i = 0U; i < count; i++) {
+		if (i < filled) {
+			cache->tags[victim + i].line = line + (int)i;
+			cache->tags[victim + i].stamp = ++cache->clock;
+		} else {
+			cache->tags[victim + i].line = -1;
+			cache->tags[victim + i].stamp = 0U;
+		}
+	}
+	if (filled == 0U) {
+		cache->next_line = -1;
+		return -1;
+	}
+	cache->next_line = line + (int)filled;
+	cache->stats.read_ahead += filled - 1U;
+
+	return (int)victim;
+}
+
+/*
+ * Serve a read from the block cache. The file position is only updated if
+ * the whole read succeeds, so that the caller can fall back to reading the
+ * device directly.
+ */
+static int block_cache_read(block_dev_state_t *cur, uintptr_t buffer,
+			    size_t length, size_t *length_read)
+{
+	block_cache_t *cache = &cur->cache;
+	size_t pos = cur->base + cur->file_pos;
+	size_t end = pos + length;
+	size_t off, nbytes;
+	int line, slot;
+
+	while (pos < end) {
+		line = (int)(pos / IO_BLOCK_CACHE_LINE_SIZE);
+		off = pos % IO_BLOCK_CACHE_LINE_SIZE;
+
+		slot = block_cache_find(cache, line);
+		if (slot >= 0) {
+			cache->stats.hits++;
+			cache->tags[slot].stamp = ++cache->clock;
+		} else {
+			slot = block_cache_fill(cur, line);
+			if (slot < 0) {
+				return -EIO;
+			}
+		}
+
+		nbytes = MIN(IO_BLOCK_CACHE_LINE_SIZE - off, end - pos);
+		memcpy((void *)(buffer + (pos - cur->base - cur->file_pos)),
+		       (void *)(cache->data +
+				((size_t)slot * IO_BLOCK_CACHE_LINE_SIZE) + off),
+		       nbytes);
+		pos += nbytes;
+	}
+
+	cur->file_pos += length;
+	*length_read = length;
+
+	return 0;
+}
+
+/* Invalidate the cached lines that overlap a device range */
+static void block_cache_invalidate(block_cache_t *cache, size_t pos,
+				   size_t length)
+{
+	unsigned int slot;
+	size_t start;
+
+	for (slot = 0U; slot < (cache->sets * IO_BLOCK_CACHE_WAYS); slot++) {
+		if (cache->tags[slot].line < 0) {
+			continue;
+		}
+		start = (size_t)cache->tags[slot].line *
+			IO_BLOCK_CACHE_LINE_SIZE;
+		if ((start < (pos + length)) &&
+		    (pos < (start + IO_BLOCK_CACHE_LINE_SIZE))) {
+			cache->tags[slot].line = -1;
+			cache->tags[slot].stamp = 0U;
+		}
+	}
+	cache->next_line = -1;
+}
+
+/*
+ * Read path used when the low level driver can start a read and wait for it
+ * separately. A read that fits in the underlying buffer is transferred with a
+ * single request. Otherwise, the buffer is split in two halves: while the data
+ * of one half is copied to the user buffer, the next request is already being
+ * transferred to the other one.
+ */
+static bool block_can_split_read(const block_dev_state_t *cur)
+{
+	const io_block_dev_spec_t *spec = cur->dev_spec;
+
+	return (spec->ops.read_start != NULL) &&
+	       (spec->ops.read_wait != NULL) &&
+	       (spec->buffer.length >= (2U * spec->block_size));
+}
+
+/*
+ * Returns true if a read of 'length' bytes from the current position needs
+ * more than one buffer of data, so that its requests can overlap the copies.
+ */
+static bool block_split_read_overlaps(const block_dev_state_t *cur,
+				      size_t length)
+{
+	size_t skip = cur->file_pos & (cur->dev_spec->block_size - 1U);
+
+	return (skip + length) > cur->dev_spec->buffer.length;
+}
+
+static size_t block_split_half(const block_dev_state_t *cur)
+{
+	const io_block_dev_spec_t *spec = cur->dev_spec;
+
+	return (spec->buffer.length / 2U) & ~(spec->block_size - 1U);
+}
+
+/* Start the transfer of the first chunk of a split-phase read */
+static int block_split_start(block_dev_state_t *cur, uintptr_t buffer,
+			     size_t length)
+{
+	block_split_read_t *rd = &cur->split;
+	size_t block_size = cur->dev_spec->block_size;
+
+	rd->buffer = buffer;
+	rd->length = length;
+	rd->skip = cur->file_pos & (block_size - 1U);
+	rd->lba = (cur->file_pos + cur->base) / block_size;
+	rd->total = (rd->skip + length + (block_size - 1U)) &
+		    ~(block_size - 1U);
+	rd->pos = 0U;
+	rd->cur_half = 0U;
+	if (rd->total <= cur->dev_spec->buffer.length) {
+		rd->request = rd->total;
+	} else {
+		rd->request = block_split_half(cur);
+	}
+
+	if (cur->dev_spec->ops.read_start(rd->lba, cur->dev_spec->buffer.offset,
+					  rd->request) != 0) {
+		return -EIO;
+	}
+
+	return 0;
+}
+
+/* Transfer the remaining chunks and copy all of them to the user buffer */
+static int block_split_wait(block_dev_state_t *cur, size_t *length_read)
+{
+	block_split_read_t *rd = &cur->split;
+	io_block_ops_t *ops = &(cur->dev_spec->ops);
+	size_t block_size = cur->dev_spec->block_size;
+	size_t half = block_split_half(cur);
+	size_t next, from, to;
+	uintptr_t half_buf[2];
+
+	half_buf[0] = cur->dev_spec->buffer.offset;
+	half_buf[1] = cur->dev_spec->buffer.offset + half;
+
+	for (; rd->pos < rd->total; rd->pos = next) {
+		next = rd->pos + rd->request;
+		if (ops->read_wait() != rd->request) {
+			return -EIO;
+		}
+
+		if (next < rd->total) {
+			rd->request = MIN(half, rd->total - next);
+			if (ops->read_start(rd->lba + (int)(next / block_size),
+					    half_buf[rd->cur_half ^ 1U],
+					    rd->request) != 0) {
+				return -EIO;
+			}
+		}
+
+		/* Copy the bytes of [pos, next) that the caller asked for */
+		from = MAX(rd->pos, rd->skip);
+		to = MIN(next, rd->skip + rd->length);
+		memcpy((void *)(rd->buffer + from - rd->skip),
+		       (void *)(half_buf[rd->cur_half] + from - rd->pos),
+		       to - from);
+
+		rd->cur_half ^= 1U;
+	}
+
+	cur->file_pos += rd->length;
+	*length_read = rd->length;
+
+	return 0;
+}
+
 /*
  * This function allows the caller to read any number of bytes
  * from any position. It hides from the caller that the low level
@@ -273,6 +617,23 @@ static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 	       (length > 0) &&
 	       (ops->read != 0));
 
+	if ((cur->cache.sets != 0U) && (length <= BLOCK_CACHE_MAX_READ) &&
+	    (block_cache_read(cur, buffer, length, length_read) == 0)) {
+		return 0;
+	}
+
+	/*
+	 * A synchronous read only gains from the split path if the transfer of
+	 * a chunk can overlap the copy of the previous one.
+	 */
+	if (block_can_split_read(cur) &&
+	    block_split_read_overlaps(cur, length)) {
+		if (block_split_start(cur, buffer, length) != 0) {
+			return -EIO;
+		}
+		return block_split_wait(cur, length_read);
+	}
+
 	/*
 	 * We don't know the number of bytes that we are going
 	 * to read in every iteration, because it will depend
@@ -346,6 +707,47 @@ static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 	return 0;
 }
 
+/*
+ * Split-phase read. Reads that the block cache can serve and devices without
+ * split-phase operations are done synchronously here.
+ */
+static int block_read_start(io_entity_t *entity, uintptr_t buffer,
+			    size_t length)
+{
+	block_dev_state_t *cur;
+
+	assert(entity->info != (uintptr_t)NULL);
+	cur = (block_dev_state_t *)entity->info;
+	assert((length <= cur->size) && (length > 0));
+
+	cur->split.done = (cur->cache.sets != 0U) &&
+			  (length <= BLOCK_CACHE_MAX_READ);
+	if (!cur->split.done && block_can_split_read(cur)) {
+		return block_split_start(cur, buffer, length);
+	}
+
+	cur->split.done = true;
+	cur->split.length_read = 0U;
+	cur->split.result = block_read(entity, buffer, length,
+				       &cur->split.length_read);
+	return 0;
+}
+
+static int block_read_wait(io_entity_t *entity, size_t *length_read)
+{
+	block_dev_state_t *cur;
+
+	assert(entity->info != (uintptr_t)NULL);
+	cur = (block_dev_state_t *)entity->info;
+
+	if (cur->split.done) {
+		*length_read = cur->split.length_read;
+		return cur->split.result;
+	}
+
+	return block_split_wait(cur, length_read);
+}
+
 /*
  * This function allows the caller to write any number of bytes
  * from any position. It hides from the caller that the low level
@@ -385,6 +787,11 @@ static int block_write(io_entity_t *entity, const uintptr_t buffer,
 	       (ops->read != 0) &&
 	       (ops->write != 0));
 
+	if (cur->cache.sets != 0U) {
+		block_cache_invalidate(&cur->cache, cur->base + cur->file_pos,
+				       length);
+	}
+
 	/*
 	 * We don't know the number of bytes that we are going
 	 * to write in every iteration, because it will depend
@@ -518,6 +925,8 @@ static int block_dev_open(const uintptr_t dev_spec, io_dev_info_t **dev_info)
 	       ((buffer->offset % block_size) == 0) &&
 	       ((buffer->length % block_size) == 0));
 
+	block_cache_init(cur);
+
 	*dev_info = info;	/* cast away const */
 	(void)block_size;
 	(void)buffer;
@@ -526,11 +935,41 @@ static int block_dev_open(const uintptr_t dev_spec, io_dev_info_t **dev_info)
 
 static int block_dev_close(io_dev_info_t *dev_info)
 {
+	block_dev_state_t *cur = (block_dev_state_t *)dev_info->info;
+
+	if (cur->cache.sets != 0U) {
+		VERBOSE("io_block: cache hits %u misses %u read ahead %u\n",
+			cur->cache.stats.hits, cur->cache.stats.misses,
+			cur->cache.stats.read_ahead);
+	}
+
 	return free_dev_info(dev_info);
 }
 
 /* Exported functions */
 
+/* Get the block cache statistics of an open block device */
+int io_block_get_cache_stats(uintptr_t dev_handle,
+			     io_block_cache_stats_t *stats)
+{
+	io_dev_info_t *dev_info = (io_dev_info_t *)dev_handle;
+	block_dev_state_t *cur;
+
+	assert((dev_info != NULL) && (stats != NULL));
+
+	if (dev_info->funcs != &block_dev_funcs) {
+		return -EINVAL;
+	}
+
+	cur = (block_dev_state_t *)dev_info->info;
+	if (cur->cache.sets == 0U) {
+		return -ENOENT;
+	}
+
+	*stats = cur->cache.stats;
+	return 0;
+}
+
 /* Register the Block driver with the IO abstraction */
 int register_io_dev_block(const io_dev_connector_t **dev_con)
 {
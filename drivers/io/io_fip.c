@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2014-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -59,6 +59,8 @@ static const uuid_t uuid_null = { {0} };
 static file_state_t current_file = {0};
 static uintptr_t backend_dev_handle;
 static uintptr_t backend_image_spec;
+/* Backend handle of the read started by fip_file_read_start() */
+static uintptr_t backend_read_handle;
 
 static fip_dev_state_t state_pool[MAX_FIP_DEVICES];
 static io_dev_info_t dev_info_pool[MAX_FIP_DEVICES];
@@ -73,6 +75,9 @@ static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 static int fip_file_len(io_entity_t *entity, size_t *length);
 static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 			  size_t *length_read);
+static int fip_file_read_start(io_entity_t *entity, uintptr_t buffer,
+			       size_t length);
+static int fip_file_read_wait(io_entity_t *entity, size_t *length_read);
 static int fip_file_close(io_entity_t *entity);
 static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params);
 static int fip_dev_close(io_dev_info_t *dev_info);
@@ -114,6 +119,8 @@ static const io_dev_funcs_t fip_dev_funcs = {
 	.seek = NULL,
 	.size = fip_file_len,
 	.read = fip_file_read,
+	.read_start = fip_file_read_start,
+	.read_wait = fip_file_read_wait,
 	.write = NULL,
 	.close = fip_file_close,
 	.dev_init = fip_dev_init,
@@ -418,6 +425,78 @@ static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 }
 
 
+/*
+ * Start reading a file in package. The backend is opened here and stays open
+ * until the read completes in fip_file_read_wait().
+ */
+static int fip_file_read_start(io_entity_t *entity, uintptr_t buffer,
+			       size_t length)
+{
+	int result;
+	file_state_t *fp;
+	size_t file_offset;
+
+	assert(entity != NULL);
+	assert(entity->info != (uintptr_t)NULL);
+	assert(backend_read_handle == (uintptr_t)NULL);
+
+	result = io_open(backend_dev_handle, backend_image_spec,
+			 &backend_read_handle);
+	if (result != 0) {
+		WARN("Failed to open FIP (%i)\n", result);
+		backend_read_handle = (uintptr_t)NULL;
+		return -ENOENT;
+	}
+
+	fp = (file_state_t *)entity->info;
+
+	/* Seek to the position in the FIP where the payload lives */
+	file_offset = fp->entry.offset_address + fp->file_pos;
+	result = io_seek(backend_read_handle, IO_SEEK_SET, file_offset);
+	if (result == 0) {
+		result = io_read_start(backend_read_handle, buffer, length);
+	}
+	if (result != 0) {
+		WARN("Failed to read payload (%i)\n", result);
+		io_close(backend_read_handle);
+		backend_read_handle = (uintptr_t)NULL;
+		return -ENOENT;
+	}
+
+	return 0;
+}
+
+
+/* Complete a read started by fip_file_read_start() */
+static int fip_file_read_wait(io_entity_t *entity, size_t *length_read)
+{
+	int result;
+	file_state_t *fp;
+	size_t bytes_read;
+
+	assert(entity != NULL);
+	assert(length_read != NULL);
+	assert(entity->info != (uintptr_t)NULL);
+	assert(backend_read_handle != (uintptr_t)NULL);
+
+	result = io_read_wait(backend_read_handle, &bytes_read);
+	if (result != 0) {
+		WARN("Failed to read payload (%i)\n", result);
+		result = -ENOENT;
+	} else {
+		/* Set caller length and new file position. */
+		fp = (file_state_t *)entity->info;
+		*length_read = bytes_read;
+		fp->file_pos += bytes_read;
+	}
+
+	io_close(backend_read_handle);
+	backend_read_handle = (uintptr_t)NULL;
+
+	return result;
+}
+
+
 /* Close a file in package */
 static int fip_file_close(io_entity_t *entity)
 {
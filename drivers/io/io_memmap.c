@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2014-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -10,6 +10,7 @@
 #include <platform_def.h>
 
 #include <common/debug.h>
+#include <drivers/dma.h>
 #include <drivers/io/io_driver.h>
 #include <drivers/io/io_memmap.h>
 #include <drivers/io/io_storage.h>
@@ -27,6 +28,10 @@ typedef struct {
 	uintptr_t	base;
 	size_t		file_pos;
 	size_t		size;
+#if USE_DMA_MEMCPY
+	/* Copy started by memmap_block_read_start() */
+	dma_req_t	read_req;
+#endif
 } file_state_t;
 
 static file_state_t current_file = {0};
@@ -46,6 +51,11 @@ static int memmap_block_seek(io_entity_t *entity, int mode,
 static int memmap_block_len(io_entity_t *entity, size_t *length);
 static int memmap_block_read(io_entity_t *entity, uintptr_t buffer,
 			     size_t length, size_t *length_read);
+#if USE_DMA_MEMCPY
+static int memmap_block_read_start(io_entity_t *entity, uintptr_t buffer,
+				   size_t length);
+static int memmap_block_read_wait(io_entity_t *entity, size_t *length_read);
+#endif
 static int memmap_block_write(io_entity_t *entity, const uintptr_t buffer,
 			      size_t length, size_t *length_written);
 static int memmap_block_close(io_entity_t *entity);
@@ -63,6 +73,10 @@ static const io_dev_funcs_t memmap_dev_funcs = {
 	.seek = memmap_block_seek,
 	.size = memmap_block_len,
 	.read = memmap_block_read,
+#if USE_DMA_MEMCPY
+	.read_start = memmap_block_read_start,
+	.read_wait = memmap_block_read_wait,
+#endif
 	.write = memmap_block_write,
 	.close = memmap_block_close,
 	.dev_init = NULL,
@@ -191,6 +205,53 @@ static int memmap_block_read(io_entity_t *entity, uintptr_t buffer,
 }
 
 
+#if USE_DMA_MEMCPY
+/* Start reading data from a file on the memmap device with the DMA engine */
+static int memmap_block_read_start(io_entity_t *entity, uintptr_t buffer,
+				   size_t length)
+{
+	file_state_t *fp;
+	size_t pos_after;
+
+	assert(entity != NULL);
+
+	fp = (file_state_t *) entity->info;
+
+	/* Assert that file position is valid for this read operation */
+	pos_after = fp->file_pos + length;
+	assert((pos_after >= fp->file_pos) && (pos_after <= fp->size));
+
+	return dma_memcpy_start(&fp->read_req, (void *)buffer,
+				(void *)(fp->base + fp->file_pos), length);
+}
+
+
+/* Wait for the end of a read started by memmap_block_read_start() */
+static int memmap_block_read_wait(io_entity_t *entity, size_t *length_read)
+{
+	file_state_t *fp;
+	int result;
+
+	assert(entity != NULL);
+	assert(length_read != NULL);
+
+	fp = (file_state_t *) entity->info;
+
+	result = dma_wait(&fp->read_req);
+	if (result != 0) {
+		return result;
+	}
+
+	*length_read = fp->read_req.len;
+
+	/* Set file position after read */
+	fp->file_pos += fp->read_req.len;
+
+	return 0;
+}
+#endif
+
+
 /* Write data to a file on the memmap device */
 static int memmap_block_write(io_entity_t *entity, const uintptr_t buffer,
 			      size_t length, size_t *length_written)
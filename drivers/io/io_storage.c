@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2014-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -293,6 +293,53 @@ int io_read(uintptr_t handle,
 }
 
 
+/*
+ * Start reading data from an IO entity. The read completes in io_read_wait(),
+ * which must be called before any other operation on the entity or its
+ * device. Drivers without split-phase read support do the whole read here.
+ */
+int io_read_start(uintptr_t handle, uintptr_t buffer, size_t length)
+{
+	int result = -ENODEV;
+	assert(is_valid_entity(handle));
+
+	io_entity_t *entity = (io_entity_t *)handle;
+
+	io_dev_info_t *dev = entity->dev_handle;
+
+	if ((dev->funcs->read_start != NULL) &&
+	    (dev->funcs->read_wait != NULL)) {
+		result = dev->funcs->read_start(entity, buffer, length);
+	} else if (dev->funcs->read != NULL) {
+		entity->read_length = 0;
+		entity->read_result = dev->funcs->read(entity, buffer, length,
+						       &entity->read_length);
+		result = 0;
+	}
+
+	return result;
+}
+
+
+/* Wait for the end of a read started by io_read_start() */
+int io_read_wait(uintptr_t handle, size_t *length_read)
+{
+	assert(is_valid_entity(handle));
+	assert(length_read != NULL);
+
+	io_entity_t *entity = (io_entity_t *)handle;
+
+	io_dev_info_t *dev = entity->dev_handle;
+
+	if ((dev->funcs->read_start != NULL) &&
+	    (dev->funcs->read_wait != NULL))
+		return dev->funcs->read_wait(entity, length_read);
+
+	*length_read = entity->read_length;
+	return entity->read_result;
+}
+
+
 /* Write data to an IO entity */
 int io_write(uintptr_t handle,
 		const uintptr_t buffer,
@@ -19,6 +19,7 @@
 
 #define MMC_DEFAULT_MAX_RETRIES		5
 #define SEND_OP_COND_MAX_RETRIES	100
+#define READ_POLL_TIMEOUT_US		1000000
 
 #define MULT_BY_512K_SHIFT		19
 
@@ -30,6 +31,13 @@ static unsigned int mmc_flags;
 static struct mmc_device_info *mmc_dev_info;
 static unsigned int rca;
 
+/* Read started by mmc_read_blocks_start(), size is zero if there is none */
+static struct {
+	int		lba;
+	uintptr_t	buf;
+	size_t		size;
+} read_req;
+
 static const unsigned char tran_speed_base[16] = {
 	0, 10, 12, 13, 15, 20, 26, 30, 35, 40, 45, 52, 55, 60, 70, 80
 };
@@ -495,7 +503,7 @@ static int mmc_enumerate(unsigned int clk, unsigned int bus_width)
 	return mmc_fill_device_info();
 }
 
-size_t mmc_read_blocks(int lba, uintptr_t buf, size_t size)
+int mmc_read_blocks_start(int lba, uintptr_t buf, size_t size)
 {
 	int ret;
 	unsigned int cmd_idx, cmd_arg;
@@ -504,10 +512,11 @@ size_t mmc_read_blocks(int lba, uintptr_t buf, size_t size)
 	       (ops->read != NULL) &&
 	       (size != 0U) &&
 	       ((size & MMC_BLOCK_MASK) == 0U));
+	assert(read_req.size == 0U);
 
 	ret = ops->prepare(lba, buf, size);
 	if (ret != 0) {
-		return 0;
+		return ret;
 	}
 
 	if (is_cmd23_enabled()) {
@@ -515,7 +524,7 @@ size_t mmc_read_blocks(int lba, uintptr_t buf, size_t size)
 		ret = mmc_send_cmd(MMC_CMD(23), size / MMC_BLOCK_SIZE,
 				   MMC_RESPONSE_R1, NULL);
 		if (ret != 0) {
-			return 0;
+			return ret;
 		}
 
 		cmd_idx = MMC_CMD(18);
@@ -536,21 +545,69 @@ size_t mmc_read_blocks(int lba, uintptr_t buf, size_t size)
 
 	ret = mmc_send_cmd(cmd_idx, cmd_arg, MMC_RESPONSE_R1, NULL);
 	if (ret != 0) {
-		return 0;
+		return ret;
+	}
+
+	read_req.lba = lba;
+	read_req.buf = buf;
+	read_req.size = size;
+
+	return 0;
+}
+
+/*
+ * Stop a read whose data transfer failed. The card is left in the data state
+ * after an error, so it is sent back to the transfer state with CMD12.
+ */
+static void mmc_read_blocks_abort(void)
+{
+	(void)mmc_send_cmd(MMC_CMD(12), 0, MMC_RESPONSE_R1B, NULL);
+
+	if (ops->read_abort != NULL) {
+		ops->read_abort();
+	}
+}
+
+size_t mmc_read_blocks_wait(void)
+{
+	size_t size = read_req.size;
+	int timeout = READ_POLL_TIMEOUT_US;
+	int ret;
+
+	assert(size != 0U);
+	read_req.size = 0U;
+
+	if (ops->read_poll != NULL) {
+		ret = ops->read_poll();
+		while ((ret == -EAGAIN) && (--timeout != 0)) {
+			udelay(1);
+			ret = ops->read_poll();
+		}
+		if (ret != 0) {
+			ERROR("Read of %zu bytes failed (%d)\n", size, ret);
+			mmc_read_blocks_abort();
+			return 0;
+		}
 	}
 
-	ret = ops->read(lba, buf, size);
+	ret = ops->read(read_req.lba, read_req.buf, size);
 	if (ret != 0) {
 		return 0;
 	}
 
-	/* Wait buffer empty */
-	do {
+	/*
+	 * Wait buffer empty. The driver already reported the end of the data
+	 * transfer if it can poll for it.
+	 */
+	while (ops->read_poll == NULL) {
 		ret = mmc_device_state();
 		if (ret < 0) {
 			return 0;
 		}
-	} while ((ret != MMC_STATE_TRAN) && (ret != MMC_STATE_DATA));
+		if ((ret == MMC_STATE_TRAN) || (ret == MMC_STATE_DATA)) {
+			break;
+		}
+	}
 
 	if (!is_cmd23_enabled() && (size > MMC_BLOCK_SIZE)) {
 		ret = mmc_send_cmd(MMC_CMD(12), 0, MMC_RESPONSE_R1B, NULL);
@@ -562,6 +619,15 @@ size_t mmc_read_blocks(int lba, uintptr_t buf, size_t size)
 	return size;
 }
 
+size_t mmc_read_blocks(int lba, uintptr_t buf, size_t size)
+{
+	if (mmc_read_blocks_start(lba, buf, size) != 0) {
+		return 0;
+	}
+
+	return mmc_read_blocks_wait();
+}
+
 size_t mmc_write_blocks(int lba, const uintptr_t buf, size_t size)
 {
 	int ret;
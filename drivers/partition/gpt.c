@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -37,6 +37,31 @@ static int unicode_to_ascii(unsigned short *str_in, unsigned char *str_out)
 	return 0;
 }
 
+/*
+ * CRC-32 as used by the GPT (IEEE 802.3, reflected), computed a nibble at a
+ * time to keep the table small.
+ */
+static const uint32_t gpt_crc32_table[16] = {
+	0x00000000U, 0x1db71064U, 0x3b6e20c8U, 0x26d930acU,
+	0x76dc4190U, 0x6b6b51f4U, 0x4db26158U, 0x5005713cU,
+	0xedb88320U, 0xf00f9344U, 0xd6d6a3e8U, 0xcb61b38cU,
+	0x9b64c2b0U, 0x86d3d2d4U, 0xa00ae278U, 0xbdbdf21cU
+};
+
+uint32_t gpt_crc32(uint32_t crc, const void *buf, size_t size)
+{
+	const uint8_t *p = buf;
+	size_t i;
+
+	crc = ~crc;
+	for (i = 0U; i < size; i++) {
+		crc ^= p[i];
+		crc = (crc >> 4) ^ gpt_crc32_table[crc & 0xfU];
+		crc = (crc >> 4) ^ gpt_crc32_table[crc & 0xfU];
+	}
+	return ~crc;
+}
+
 int parse_gpt_entry(gpt_entry_t *gpt_entry, partition_entry_t *entry)
 {
 	int result;
@@ -5,6 +5,9 @@
  */
 
 #include <assert.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -13,11 +16,25 @@
 #include <drivers/partition/partition.h>
 #include <drivers/partition/gpt.h>
 #include <drivers/partition/mbr.h>
+#include <lib/cassert.h>
 #include <plat/common/platform.h>
 
+/* Number of slots of the partition name index, a power of two */
+#define PARTITION_INDEX_SIZE		256U
+
+CASSERT(PARTITION_INDEX_SIZE >= (2U * PLAT_PARTITION_MAX_ENTRIES),
+	assert_partition_index_size);
+
 static uint8_t mbr_sector[PARTITION_BLOCK_SIZE];
+static uint8_t gpt_entries[PLAT_PARTITION_READ_SIZE];
 static partition_entry_list_t list;
 
+/*
+ * Open addressing hash table of the partitions indexed by name. Each slot
+ * holds the index in `list` plus one, zero marks an empty slot.
+ */
+static uint8_t name_index[PARTITION_INDEX_SIZE];
+
 #if LOG_LEVEL >= LOG_LEVEL_VERBOSE
 static void dump_entries(int num)
 {
@@ -39,6 +56,37 @@ static void dump_entries(int num)
 #define dump_entries(num)	((void)num)
 #endif
 
+static unsigned int name_hash(const char *name)
+{
+	unsigned int hash = 2166136261U;
+
+	while (*name != '\0') {
+		hash ^= (unsigned char)*name;
+		hash *= 16777619U;
+		name++;
+	}
+	return hash & (PARTITION_INDEX_SIZE - 1U);
+}
+
+/*
+ * Index the partitions of `list` by name. Partitions are inserted in order so
+ * that, if several share a name, a lookup still returns the first one.
+ */
+static void build_name_index(void)
+{
+	unsigned int slot;
+	int i;
+
+	memset(name_index, 0, sizeof(name_index));
+	for (i = 0; i < list.entry_count; i++) {
+		slot = name_hash(list.list[i].name);
+		while (name_index[slot] != 0U) {
+			slot = (slot + 1U) & (PARTITION_INDEX_SIZE - 1U);
+		}
+		name_index[slot] = (uint8_t)(i + 1);
+	}
+}
+
 /*
  * Load the first sector that carries MBR header.
  * The MBR boot signature should be always valid whether it's MBR or GPT.
@@ -77,28 +125,36 @@ static int load_mbr_header(uintptr_t image_handle, mbr_entry_t *mbr_entry)
  * Load GPT header and check the GPT signature.
  * If partition numbers could be found, check & update it.
  */
-static int load_gpt_header(uintptr_t image_handle)
+static int load_gpt_header(uintptr_t image_handle, gpt_header_t *header)
 {
-	gpt_header_t header;
 	size_t bytes_read;
 	int result;
 
+	assert(header != NULL);
 	result = io_seek(image_handle, IO_SEEK_SET, GPT_HEADER_OFFSET);
 	if (result != 0) {
 		return result;
 	}
-	result = io_read(image_handle, (uintptr_t)&header,
+	result = io_read(image_handle, (uintptr_t)header,
 			 sizeof(gpt_header_t), &bytes_read);
 	if ((result != 0) || (sizeof(gpt_header_t) != bytes_read)) {
-		return result;
+		return (result != 0) ? result : -EIO;
+	}
+	if (memcmp(header->signature, GPT_SIGNATURE,
+		   sizeof(header->signature)) != 0) {
+		return -EINVAL;
 	}
-	if (memcmp(header.signature, GPT_SIGNATURE,
-		   sizeof(header.signature)) != 0) {
+	if ((header->list_num == 0U) ||
+	    (header->part_size != sizeof(gpt_entry_t))) {
+		return -EINVAL;
+	}
+	/* The size of the entry array must fit in a size_t */
+	if (header->list_num > (SIZE_MAX / sizeof(gpt_entry_t))) {
 		return -EINVAL;
 	}
 
 	/* partition numbers can't exceed PLAT_PARTITION_MAX_ENTRIES */
-	list.entry_count = header.list_num;
+	list.entry_count = header->list_num;
 	if (list.entry_count > PLAT_PARTITION_MAX_ENTRIES) {
 		list.entry_count = PLAT_PARTITION_MAX_ENTRIES;
 	}
@@ -156,31 +212,52 @@ static int load_mbr_entries(uintptr_t image_handle)
 	return 0;
 }
 
-static int load_gpt_entry(uintptr_t image_handle, gpt_entry_t *entry)
+/*
+ * Read the whole GPT entry array in chunks of PLAT_PARTITION_READ_SIZE bytes,
+ * checking its CRC and parsing the entries as they come in. Parsing stops at
+ * the first unused entry, but the rest of the array is still read to check the
+ * CRC.
+ */
+static int verify_partition_gpt(uintptr_t image_handle,
+				const gpt_header_t *header)
 {
-	size_t bytes_read;
-	int result;
+	size_t left, chunk, bytes_read, off;
+	uint32_t crc = 0U;
+	bool parsing = true;
+	int result, i = 0;
+
+	left = (size_t)header->list_num * sizeof(gpt_entry_t);
+	while (left > 0U) {
+		chunk = (left < sizeof(gpt_entries)) ? left :
+			sizeof(gpt_entries);
+		result = io_read(image_handle, (uintptr_t)gpt_entries, chunk,
+				 &bytes_read);
+		if ((result != 0) || (bytes_read != chunk)) {
+			WARN("Failed to read GPT entries (%i)\n", result);
+			return (result != 0) ? result : -EIO;
+		}
+		crc = gpt_crc32(crc, gpt_entries, chunk);
+
+		for (off = 0U; parsing && (off < chunk);
+		     off += sizeof(gpt_entry_t)) {
+			if (i == list.entry_count) {
+				parsing = false;
+				break;
+			}
+			result = parse_gpt_entry((gpt_entry_t *)&gpt_entries[off],
+						 &list.list[i]);
+			if (result != 0) {
+				parsing = false;
+				break;
+			}
+			i++;
+		}
+		left -= chunk;
+	}
 
-	assert(entry != NULL);
-	result = io_read(image_handle, (uintptr_t)entry, sizeof(gpt_entry_t),
-			 &bytes_read);
-	if (sizeof(gpt_entry_t) != bytes_read)
+	if (crc != header->part_crc) {
+		WARN("GPT entry array CRC mismatch\n");
 		return -EINVAL;
-	return result;
-}
-
-static int verify_partition_gpt(uintptr_t image_handle)
-{
-	gpt_entry_t entry;
-	int result, i;
-
-	for (i = 0; i < list.entry_count; i++) {
-		result = load_gpt_entry(image_handle, &entry);
-		assert(result == 0);
-		result = parse_gpt_entry(&entry, &list.list[i]);
-		if (result != 0) {
-			break;
-		}
 	}
 	if (i == 0) {
 		return -EINVAL;
@@ -199,6 +276,7 @@ int load_partition_table(unsigned int image_id)
 {
 	uintptr_t dev_handle, image_handle, image_spec = 0;
 	mbr_entry_t mbr_entry;
+	gpt_header_t header;
 	int result;
 
 	result = plat_get_image_source(image_id, &dev_handle, &image_spec);
@@ -220,27 +298,40 @@ int load_partition_table(unsigned int image_id)
 		return result;
 	}
 	if (mbr_entry.type == PARTITION_TYPE_GPT) {
-		result = load_gpt_header(image_handle);
-		assert(result == 0);
-		result = io_seek(image_handle, IO_SEEK_SET, GPT_ENTRY_OFFSET);
-		assert(result == 0);
-		result = verify_partition_gpt(image_handle);
+		result = load_gpt_header(image_handle, &header);
+		if (result == 0) {
+			result = io_seek(image_handle, IO_SEEK_SET,
+					 GPT_ENTRY_OFFSET);
+		}
+		if (result == 0) {
+			result = verify_partition_gpt(image_handle, &header);
+		} else {
+			WARN("Failed to load GPT header (%i)\n", result);
+		}
 	} else {
 		result = load_mbr_entries(image_handle);
 	}
 
+	if (result != 0) {
+		list.entry_count = 0;
+	}
+	build_name_index();
+
 	io_close(image_handle);
 	return result;
 }
 
 const partition_entry_t *get_partition_entry(const char *name)
 {
-	int i;
+	unsigned int slot = name_hash(name);
+	const partition_entry_t *entry;
 
-	for (i = 0; i < list.entry_count; i++) {
-		if (strcmp(name, list.list[i].name) == 0) {
-			return &list.list[i];
+	while (name_index[slot] != 0U) {
+		entry = &list.list[name_index[slot] - 1U];
+		if (strcmp(name, entry->name) == 0) {
+			return entry;
 		}
+		slot = (slot + 1U) & (PARTITION_INDEX_SIZE - 1U);
 	}
 	return NULL;
 }
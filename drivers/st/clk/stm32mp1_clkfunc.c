@@ -10,6 +10,7 @@
 
 #include <platform_def.h>
 
+#include <common/fdt_wrappers.h>
 #include <drivers/st/stm32mp1_clk.h>
 #include <drivers/st/stm32mp1_clkfunc.h>
 #include <dt-bindings/clock/stm32mp1-clksrc.h>
@@ -36,7 +37,7 @@ const char *stm32mp_osc_node_label[NB_OSC] = {
  ******************************************************************************/
 static int fdt_get_rcc_node(void *fdt)
 {
-	return fdt_node_offset_by_compatible(fdt, -1, DT_RCC_CLK_COMPAT);
+	return fdtw_node_offset_by_compatible(fdt, -1, DT_RCC_CLK_COMPAT);
 }
 
 /*******************************************************************************
@@ -54,7 +55,7 @@ int fdt_osc_read_freq(const char *name, uint32_t *freq)
 		return -ENOENT;
 	}
 
-	node = fdt_path_offset(fdt, "/clocks");
+	node = fdtw_path_offset(fdt, "/clocks");
 	if (node < 0) {
 		return -FDT_ERR_NOTFOUND;
 	}
@@ -106,7 +107,7 @@ bool fdt_osc_read_bool(enum stm32mp_osc_id osc_id, const char *prop_name)
 		return false;
 	}
 
-	node = fdt_path_offset(fdt, "/clocks");
+	node = fdtw_path_offset(fdt, "/clocks");
 	if (node < 0) {
 		return false;
 	}
@@ -152,7 +153,7 @@ uint32_t fdt_osc_read_uint32_default(enum stm32mp_osc_id osc_id,
 		return dflt_value;
 	}
 
-	node = fdt_path_offset(fdt, "/clocks");
+	node = fdtw_path_offset(fdt, "/clocks");
 	if (node < 0) {
 		return dflt_value;
 	}
@@ -191,7 +192,7 @@ uint32_t fdt_rcc_read_addr(void)
 		return 0;
 	}
 
-	node = fdt_path_offset(fdt, "/soc");
+	node = fdtw_path_offset(fdt, "/soc");
 	if (node < 0) {
 		return 0;
 	}
@@ -237,7 +238,7 @@ int fdt_rcc_read_uint32_array(const char *prop_name,
 		return -ENOENT;
 	}
 
-	node = fdt_node_offset_by_compatible(fdt, -1, DT_RCC_CLK_COMPAT);
+	node = fdtw_node_offset_by_compatible(fdt, -1, DT_RCC_CLK_COMPAT);
 	if (node < 0) {
 		return -FDT_ERR_NOTFOUND;
 	}
@@ -339,7 +340,7 @@ uintptr_t fdt_get_stgen_base(void)
 		return 0;
 	}
 
-	node = fdt_node_offset_by_compatible(fdt, -1, DT_STGEN_COMPAT);
+	node = fdtw_node_offset_by_compatible(fdt, -1, DT_STGEN_COMPAT);
 	if (node < 0) {
 		return 0;
 	}
@@ -323,6 +323,28 @@ static void set_reg(const struct ddr_info *priv,
 	}
 }
 
+static void get_reg(const struct ddr_info *priv,
+		    enum reg_type type,
+		    void *param)
+{
+	unsigned int i;
+	enum base_type base = ddr_registers[type].base;
+	uintptr_t base_addr = get_base_addr(priv, base);
+	const struct reg_desc *desc = ddr_registers[type].desc;
+
+	for (i = 0; i < ddr_registers[type].size; i++) {
+		uintptr_t ptr = base_addr + desc[i].offset;
+
+		if (desc[i].par_offset == INVALID_OFFSET) {
+			ERROR("invalid parameter offset for %s", desc[i].name);
+			panic();
+		} else {
+			*((uint32_t *)((uintptr_t)param +
+				       desc[i].par_offset)) = mmio_read_32(ptr);
+		}
+	}
+}
+
 static void stm32mp1_ddrphy_idone_wait(struct stm32mp1_ddrphy *phy)
 {
 	uint32_t pgsr;
@@ -882,37 +904,49 @@ void stm32mp1_ddr_init(struct ddr_info *priv,
 		stm32mp1_ddr3_dll_off(priv);
 	}
 
-	VERBOSE("DDR DQS training : ");
-
 	/*
-	 *  8. Disable Auto refresh and power down by setting
-	 *    - RFSHCTL3.dis_au_refresh = 1
-	 *    - PWRCTL.powerdown_en = 0
-	 *    - DFIMISC.dfiinit_complete_en = 0
+	 * Skip the DQS training when p_cal already holds the result of a
+	 * previous training of the same DDR.
 	 */
-	stm32mp1_refresh_disable(priv->ctl);
-
-	/*
-	 *  9. Program PUBL PGCR to enable refresh during training
-	 *     and rank to train
-	 *     not done => keep the programed value in PGCR
-	 */
-
-	/*
-	 * 10. configure PUBL PIR register to specify which training step
-	 * to run
-	 * Warning : RVTRN  is not supported by this PUBL
-	 */
-	stm32mp1_ddrphy_init(priv->phy, DDRPHYC_PIR_QSTRN);
-
-	/* 11. monitor PUB PGSR.IDONE to poll cpmpletion of training sequence */
-	stm32mp1_ddrphy_idone_wait(priv->phy);
-
-	/*
-	 * 12. set back registers in step 8 to the orginal values if desidered
-	 */
-	stm32mp1_refresh_restore(priv->ctl, config->c_reg.rfshctl3,
-				 config->c_reg.pwrctl);
+	if (config->p_cal_present) {
+		VERBOSE("DDR DQS training skipped\n");
+	} else {
+		VERBOSE("DDR DQS training : ");
+
+		/*
+		 *  8. Disable Auto refresh and power down by setting
+		 *    - RFSHCTL3.dis_au_refresh = 1
+		 *    - PWRCTL.powerdown_en = 0
+		 *    - DFIMISC.dfiinit_complete_en = 0
+		 */
+		stm32mp1_refresh_disable(priv->ctl);
+
+		/*
+		 *  9. Program PUBL PGCR to enable refresh during training
+		 *     and rank to train
+		 *     not done => keep the programed value in PGCR
+		 */
+
+		/*
+		 * 10. configure PUBL PIR register to specify which training
+		 * step to run
+		 * Warning : RVTRN  is not supported by this PUBL
+		 */
+		stm32mp1_ddrphy_init(priv->phy, DDRPHYC_PIR_QSTRN);
+
+		/*
+		 * 11. monitor PUB PGSR.IDONE to poll cpmpletion of training
+		 * sequence
+		 */
+		stm32mp1_ddrphy_idone_wait(priv->phy);
+
+		/*
+		 * 12. set back registers in step 8 to the orginal values if
+		 * desidered
+		 */
+		stm32mp1_refresh_restore(priv->ctl, config->c_reg.rfshctl3,
+					 config->c_reg.pwrctl);
+	}
 
 	/* Enable uMCTL2 AXI port 0 */
 	mmio_setbits_32((uintptr_t)&priv->ctl->pctrl_0,
@@ -928,3 +962,13 @@ void stm32mp1_ddr_init(struct ddr_info *priv,
 		(uintptr_t)&priv->ctl->pctrl_1,
 		mmio_read_32((uintptr_t)&priv->ctl->pctrl_1));
 }
+
+/*
+ * Read back the calibration registers, e.g. after the DQS training, so that
+ * they can be given in p_cal for a later initialization of the same DDR.
+ */
+void stm32mp1_ddr_get_cal(struct ddr_info *priv,
+			  struct stm32mp1_ddrphy_cal *cal)
+{
+	get_reg(priv, REGPHY_CAL, cal);
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2019, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+ OR BSD-3-Clause
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <platform_def.h>
+
+#include <drivers/st/stm32mp1_ddr.h>
+#include <drivers/st/stm32mp1_ddr_cal.h>
+#include <lib/cassert.h>
+#include <lib/mmio.h>
+
+/*******************************************************************************
+ * The results of the DQS training are saved in the TAMP backup registers, which
+ * keep their content across resets as long as VBAT is present, and restored on
+ * the next cold boots instead of training the DDR again. They are laid out as:
+ * - a fingerprint of the DDR configuration read from the DT,
+ * - the calibration registers (struct stm32mp1_ddrphy_cal),
+ * - a check word, computed on the two above.
+ * The saved results are only used if both the fingerprint and the check word
+ * match, which catches stale or partially written results.
+ *
+ * The check word is a FNV-1a hash, not a digest from crypto_mod: crypto_mod
+ * only verifies hashes and signatures, and isn't built in BL2 for this
+ * platform. A digest would not help anyway, as anyone able to write the
+ * results could write a matching digest too. The results are instead kept in
+ * the TAMP secure write zone, so that only the secure world can write them,
+ * and results found while that zone didn't cover them are discarded.
+ ******************************************************************************/
+#define DDR_CAL_WORDS	(sizeof(struct stm32mp1_ddrphy_cal) / sizeof(uint32_t))
+#define DDR_CAL_MAGIC	0x43414C31U	/* "CAL1" */
+#define DDR_CAL_END	(TAMP_DDR_CAL_BACKUP_REG_ID + TAMP_DDR_CAL_BACKUP_REG_NB)
+
+CASSERT(TAMP_DDR_CAL_BACKUP_REG_NB == (DDR_CAL_WORDS + 2U),
+	assert_ddr_cal_backup_reg_nb);
+
+/* FNV-1a hash */
+static uint32_t ddr_hash(uint32_t hash, const void *data, size_t size)
+{
+	const uint8_t *byte = data;
+	size_t i;
+
+	for (i = 0U; i < size; i++) {
+		hash ^= byte[i];
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
+static uint32_t ddr_config_fingerprint(const struct stm32mp1_ddr_config *config)
+{
+	uint32_t hash = 2166136261U;
+
+	hash = ddr_hash(hash, config->info.name, strlen(config->info.name));
+	hash = ddr_hash(hash, &config->info.speed, sizeof(config->info.speed));
+	hash = ddr_hash(hash, &config->info.size, sizeof(config->info.size));
+
+	/* All the settings read from the DT, except the calibration */
+	return ddr_hash(hash, &config->c_reg,
+			offsetof(struct stm32mp1_ddr_config, p_cal) -
+			offsetof(struct stm32mp1_ddr_config, c_reg));
+}
+
+static uint32_t ddr_cal_check(uint32_t fingerprint,
+			      const struct stm32mp1_ddrphy_cal *cal)
+{
+	return ddr_hash(fingerprint ^ DDR_CAL_MAGIC, cal, sizeof(*cal));
+}
+
+void stm32mp1_ddr_cal_invalidate(void)
+{
+	mmio_write_32(tamp_bkpr(TAMP_DDR_CAL_BACKUP_REG_ID), 0U);
+}
+
+/*
+ * Returns true if the backup registers holding the results were already out of
+ * reach of non-secure writes. Otherwise their content is invalidated and the
+ * secure write zone is extended to cover them. The secure read/write zone is
+ * left as it is, so the non-secure world keeps reading all the registers, and
+ * the registers above the results stay fully non-secure.
+ */
+static bool ddr_cal_secure_zone(void)
+{
+	uint32_t smcr = mmio_read_32(TAMP_SMCR);
+	uint32_t rw_end = (smcr & TAMP_SMCR_BKPRWPROT_MASK) >>
+			  TAMP_SMCR_BKPRWPROT_SHIFT;
+	uint32_t w_end = (smcr & TAMP_SMCR_BKPWPROT_MASK) >>
+			 TAMP_SMCR_BKPWPROT_SHIFT;
+
+	if ((rw_end >= DDR_CAL_END) || (w_end >= DDR_CAL_END)) {
+		return true;
+	}
+
+	stm32mp1_ddr_cal_invalidate();
+
+	mmio_clrsetbits_32(TAMP_SMCR, TAMP_SMCR_BKPWPROT_MASK,
+			   DDR_CAL_END << TAMP_SMCR_BKPWPROT_SHIFT);
+
+	return false;
+}
+
+/* Returns true if valid results have been loaded in config->p_cal */
+bool stm32mp1_ddr_cal_load(struct stm32mp1_ddr_config *config)
+{
+	struct stm32mp1_ddrphy_cal cal;
+	uint32_t *word = (uint32_t *)&cal;
+	uint32_t fingerprint = ddr_config_fingerprint(config);
+	uint32_t idx = TAMP_DDR_CAL_BACKUP_REG_ID;
+	uint32_t i;
+
+	if (!ddr_cal_secure_zone()) {
+		return false;
+	}
+
+	if (mmio_read_32(tamp_bkpr(idx)) != fingerprint) {
+		return false;
+	}
+
+	for (i = 0U; i < DDR_CAL_WORDS; i++) {
+		word[i] = mmio_read_32(tamp_bkpr(idx + 1U + i));
+	}
+
+	if (mmio_read_32(tamp_bkpr(idx + 1U + DDR_CAL_WORDS)) !=
+	    ddr_cal_check(fingerprint, &cal)) {
+		return false;
+	}
+
+	config->p_cal = cal;
+
+	return true;
+}
+
+void stm32mp1_ddr_cal_save(const struct stm32mp1_ddr_config *config,
+			   const struct stm32mp1_ddrphy_cal *cal)
+{
+	const uint32_t *word = (const uint32_t *)cal;
+	uint32_t fingerprint = ddr_config_fingerprint(config);
+	uint32_t idx = TAMP_DDR_CAL_BACKUP_REG_ID;
+	uint32_t i;
+
+	/* Write the fingerprint last so that a partial save is never used */
+	mmio_write_32(tamp_bkpr(idx), 0U);
+
+	for (i = 0U; i < DDR_CAL_WORDS; i++) {
+		mmio_write_32(tamp_bkpr(idx + 1U + i), word[i]);
+	}
+
+	mmio_write_32(tamp_bkpr(idx + 1U + DDR_CAL_WORDS),
+		      ddr_cal_check(fingerprint, cal));
+	mmio_write_32(tamp_bkpr(idx), fingerprint);
+}
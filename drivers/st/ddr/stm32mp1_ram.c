@@ -5,6 +5,8 @@
  */
 
 #include <errno.h>
+#include <stdbool.h>
+#include <string.h>
 
 #include <libfdt.h>
 
@@ -12,8 +14,10 @@
 
 #include <arch_helpers.h>
 #include <common/debug.h>
+#include <common/fdt_wrappers.h>
 #include <drivers/st/stm32mp1_clk.h>
 #include <drivers/st/stm32mp1_ddr.h>
+#include <drivers/st/stm32mp1_ddr_cal.h>
 #include <drivers/st/stm32mp1_ddr_helpers.h>
 #include <drivers/st/stm32mp1_ram.h>
 #include <drivers/st/stm32mp1_rcc.h>
@@ -165,14 +169,102 @@ static uint32_t ddr_check_size(void)
 	return offset;
 }
 
+#if STM32MP1_DDR_FAST_BOOT
+/*
+ * Save the given results, or invalidate the saved ones if 'cal' is NULL, with
+ * the RTCAPB clock enabled.
+ */
+static int ddr_cal_store(const struct stm32mp1_ddr_config *config,
+			 const struct stm32mp1_ddrphy_cal *cal)
+{
+	uint32_t tamp_clk_off = 0;
+
+	if (!stm32mp1_clk_is_enabled(RTCAPB)) {
+		tamp_clk_off = 1;
+		if (stm32mp1_clk_enable(RTCAPB) != 0) {
+			return -EINVAL;
+		}
+	}
+
+	if (cal != NULL) {
+		stm32mp1_ddr_cal_save(config, cal);
+	} else {
+		stm32mp1_ddr_cal_invalidate();
+	}
+
+	if (tamp_clk_off != 0U) {
+		if (stm32mp1_clk_disable(RTCAPB) != 0) {
+			return -EINVAL;
+		}
+	}
+
+	return 0;
+}
+#endif /* STM32MP1_DDR_FAST_BOOT */
+
+static void ddr_init(struct ddr_info *priv,
+		     struct stm32mp1_ddr_config *config)
+{
+	/* Disable axidcg clock gating during init */
+	mmio_clrbits_32(priv->rcc + RCC_DDRITFCR, RCC_DDRITFCR_AXIDCGEN);
+
+	stm32mp1_ddr_init(priv, config);
+
+	/* Enable axidcg clock gating */
+	mmio_setbits_32(priv->rcc + RCC_DDRITFCR, RCC_DDRITFCR_AXIDCGEN);
+}
+
+/*******************************************************************************
+ * Run the DDR tests with the data cache off. Returns 0 if they pass, -EIO else.
+ ******************************************************************************/
+static int ddr_test(const struct stm32mp1_ddr_config *config)
+{
+	uint32_t uret;
+	int ret = 0;
+
+	write_sctlr(read_sctlr() & ~SCTLR_C_BIT);
+	dcsw_op_all(DC_OP_CISW);
+
+	uret = ddr_test_data_bus();
+	if (uret != 0U) {
+		ERROR("DDR data bus test: can't access memory @ 0x%x\n",
+		      uret);
+		ret = -EIO;
+		goto out;
+	}
+
+	uret = ddr_test_addr_bus();
+	if (uret != 0U) {
+		ERROR("DDR addr bus test: can't access memory @ 0x%x\n",
+		      uret);
+		ret = -EIO;
+		goto out;
+	}
+
+	uret = ddr_check_size();
+	if (uret < config->info.size) {
+		ERROR("DDR size: 0x%x does not match DT config: 0x%x\n",
+		      uret, config->info.size);
+		ret = -EIO;
+	}
+
+out:
+	write_sctlr(read_sctlr() | SCTLR_C_BIT);
+
+	return ret;
+}
+
 static int stm32mp1_ddr_setup(void)
 {
 	struct ddr_info *priv = &ddr_priv_data;
 	int ret;
 	struct stm32mp1_ddr_config config;
 	int node, len;
-	uint32_t tamp_clk_off = 0, uret, idx;
+	uint32_t tamp_clk_off = 0, idx;
 	void *fdt;
+#if STM32MP1_DDR_FAST_BOOT
+	struct stm32mp1_ddrphy_cal dt_cal, trained_cal;
+#endif
 
 #define PARAM(x, y)							\
 	{								\
@@ -202,7 +294,7 @@ static int stm32mp1_ddr_setup(void)
 		return -ENOENT;
 	}
 
-	node = fdt_node_offset_by_compatible(fdt, -1, DT_DDR_COMPAT);
+	node = fdtw_node_offset_by_compatible(fdt, -1, DT_DDR_COMPAT);
 	if (node < 0) {
 		ERROR("%s: Cannot read DDR node in DT\n", __func__);
 		return -EINVAL;
@@ -240,6 +332,11 @@ static int stm32mp1_ddr_setup(void)
 		}
 	}
 
+	config.p_cal_present = false;
+#if STM32MP1_DDR_FAST_BOOT
+	dt_cal = config.p_cal;
+#endif
+
 	if (!stm32mp1_clk_is_enabled(RTCAPB)) {
 		tamp_clk_off = 1;
 		if (stm32mp1_clk_enable(RTCAPB) != 0) {
@@ -247,50 +344,59 @@ static int stm32mp1_ddr_setup(void)
 		}
 	}
 
+#if STM32MP1_DDR_FAST_BOOT
+	config.p_cal_present = stm32mp1_ddr_cal_load(&config);
+	if (config.p_cal_present) {
+		INFO("DDR: restoring saved training results\n");
+	}
+#endif
+
 	if (tamp_clk_off != 0U) {
 		if (stm32mp1_clk_disable(RTCAPB) != 0) {
 			return -EINVAL;
 		}
 	}
 
-	/* Disable axidcg clock gating during init */
-	mmio_clrbits_32(priv->rcc + RCC_DDRITFCR, RCC_DDRITFCR_AXIDCGEN);
-
-	stm32mp1_ddr_init(priv, &config);
-
-	/* Enable axidcg clock gating */
-	mmio_setbits_32(priv->rcc + RCC_DDRITFCR, RCC_DDRITFCR_AXIDCGEN);
+	ddr_init(priv, &config);
 
 	priv->info.size = config.info.size;
 
 	VERBOSE("%s : ram size(%x, %x)\n", __func__,
 		(uint32_t)priv->info.base, (uint32_t)priv->info.size);
 
-	write_sctlr(read_sctlr() & ~SCTLR_C_BIT);
-	dcsw_op_all(DC_OP_CISW);
+	ret = ddr_test(&config);
 
-	uret = ddr_test_data_bus();
-	if (uret != 0U) {
-		ERROR("DDR data bus test: can't access memory @ 0x%x\n",
-		      uret);
-		panic();
-	}
+#if STM32MP1_DDR_FAST_BOOT
+	if ((ret != 0) && config.p_cal_present) {
+		/* Saved results are stale: drop them and train the DDR */
+		WARN("DDR: saved training results failed, training again\n");
 
-	uret = ddr_test_addr_bus();
-	if (uret != 0U) {
-		ERROR("DDR addr bus test: can't access memory @ 0x%x\n",
-		      uret);
-		panic();
+		if (ddr_cal_store(&config, NULL) != 0) {
+			return -EINVAL;
+		}
+
+		config.p_cal = dt_cal;
+		config.p_cal_present = false;
+
+		ddr_init(priv, &config);
+
+		ret = ddr_test(&config);
 	}
+#endif
 
-	uret = ddr_check_size();
-	if (uret < config.info.size) {
-		ERROR("DDR size: 0x%x does not match DT config: 0x%x\n",
-		      uret, config.info.size);
+	if (ret != 0) {
 		panic();
 	}
 
-	write_sctlr(read_sctlr() | SCTLR_C_BIT);
+#if STM32MP1_DDR_FAST_BOOT
+	if (!config.p_cal_present) {
+		stm32mp1_ddr_get_cal(priv, &trained_cal);
+
+		if (ddr_cal_store(&config, &trained_cal) != 0) {
+			return -EINVAL;
+		}
+	}
+#endif
 
 	return 0;
 }
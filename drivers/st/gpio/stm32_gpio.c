@@ -14,6 +14,7 @@
 
 #include <common/bl_common.h>
 #include <common/debug.h>
+#include <common/fdt_wrappers.h>
 #include <drivers/st/stm32_gpio.h>
 #include <drivers/st/stm32mp1_clk.h>
 #include <drivers/st/stm32mp1_clkfunc.h>
@@ -181,7 +182,7 @@ int dt_set_pinctrl_config(int node)
 	for (i = 0; i < ((uint32_t)lenp / 4U); i++) {
 		int p_node, p_subnode;
 
-		p_node = fdt_node_offset_by_phandle(fdt, fdt32_to_cpu(*cuint));
+		p_node = fdtw_node_offset_by_phandle(fdt, fdt32_to_cpu(*cuint));
 		if (p_node < 0) {
 			return -FDT_ERR_NOTFOUND;
 		}
@@ -15,6 +15,7 @@
 #include <arch.h>
 #include <arch_helpers.h>
 #include <common/debug.h>
+#include <common/fdt_wrappers.h>
 #include <drivers/delay_timer.h>
 #include <drivers/mmc.h>
 #include <drivers/st/stm32_gpio.h>
@@ -623,7 +624,7 @@ static int stm32_sdmmc2_dt_get_config(void)
 		return -FDT_ERR_NOTFOUND;
 	}
 
-	sdmmc_node = fdt_node_offset_by_compatible(fdt, -1, DT_SDMMC2_COMPAT);
+	sdmmc_node = fdtw_node_offset_by_compatible(fdt, -1, DT_SDMMC2_COMPAT);
 
 	while (sdmmc_node != -FDT_ERR_NOTFOUND) {
 		cuint = fdt_getprop(fdt, sdmmc_node, "reg", NULL);
@@ -635,8 +636,8 @@ static int stm32_sdmmc2_dt_get_config(void)
 			break;
 		}
 
-		sdmmc_node = fdt_node_offset_by_compatible(fdt, sdmmc_node,
-							   DT_SDMMC2_COMPAT);
+		sdmmc_node = fdtw_node_offset_by_compatible(fdt, sdmmc_node,
+							    DT_SDMMC2_COMPAT);
 	}
 
 	if (sdmmc_node == -FDT_ERR_NOTFOUND) {
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -125,6 +125,8 @@ static int dw_set_ios(unsigned int clk, unsigned int width);
 static int dw_prepare(int lba, uintptr_t buf, size_t size);
 static int dw_read(int lba, uintptr_t buf, size_t size);
 static int dw_write(int lba, uintptr_t buf, size_t size);
+static int dw_read_poll(void);
+static void dw_read_abort(void);
 
 static const struct mmc_ops dw_mmc_ops = {
 	.init		= dw_init,
@@ -133,6 +135,8 @@ static const struct mmc_ops dw_mmc_ops = {
 	.prepare	= dw_prepare,
 	.read		= dw_read,
 	.write		= dw_write,
+	.read_poll	= dw_read_poll,
+	.read_abort	= dw_read_abort,
 };
 
 static dw_mmc_params_t dw_params;
@@ -380,6 +384,14 @@ static int dw_prepare(int lba, uintptr_t buf, size_t size)
 
 static int dw_read(int lba, uintptr_t buf, size_t size)
 {
+	/*
+	 * The buffer was cleaned before the transfer, but lines of it may
+	 * have been fetched again meanwhile, e.g. while the CPU copied data
+	 * out of an adjacent buffer. Drop them so that the CPU reads the data
+	 * written by the IDMAC.
+	 */
+	inv_dcache_range(buf, size);
+
 	return 0;
 }
 
@@ -388,6 +400,41 @@ static int dw_write(int lba, uintptr_t buf, size_t size)
 	return 0;
 }
 
+static int dw_read_poll(void)
+{
+	unsigned int data;
+
+	data = mmio_read_32(dw_params.reg_base + DWMMC_RINTSTS);
+	if (data & (INT_EBE | INT_SBE | INT_DCRC | INT_DRT | INT_FRUN))
+		return -EIO;
+	if (!(data & INT_DTO))
+		return -EAGAIN;
+
+	return 0;
+}
+
+static void dw_read_abort(void)
+{
+	uintptr_t base = dw_params.reg_base;
+	unsigned int data;
+
+	/* Drop the data left in the FIFO and stop the IDMAC */
+	mmio_setbits_32(base + DWMMC_CTRL, CTRL_FIFO_RESET | CTRL_DMA_RESET);
+	do {
+		data = mmio_read_32(base + DWMMC_CTRL);
+	} while (data & (CTRL_FIFO_RESET | CTRL_DMA_RESET));
+
+	data = mmio_read_32(base + DWMMC_BMOD);
+	mmio_write_32(base + DWMMC_BMOD, data | BMOD_SWRESET);
+	do {
+		data = mmio_read_32(base + DWMMC_BMOD);
+	} while (data & BMOD_SWRESET);
+	mmio_write_32(base + DWMMC_BMOD, data | BMOD_ENABLE | BMOD_FB);
+
+	mmio_write_32(base + DWMMC_IDSTS, ~0);
+	mmio_write_32(base + DWMMC_RINTSTS, ~0);
+}
+
 void dw_mmc_init(dw_mmc_params_t *params, struct mmc_device_info *info)
 {
 	assert((params != 0) &&
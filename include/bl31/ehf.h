@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -7,13 +7,36 @@
 #ifndef EHF_H
 #define EHF_H
 
+#include <lib/utils_def.h>
+
+/* Number of priority levels that fit in ehf_pri_bits_t */
+#define EHF_MAX_PRIORITIES		U(32)
+
+/*
+ * PMF time-stamp IDs of the EHF statistics, recorded for each CPU when
+ * ENABLE_EHF_STATS is set. The statistics of a priority level are indexed by
+ * its index in the exception priority array, and times are in system counter
+ * ticks.
+ */
+/* Number of times Secure execution allowed Non-secure preemption */
+#define EHF_STAT_ID_NS_PREEMPT		U(0)
+/* Number of activations and interrupts while a priority level was active */
+#define EHF_STAT_ID_NESTED		U(1)
+/* Number of explicit activations of the priority level */
+#define EHF_STAT_ID_ACTIVATE(idx)	(U(2) + ((idx) * U(4)))
+/* Number of EL3 interrupts handled at the priority level */
+#define EHF_STAT_ID_INTR(idx)		(U(3) + ((idx) * U(4)))
+/* Longest time for which the priority level was held */
+#define EHF_STAT_ID_MAX_HOLD(idx)	(U(4) + ((idx) * U(4)))
+/* Time of the last explicit activation of the priority level */
+#define EHF_STAT_ID_START(idx)		(U(5) + ((idx) * U(4)))
+#define EHF_STAT_TOTAL_IDS		EHF_STAT_ID_ACTIVATE(EHF_MAX_PRIORITIES)
+
 #ifndef __ASSEMBLY__
 
 #include <cdefs.h>
 #include <stdint.h>
 
-#include <lib/utils_def.h>
-
 /* Valid priorities set bit 0 of the priority handler. */
 #define EHF_PRI_VALID_	BIT(0)
 
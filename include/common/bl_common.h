@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -183,10 +183,22 @@ typedef struct bl_params {
 	bl_params_node_t *head;
 } bl_params_t;
 
+/* Image being loaded with the split-phase image loading functions */
+typedef struct image_load_req {
+	unsigned int image_id;
+	image_info_t *image_data;
+	uintptr_t dev_handle;
+	uintptr_t image_handle;
+} image_load_req_t;
+
 /*******************************************************************************
  * Function & variable prototypes
  ******************************************************************************/
 int load_auth_image(unsigned int image_id, image_info_t *image_data);
+int load_auth_image_start(unsigned int image_id, image_info_t *image_data,
+			  image_load_req_t *req);
+int load_auth_image_wait(image_load_req_t *req);
+int load_auth_image_verify(image_load_req_t *req);
 
 #if TRUSTED_BOARD_BOOT && defined(DYN_DISABLE_AUTH)
 /*
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2018-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -9,6 +9,9 @@
 #ifndef FDT_WRAPPERS_H
 #define FDT_WRAPPERS_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 /* Number of cells, given total length in bytes. Each cell is 4 bytes long */
 #define NCELLS(len) ((len) / 4U)
 
@@ -21,4 +24,14 @@ int fdtw_read_string(const void *dtb, int node, const char *prop,
 int fdtw_write_inplace_cells(void *dtb, int node, const char *prop,
 		unsigned int cells, void *value);
 
+int fdtw_node_offset_by_compatible(const void *dtb, int startoffset,
+		const char *compat);
+int fdtw_path_offset(const void *dtb, const char *path);
+int fdtw_node_offset_by_phandle(const void *dtb, uint32_t phandle);
+
+#if FDT_INDEX
+int fdtw_index_build(const void *dtb);
+void fdtw_index_invalidate(void);
+#endif
+
 #endif /* FDT_WRAPPERS_H */
@@ -31,6 +31,18 @@
 #endif /* AARCH32 */
 #define SIZEOF_RT_SVC_DESC	(U(1) << RT_SVC_SIZE_LOG2)
 
+/*
+ * Constants to allow the assembler access a leaf runtime service
+ * descriptor
+ */
+#ifdef AARCH32
+#define RT_SVC_LEAF_DESC_HANDLE	U(4)
+#define SIZEOF_RT_SVC_LEAF_DESC	U(12)
+#else
+#define RT_SVC_LEAF_DESC_HANDLE	U(8)
+#define SIZEOF_RT_SVC_LEAF_DESC	U(24)
+#endif /* AARCH32 */
+
 
 /*
  * In SMCCC 1.X, the function identifier has 6 bits for the owning entity number
@@ -81,6 +93,50 @@ typedef struct rt_svc_desc {
 			.handle = (_smch)				\
 		}
 
+/*
+ * A leaf runtime service handles a single fast SMC function ID without access
+ * to the saved CPU context. smc_handler64 only preserves the registers that
+ * the handler may corrupt under the AAPCS64 and returns directly with an ERET,
+ * so a leaf handler:
+ *
+ * - receives the function ID, x1 to x3 as passed by the caller and the flags;
+ * - returns its results in x0 and x1 through 'rt_svc_leaf_ret_t'. x2 and x3
+ *   are returned to the caller unchanged;
+ * - must not switch the security state, access the context through
+ *   cm_get_context() or modify ELR_EL3, SPSR_EL3 and SCR_EL3.
+ *
+ * Leaf descriptors are only used when SMC_LEAF_FAST_PATH is enabled. The same
+ * function ID must still be handled by the owning runtime service so that it
+ * keeps working when the fast path is disabled.
+ */
+typedef struct rt_svc_leaf_ret {
+	u_register_t x0;
+	u_register_t x1;
+} rt_svc_leaf_ret_t;
+
+typedef rt_svc_leaf_ret_t (*rt_svc_leaf_handle_t)(uint32_t smc_fid,
+						  u_register_t x1,
+						  u_register_t x2,
+						  u_register_t x3,
+						  u_register_t flags);
+typedef struct rt_svc_leaf_desc {
+	uint32_t smc_fid;
+	rt_svc_leaf_handle_t handle;
+	const char *name;
+} rt_svc_leaf_desc_t;
+
+#if SMC_LEAF_FAST_PATH
+#define DECLARE_RT_SVC_LEAF(_name, _fid, _smch)				\
+	static const rt_svc_leaf_desc_t __svc_leaf_desc_ ## _name	\
+		__section("rt_svc_leaf_descs") __used = {		\
+			.smc_fid = (_fid),				\
+			.handle = (_smch),				\
+			.name = #_name					\
+		}
+#else
+#define DECLARE_RT_SVC_LEAF(_name, _fid, _smch)
+#endif
+
 /*
  * Compile time assertions related to the 'rt_svc_desc' structure to:
  * 1. ensure that the assembler and the compiler view of the size
@@ -97,6 +153,16 @@ CASSERT(RT_SVC_DESC_INIT == __builtin_offsetof(rt_svc_desc_t, init), \
 CASSERT(RT_SVC_DESC_HANDLE == __builtin_offsetof(rt_svc_desc_t, handle), \
 	assert_rt_svc_desc_handle_offset_mismatch);
 
+/*
+ * Compile time assertions related to the 'rt_svc_leaf_desc' structure, which
+ * is walked by smc_handler64 before the full context save.
+ */
+CASSERT((sizeof(rt_svc_leaf_desc_t) == SIZEOF_RT_SVC_LEAF_DESC), \
+	assert_sizeof_rt_svc_leaf_desc_mismatch);
+CASSERT(RT_SVC_LEAF_DESC_HANDLE == \
+	__builtin_offsetof(rt_svc_leaf_desc_t, handle), \
+	assert_rt_svc_leaf_desc_handle_offset_mismatch);
+
 
 /*
  * This function combines the call type and the owning entity number
@@ -130,6 +196,10 @@ uintptr_t handle_runtime_svc(uint32_t smc_fid, void *cookie, void *handle,
 						unsigned int flags);
 IMPORT_SYM(uintptr_t, __RT_SVC_DESCS_START__,		RT_SVC_DESCS_START);
 IMPORT_SYM(uintptr_t, __RT_SVC_DESCS_END__,		RT_SVC_DESCS_END);
+#if SMC_LEAF_FAST_PATH
+IMPORT_SYM(uintptr_t, __RT_SVC_LEAF_DESCS_START__,	RT_SVC_LEAF_DESCS_START);
+IMPORT_SYM(uintptr_t, __RT_SVC_LEAF_DESCS_END__,	RT_SVC_LEAF_DESCS_END);
+#endif
 void init_crash_reporting(void);
 
 extern uint8_t rt_svc_descs_indices[MAX_RT_SVCS];
@@ -305,9 +305,27 @@ static inline void gicv3_end_of_interrupt(unsigned int id)
  * specific information. If this not the case, the platform port must provide a
  * hash function. Otherwise, the "Processor Number" field will be used to access
  * the array elements.
+ *
+ * The 'spi_ctx_ranges' field is an optional pointer to an array of SPI ranges
+ * that the Normal world may configure. The Distributor state of SPIs configured
+ * by the Normal world cannot be tracked by EL3, so these ranges must cover every
+ * SPI whose configuration has to survive system suspend. When this field is
+ * set, gicv3_distif_save() only saves the blocks of 32 SPIs overlapping these
+ * ranges, those holding interrupts configured by EL3 and those holding an
+ * enabled, pending or active interrupt. gicv3_distif_init_restore() doesn't
+ * write the other SPIs, which keep whatever state the Distributor retained.
+ * When NULL, all SPIs are saved.
+ *
+ * The 'spi_ctx_ranges_num' field contains the number of entries in the
+ * 'spi_ctx_ranges' array.
  ******************************************************************************/
 typedef unsigned int (*mpidr_hash_fn)(u_register_t mpidr);
 
+typedef struct gicv3_spi_range {
+	unsigned int base;
+	unsigned int num;
+} gicv3_spi_range_t;
+
 typedef struct gicv3_driver_data {
 	uintptr_t gicd_base;
 	uintptr_t gicr_base;
@@ -316,6 +334,8 @@ typedef struct gicv3_driver_data {
 	unsigned int rdistif_num;
 	uintptr_t *rdistif_base_addrs;
 	mpidr_hash_fn mpidr_to_core_pos;
+	const gicv3_spi_range_t *spi_ctx_ranges;
+	unsigned int spi_ctx_ranges_num;
 } gicv3_driver_data_t;
 
 typedef struct gicv3_redist_ctx {
@@ -342,6 +362,8 @@ typedef struct gicv3_dist_ctx {
 
 	/* 32 bits registers */
 	uint32_t gicd_ctlr;
+	/* Bitmap of the blocks of 32 SPIs held in this context */
+	uint32_t gicd_spi_blocks;
 	uint32_t gicd_igroupr[GICD_NUM_REGS(IGROUPR)];
 	uint32_t gicd_isenabler[GICD_NUM_REGS(ISENABLER)];
 	uint32_t gicd_ispendr[GICD_NUM_REGS(ISPENDR)];
@@ -387,6 +409,8 @@ void gicv3_distif_save(gicv3_dist_ctx_t * const dist_ctx);
 void gicv3_distif_post_restore(unsigned int proc_num);
 void gicv3_distif_pre_save(unsigned int proc_num);
 void gicv3_rdistif_init_restore(unsigned int proc_num, const gicv3_redist_ctx_t * const rdist_ctx);
+void gicv3_rdistif_init_restore_all(const gicv3_redist_ctx_t * const rdist_ctx,
+				    unsigned int rdist_num);
 void gicv3_rdistif_save(unsigned int proc_num, gicv3_redist_ctx_t * const rdist_ctx);
 void gicv3_its_save_disable(uintptr_t gits_base, gicv3_its_ctx_t * const its_ctx);
 void gicv3_its_restore(uintptr_t gits_base, const gicv3_its_ctx_t * const its_ctx);
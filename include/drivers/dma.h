@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef DMA_H
+#define DMA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/********************************************************************
+ * A generic memory copy and fill interface that offloads the work to
+ * a DMA engine registered with dma_init(). The CPU does the work
+ * instead when no engine is registered, when the engine is busy with
+ * another transfer, or when it can't handle a transfer.
+ *
+ * A transfer started with dma_memcpy_start() or dma_memset_start()
+ * proceeds while the CPU does other work, and must be completed with
+ * dma_wait(). The engine runs one transfer at a time: a CPU that
+ * finds it busy does its transfer itself. Each dma_req_t belongs to
+ * the CPU that started the transfer.
+ ********************************************************************/
+
+typedef struct dma_ops {
+	/*
+	 * Start a copy of 'len' bytes from 'src' to 'dst'. Return 0 if the
+	 * transfer has started, -ENOTSUP if the engine can't handle it
+	 * (alignment, size, address range), or another negative error.
+	 */
+	int (*copy_start)(uintptr_t dst, uintptr_t src, size_t len);
+
+	/* Same as copy_start, filling 'len' bytes with 'val'. Optional. */
+	int (*fill_start)(uintptr_t dst, int val, size_t len);
+
+	/* Wait for the transfer started last. Return 0 if it succeeded. */
+	int (*wait)(void);
+
+	/* Transfers smaller than this are done by the CPU */
+	size_t min_size;
+
+	/* Whether the engine snoops the CPU data caches */
+	bool coherent;
+} dma_ops_t;
+
+/* State of a transfer, from dma_*_start() to dma_wait() */
+typedef struct dma_req {
+	uintptr_t dst;
+	size_t len;
+	int result;
+	bool offloaded;
+} dma_req_t;
+
+/* Engine that does the work on the CPU, e.g. to test the users */
+extern const dma_ops_t dma_sw_ops;
+
+void dma_init(const dma_ops_t *ops_ptr);
+int dma_memcpy_start(dma_req_t *req, void *dst, const void *src, size_t len);
+int dma_memset_start(dma_req_t *req, void *dst, int val, size_t len);
+int dma_wait(dma_req_t *req);
+int dma_memcpy(void *dst, const void *src, size_t len);
+int dma_memset(void *dst, int val, size_t len);
+
+#endif /* DMA_H */
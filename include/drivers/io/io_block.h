@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -13,16 +13,33 @@
 typedef struct io_block_ops {
 	size_t	(*read)(int lba, uintptr_t buf, size_t size);
 	size_t	(*write)(int lba, const uintptr_t buf, size_t size);
+	/*
+	 * Optional split-phase read: start a read, then wait for it and return
+	 * the number of bytes read. Only one read can be in progress.
+	 */
+	int	(*read_start)(int lba, uintptr_t buf, size_t size);
+	size_t	(*read_wait)(void);
 } io_block_ops_t;
 
 typedef struct io_block_dev_spec {
 	io_block_spec_t	buffer;
 	io_block_ops_t	ops;
 	size_t		block_size;
+	/* Optional memory for the block cache, disabled if length is 0 */
+	io_block_spec_t	cache;
 } io_block_dev_spec_t;
 
+typedef struct io_block_cache_stats {
+	unsigned int	hits;
+	unsigned int	misses;
+	/* Lines read ahead of a sequential access on a miss */
+	unsigned int	read_ahead;
+} io_block_cache_stats_t;
+
 struct io_dev_connector;
 
 int register_io_dev_block(const struct io_dev_connector **dev_con);
+int io_block_get_cache_stats(uintptr_t dev_handle,
+			     io_block_cache_stats_t *stats);
 
 #endif /* IO_BLOCK_H */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2014-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -16,6 +16,10 @@
 typedef struct io_entity {
 	struct io_dev_info *dev_handle;
 	uintptr_t info;
+	/* Result of a read started by io_read_start() on a driver without
+	 * split-phase read support */
+	int read_result;
+	size_t read_length;
 } io_entity_t;
 
 
@@ -43,6 +47,9 @@ typedef struct io_dev_funcs {
 	int (*size)(io_entity_t *entity, size_t *length);
 	int (*read)(io_entity_t *entity, uintptr_t buffer, size_t length,
 			size_t *length_read);
+	int (*read_start)(io_entity_t *entity, uintptr_t buffer,
+			size_t length);
+	int (*read_wait)(io_entity_t *entity, size_t *length_read);
 	int (*write)(io_entity_t *entity, const uintptr_t buffer,
 			size_t length, size_t *length_written);
 	int (*close)(io_entity_t *entity);
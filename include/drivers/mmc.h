@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2018-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -125,6 +125,16 @@ struct mmc_ops {
 	int (*prepare)(int lba, uintptr_t buf, size_t size);
 	int (*read)(int lba, uintptr_t buf, size_t size);
 	int (*write)(int lba, const uintptr_t buf, size_t size);
+	/*
+	 * Optional. Return 0 once the data of the last read command has been
+	 * transferred, -EAGAIN while it is in progress.
+	 */
+	int (*read_poll)(void);
+	/*
+	 * Optional. Drop the state of a read that failed or timed out in
+	 * read_poll(), e.g. reset the FIFO and the DMA of the controller.
+	 */
+	void (*read_abort)(void);
 };
 
 struct mmc_csd_emmc {
@@ -224,6 +234,8 @@ struct mmc_device_info {
 };
 
 size_t mmc_read_blocks(int lba, uintptr_t buf, size_t size);
+int mmc_read_blocks_start(int lba, uintptr_t buf, size_t size);
+size_t mmc_read_blocks_wait(void);
 size_t mmc_write_blocks(int lba, const uintptr_t buf, size_t size);
 size_t mmc_erase_blocks(int lba, size_t size);
 size_t mmc_rpmb_read_blocks(int lba, uintptr_t buf, size_t size);
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -7,6 +7,9 @@
 #ifndef GPT_H
 #define GPT_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <drivers/partition/partition.h>
 
 #define PARTITION_TYPE_GPT		0xee
@@ -47,5 +50,6 @@ typedef struct gpt_header {
 } gpt_header_t;
 
 int parse_gpt_entry(gpt_entry_t *gpt_entry, partition_entry_t *entry);
+uint32_t gpt_crc32(uint32_t crc, const void *buf, size_t size);
 
 #endif /* GPT_H */
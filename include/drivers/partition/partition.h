@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -19,6 +19,14 @@ CASSERT(PLAT_PARTITION_MAX_ENTRIES <= 128, assert_plat_partition_max_entries);
 
 #define PARTITION_BLOCK_SIZE		512
 
+/* Size of each read of the GPT entry array */
+#if !PLAT_PARTITION_READ_SIZE
+# define PLAT_PARTITION_READ_SIZE	(4 * PARTITION_BLOCK_SIZE)
+#endif	/* PLAT_PARTITION_READ_SIZE */
+
+CASSERT((PLAT_PARTITION_READ_SIZE % PARTITION_BLOCK_SIZE) == 0,
+	assert_plat_partition_read_size);
+
 #define EFI_NAMELEN			36
 
 typedef struct partition_entry {
@@ -166,9 +166,12 @@ struct stm32mp1_ddr_config {
 	struct stm32mp1_ddrphy_reg p_reg;
 	struct stm32mp1_ddrphy_timing p_timing;
 	struct stm32mp1_ddrphy_cal p_cal;
+	bool p_cal_present;	/* p_cal holds trained values, skip training */
 };
 
 int stm32mp1_ddr_clk_enable(struct ddr_info *priv, uint32_t mem_speed);
 void stm32mp1_ddr_init(struct ddr_info *priv,
 		       struct stm32mp1_ddr_config *config);
+void stm32mp1_ddr_get_cal(struct ddr_info *priv,
+			  struct stm32mp1_ddrphy_cal *cal);
 #endif /* STM32MP1_DDR_H */
@@ -0,0 +1,23 @@
+/*
+ * Copyright (C) 2019, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: GPL-2.0+ OR BSD-3-Clause
+ */
+
+#ifndef STM32MP1_DDR_CAL_H
+#define STM32MP1_DDR_CAL_H
+
+#include <stdbool.h>
+
+#include <drivers/st/stm32mp1_ddr.h>
+
+/*
+ * Save and restore of the DDR training results in the TAMP backup registers.
+ * The RTCAPB clock must be enabled by the caller.
+ */
+bool stm32mp1_ddr_cal_load(struct stm32mp1_ddr_config *config);
+void stm32mp1_ddr_cal_save(const struct stm32mp1_ddr_config *config,
+			   const struct stm32mp1_ddrphy_cal *cal);
+void stm32mp1_ddr_cal_invalidate(void);
+
+#endif /* STM32MP1_DDR_CAL_H */
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef EL3_TRACE_H
+#define EL3_TRACE_H
+
+#include <lib/utils_def.h>
+#include <tools_share/el3_trace_format.h>
+
+/*
+ * Defines for EL3 trace SMC function ids.
+ */
+#define EL3_TRACE_SMC_GET_BUF_64	U(0xC2000030)
+#define EL3_TRACE_SMC_CTRL_32		U(0x82000031)
+#define EL3_TRACE_NUM_SMC_CALLS		2
+
+/*
+ * The macros below are used to identify EL3 trace calls from the SMC function
+ * ID.
+ */
+#define EL3_TRACE_FID_MASK	U(0xfff0)
+#define EL3_TRACE_FID_VALUE	U(0x30)
+#define is_el3_trace_fid(_fid)	\
+	(((_fid) & EL3_TRACE_FID_MASK) == EL3_TRACE_FID_VALUE)
+
+/* Arguments to EL3_TRACE_SMC_CTRL_32 */
+#define EL3_TRACE_CTRL_DISABLE	U(0)
+#define EL3_TRACE_CTRL_ENABLE	U(1)
+#define EL3_TRACE_CTRL_RESET	U(2)
+
+/* Error codes returned by EL3 trace SMC calls */
+#define EL3_TRACE_E_INVALID_PARAMS	-2
+#define EL3_TRACE_E_DENIED		-3
+
+#ifndef __ASSEMBLY__
+
+#include <stdint.h>
+
+#if ENABLE_EL3_TRACE
+/*
+ * Tracepoint macros. When ENABLE_EL3_TRACE is 0 they expand to nothing and the
+ * arguments are not evaluated.
+ */
+#define EL3_TRACE0(_ev)						\
+	el3_trace_record((_ev), 0U, 0U, 0U, 0U, 0U)
+#define EL3_TRACE1(_ev, _a0)					\
+	el3_trace_record((_ev), 1U, (uint64_t)(_a0), 0U, 0U, 0U)
+#define EL3_TRACE2(_ev, _a0, _a1)				\
+	el3_trace_record((_ev), 2U, (uint64_t)(_a0),		\
+			(uint64_t)(_a1), 0U, 0U)
+#define EL3_TRACE3(_ev, _a0, _a1, _a2)				\
+	el3_trace_record((_ev), 3U, (uint64_t)(_a0),		\
+			(uint64_t)(_a1), (uint64_t)(_a2), 0U)
+#define EL3_TRACE4(_ev, _a0, _a1, _a2, _a3)			\
+	el3_trace_record((_ev), 4U, (uint64_t)(_a0),		\
+			(uint64_t)(_a1), (uint64_t)(_a2), (uint64_t)(_a3))
+#else
+#define EL3_TRACE0(_ev)
+#define EL3_TRACE1(_ev, _a0)
+#define EL3_TRACE2(_ev, _a0, _a1)
+#define EL3_TRACE3(_ev, _a0, _a1, _a2)
+#define EL3_TRACE4(_ev, _a0, _a1, _a2, _a3)
+#endif /* ENABLE_EL3_TRACE */
+
+/*******************************************************************************
+ * Function & variable prototypes
+ ******************************************************************************/
+void el3_trace_init(void);
+void el3_trace_record(unsigned int event, unsigned int nargs, uint64_t a0,
+		uint64_t a1, uint64_t a2, uint64_t a3);
+void el3_trace_smc_entry(u_register_t smc_fid, u_register_t x1,
+		u_register_t x2, u_register_t x3, u_register_t flags);
+void el3_trace_smc_exit(u_register_t smc_fid, void *handle);
+uintptr_t el3_trace_smc_handler(unsigned int smc_fid,
+		u_register_t x1,
+		u_register_t x2,
+		u_register_t x3,
+		u_register_t x4,
+		void *cookie,
+		void *handle,
+		u_register_t flags);
+
+#endif /* __ASSEMBLY__ */
+
+#endif /* EL3_TRACE_H */
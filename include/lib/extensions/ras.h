@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2018-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -7,8 +7,30 @@
 #ifndef RAS_H
 #define RAS_H
 
+#include <lib/utils_def.h>
+
 #define ERR_HANDLER_VERSION	1U
 
+/*
+ * Defines for RAS SMC function ids, part of the Arm SiP service.
+ */
+#define RAS_SMC_GET_STATS_64	U(0xC2000040)
+#define RAS_NUM_SMC_CALLS	1
+
+/*
+ * The macros below are used to identify RAS calls from the SMC function ID.
+ */
+#define RAS_FID_MASK		U(0xfff0)
+#define RAS_FID_VALUE		U(0x40)
+#define is_ras_fid(_fid)	\
+	(((_fid) & RAS_FID_MASK) == RAS_FID_VALUE)
+
+/* Argument to RAS_SMC_GET_STATS_64 requesting the sum over all CPUs */
+#define RAS_STATS_ALL_CPUS	U(0xffffffff)
+
+/* Error codes returned by RAS SMC calls */
+#define RAS_E_INVALID_PARAMS	-2
+
 /* Error record access mechanism */
 #define ERR_ACCESS_SYSREG	0
 #define ERR_ACCESS_MEMMAP	1
@@ -71,6 +93,7 @@
 #ifndef __ASSEMBLY__
 
 #include <assert.h>
+#include <stdint.h>
 
 #include <lib/extensions/ras_arch.h>
 
@@ -170,31 +193,41 @@ extern const struct err_record_mapping err_record_mappings;
 extern const struct ras_interrupt_mapping ras_interrupt_mappings;
 
 
-/*
- * Helper functions to probe memory-mapped and system registers implemented in
- * Standard Error Record format
- */
-static inline int ras_err_ser_probe_memmap(const struct err_record_info *info,
-		int *probe_data)
-{
-	assert(info->version == ERR_HANDLER_VERSION);
+/* Per-CPU RAS error handling statistics */
+struct ras_stats {
+	/* External Aborts and RAS interrupts taken */
+	uint64_t notifications;
 
-	return ser_probe_memmap(info->memmap.base_addr, info->memmap.size_num_k,
-		probe_data);
-}
+	/* Errors passed on to the error record group handlers */
+	uint64_t errors_handled;
 
-static inline int ras_err_ser_probe_sysreg(const struct err_record_info *info,
-		int *probe_data)
-{
-	assert(info->version == ERR_HANDLER_VERSION);
+	/* Corrected errors cleared without calling the handler */
+	uint64_t ce_throttled;
+};
 
-	return ser_probe_sysreg(info->sysreg.idx_start, info->sysreg.num_idx,
-			probe_data);
-}
+/*
+ * Helper functions to probe memory-mapped and system registers implemented in
+ * Standard Error Record format. The RAS framework recognises record groups
+ * using these helpers as Standard Error Records, which allows it to rate-limit
+ * the handling of corrected errors in them.
+ */
+int ras_err_ser_probe_memmap(const struct err_record_info *info,
+		int *probe_data);
+int ras_err_ser_probe_sysreg(const struct err_record_info *info,
+		int *probe_data);
 
 int ras_ea_handler(unsigned int ea_reason, uint64_t syndrome, void *cookie,
 		void *handle, uint64_t flags);
 void ras_init(void);
+void ras_get_stats(unsigned int cpu, struct ras_stats *stats);
+uintptr_t ras_smc_handler(unsigned int smc_fid,
+		u_register_t x1,
+		u_register_t x2,
+		u_register_t x3,
+		u_register_t x4,
+		void *cookie,
+		void *handle,
+		u_register_t flags);
 
 #endif /* __ASSEMBLY__ */
 
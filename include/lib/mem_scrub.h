@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef MEM_SCRUB_H
+#define MEM_SCRUB_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <lib/spinlock.h>
+
+/*
+ * Scrubbing of a Non-secure memory region: the region is zeroed and cleaned to
+ * the PoC in chunks of a fixed size. The work can be spread over several calls
+ * to mem_scrub_run(), each bounded in time, so that a large region doesn't keep
+ * the CPU in EL3 for the whole scrub. Several CPUs may call mem_scrub_run() on
+ * the same scrub at the same time, each chunk is scrubbed by one of them.
+ */
+typedef struct mem_scrub {
+	spinlock_t lock;
+
+	uintptr_t base;
+	unsigned long long size;
+	size_t chunk_size;
+
+	/* Offset of the first chunk not handed out to a CPU yet */
+	unsigned long long next;
+
+	/* Number of bytes scrubbed so far */
+	unsigned long long done;
+
+	/* System counter ticks spent scrubbing, summed over all CPUs */
+	uint64_t busy_cnt;
+
+	/* System counter value when the scrub started */
+	uint64_t start_cnt;
+} mem_scrub_t;
+
+int mem_scrub_init(mem_scrub_t *scrub, uintptr_t base,
+		   unsigned long long size, size_t chunk_size);
+int mem_scrub_run(mem_scrub_t *scrub, unsigned int budget_us);
+void mem_scrub_get_progress(mem_scrub_t *scrub, unsigned long long *done,
+			    unsigned long long *size);
+
+#endif /* MEM_SCRUB_H */
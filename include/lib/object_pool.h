@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2018-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -10,6 +10,7 @@
 #include <stdlib.h>
 
 #include <common/debug.h>
+#include <lib/spinlock.h>
 #include <lib/utils_def.h>
 
 /*
@@ -76,4 +77,117 @@ static inline void *pool_alloc(struct object_pool *pool)
 	return pool_alloc_n(pool, 1U);
 }
 
+/*
+ * Pool of statically allocated objects that can be freed.
+ *
+ * Unlike 'struct object_pool', objects are allocated one at a time and can be
+ * given back to the pool. Freed objects are kept in a list linked through the
+ * first pointer-sized word of the objects, so both operations are O(1). The
+ * objects must be at least the size of a pointer and suitably aligned for
+ * one. Objects that have never been allocated are taken from the back store
+ * in order, so the pool doesn't need any initialization.
+ *
+ * Optionally, each CPU caches up to 'mag_size' free objects in a magazine that
+ * it uses without taking the pool lock. An empty magazine is refilled with half
+ * of its size from the pool and a full one gives half of its objects back, so
+ * the lock is taken once every 'mag_size / 2' operations at most. The objects
+ * cached by a CPU can't be allocated by the other CPUs, so the back store must
+ * be sized for them. The magazines are only safe to use with interrupts masked,
+ * as it is the case in BL31.
+ */
+struct object_free_pool {
+	/* Size of 1 object in the pool in byte unit. */
+	const size_t obj_size;
+
+	/* Number of objects in the pool. */
+	const size_t capacity;
+
+	/* Objects back store. */
+	void *const objects;
+
+	/* Per-CPU magazines, NULL if the pool doesn't have any. */
+	void **const mag_objs;
+	unsigned int *const mag_count;
+	const unsigned int mag_size;
+
+	spinlock_t lock;
+
+	/* List of freed objects. */
+	void *free_list;
+
+	/* How many objects have been taken from the back store. */
+	size_t carved;
+
+	/* How many objects are out of the pool, allocated or in a magazine. */
+	size_t out;
+
+	/* Statistics. */
+	size_t high_water;
+	unsigned int failures;
+};
+
+struct object_pool_stats {
+	size_t capacity;
+
+	/* How many objects are currently allocated. */
+	size_t used;
+
+	/*
+	 * Highest number of objects out of the pool at the same time. With
+	 * magazines, this includes the objects they cache, so it is an upper
+	 * bound of the highest number of allocated objects.
+	 */
+	size_t high_water;
+
+	/* How many allocations failed because the pool was empty. */
+	unsigned int failures;
+};
+
+/* Create a static pool of objects that can be freed. */
+#define OBJECT_FREE_POOL(_pool_name, _obj_backstore, _obj_size, _obj_count) \
+	struct object_free_pool _pool_name = {				\
+		.objects = (_obj_backstore),				\
+		.obj_size = (_obj_size),				\
+		.capacity = (_obj_count),				\
+	}
+
+/*
+ * Create a static pool of objects that can be freed out of an array of
+ * pre-allocated objects.
+ */
+#define OBJECT_FREE_POOL_ARRAY(_pool_name, _obj_array)			\
+	OBJECT_FREE_POOL(_pool_name, (_obj_array),			\
+		sizeof((_obj_array)[0]), ARRAY_SIZE(_obj_array))
+
+/*
+ * Same as OBJECT_FREE_POOL_ARRAY with a magazine of '_mag_size' objects per
+ * CPU. The pool and its magazines are always static. The caller must include
+ * platform_def.h for PLATFORM_CORE_COUNT.
+ */
+#define OBJECT_FREE_POOL_ARRAY_PERCPU(_pool_name, _obj_array, _mag_size) \
+	static void *_pool_name##_mag_objs				\
+		[PLATFORM_CORE_COUNT * (_mag_size)];			\
+	static unsigned int _pool_name##_mag_count[PLATFORM_CORE_COUNT]; \
+	static struct object_free_pool _pool_name = {			\
+		.objects = (_obj_array),				\
+		.obj_size = sizeof((_obj_array)[0]),			\
+		.capacity = ARRAY_SIZE(_obj_array),			\
+		.mag_objs = _pool_name##_mag_objs,			\
+		.mag_count = _pool_name##_mag_count,			\
+		.mag_size = (_mag_size),				\
+	}
+
+/*
+ * Allocate 1 object from a pool that can be freed.
+ * Return the address of the object, or NULL if the pool is empty.
+ */
+void *pool_obj_alloc(struct object_free_pool *pool);
+
+/* Give an object allocated with pool_obj_alloc() back to its pool. */
+void pool_obj_free(struct object_free_pool *pool, void *obj);
+
+/* Get the occupancy statistics of a pool that can be freed. */
+void pool_get_stats(struct object_free_pool *pool,
+		    struct object_pool_stats *stats);
+
 #endif /* OBJECT_POOL_H */
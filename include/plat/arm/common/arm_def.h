@@ -143,6 +143,16 @@
 #define ARM_NS_DRAM1_END		(ARM_NS_DRAM1_BASE +		\
 					 ARM_NS_DRAM1_SIZE - 1)
 
+#if ENABLE_EL3_TRACE
+/*
+ * The top 2MB of NS DRAM1 hold the EL3 trace buffer shared with the Normal
+ * world. The Normal world must reserve this region.
+ */
+#define PLAT_EL3_TRACE_BUF_SIZE		ULL(0x00200000)
+#define PLAT_EL3_TRACE_BUF_BASE		(ARM_NS_DRAM1_END + 1ULL -	\
+					 PLAT_EL3_TRACE_BUF_SIZE)
+#endif
+
 #define ARM_DRAM1_BASE			ULL(0x80000000)
 #define ARM_DRAM1_SIZE			ULL(0x80000000)
 #define ARM_DRAM1_END			(ARM_DRAM1_BASE +		\
@@ -201,6 +211,13 @@
 						ARM_NS_DRAM1_SIZE,	\
 						MT_MEMORY | MT_RW | MT_NS)
 
+#if ENABLE_EL3_TRACE
+#define ARM_MAP_EL3_TRACE_BUF		MAP_REGION_FLAT(		\
+						PLAT_EL3_TRACE_BUF_BASE, \
+						PLAT_EL3_TRACE_BUF_SIZE, \
+						MT_MEMORY | MT_RW | MT_NS)
+#endif
+
 #define ARM_MAP_DRAM2			MAP_REGION_FLAT(		\
 						ARM_DRAM2_BASE,		\
 						ARM_DRAM2_SIZE,		\
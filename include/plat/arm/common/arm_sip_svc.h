@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -19,6 +19,14 @@
 /* Function ID for requesting state switch of lower EL */
 #define ARM_SIP_SVC_EXE_STATE_SWITCH	U(0x82000020)
 
+/*
+ * Function IDs that do nothing, used to measure the SMC round trip latency of
+ * the regular and leaf dispatch paths. Only present when SMC_LEAF_FAST_PATH is
+ * enabled.
+ */
+#define ARM_SIP_SVC_BENCH_NOP		U(0x82000021)
+#define ARM_SIP_SVC_BENCH_NOP_LEAF	U(0x82000022)
+
 /* ARM SiP Service Calls version numbers */
 #define ARM_SIP_SVC_VERSION_MAJOR		U(0x0)
 #define ARM_SIP_SVC_VERSION_MINOR		U(0x2)
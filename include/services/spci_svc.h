@@ -64,6 +64,7 @@
 #define SPCI_FID_SERVICE_REQUEST_START		U(0x8)
 #define SPCI_FID_SERVICE_GET_RESPONSE		U(0x9)
 #define SPCI_FID_SERVICE_RESET_CLIENT_STATE	U(0xA)
+#define SPCI_FID_SERVICE_GET_WAIT_STATS		U(0xB)
 
 /* SPCI tunneling functions */
 
@@ -101,6 +102,14 @@
 #define SPCI_SERVICE_RESET_CLIENT_STATE_AARCH32	SPCI_MISC_32(SPCI_FID_SERVICE_RESET_CLIENT_STATE)
 #define SPCI_SERVICE_RESET_CLIENT_STATE_AARCH64	SPCI_MISC_64(SPCI_FID_SERVICE_RESET_CLIENT_STATE)
 
+/*
+ * Implementation defined. Takes the handle and client ID in w1, as
+ * SPCI_SERVICE_HANDLE_CLOSE does, and returns in w1 and w2 how many times CPUs
+ * waited for the Secure Partition of the handle, and the largest number of
+ * CPUs waiting at a time.
+ */
+#define SPCI_SERVICE_GET_WAIT_STATS		SPCI_MISC_32(SPCI_FID_SERVICE_GET_WAIT_STATS)
+
 #define SPCI_SERVICE_TUN_REQUEST_START_AARCH32	SPCI_TUN_32(SPCI_FID_SERVICE_TUN_REQUEST_START)
 #define SPCI_SERVICE_TUN_REQUEST_START_AARCH64	SPCI_TUN_64(SPCI_FID_SERVICE_TUN_REQUEST_START)
 
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef EL3_TRACE_FORMAT_H
+#define EL3_TRACE_FORMAT_H
+
+#include <stdint.h>
+
+/*
+ * Binary layout of the EL3 trace buffer shared with the Normal world. This
+ * header is shared between BL31 and the host-side decoder in tools/el3_trace.
+ *
+ * The shared buffer is divided in PLATFORM_CORE_COUNT equally sized slices,
+ * one per CPU. Each slice starts with an 'el3_trace_hdr_t' followed by a ring
+ * of 'num_recs' fixed-size 'el3_trace_rec_t' records. 'write_idx' counts the
+ * total number of records ever written to the slice; the most recent record is
+ * at index ((write_idx - 1) % num_recs).
+ */
+#define EL3_TRACE_MAGIC		0x45335452U	/* "E3TR" */
+#define EL3_TRACE_VERSION	1U
+
+/* Maximum number of arguments carried by a single trace record */
+#define EL3_TRACE_MAX_ARGS	4U
+
+/* Event IDs. Values are part of the ABI with the decoder; never reuse them. */
+/* Only the fid is recorded for the SMCs from and returns to the Secure world */
+#define EL3_TRACE_EV_SMC_ENTRY		0x0001U	/* fid, x1, x2, x3 */
+#define EL3_TRACE_EV_SMC_EXIT		0x0002U	/* fid, x0 */
+#define EL3_TRACE_EV_INTR_ROUTE		0x0010U	/* type, scr_el3.ns */
+#define EL3_TRACE_EV_EHF_ACTIVATE	0x0020U	/* priority, active bits */
+#define EL3_TRACE_EV_EHF_DEACTIVATE	0x0021U	/* priority, active bits */
+#define EL3_TRACE_EV_EHF_INTR		0x0022U	/* raw intr, priority */
+#define EL3_TRACE_EV_PSCI_CPU_ON	0x0030U	/* target mpidr, rc */
+#define EL3_TRACE_EV_PSCI_CPU_ON_FINISH	0x0031U	/* cpu index */
+#define EL3_TRACE_EV_PSCI_CPU_OFF	0x0032U	/* end power level */
+#define EL3_TRACE_EV_PSCI_SUSPEND	0x0033U	/* end power level, pwr down */
+#define EL3_TRACE_EV_PSCI_SUSPEND_FINISH 0x0034U /* cpu index */
+
+/* First event ID available for platform-defined events */
+#define EL3_TRACE_EV_PLAT_BASE		0x8000U
+
+typedef struct el3_trace_rec {
+	/* Value of CNTPCT_EL0 when the record was written */
+	uint64_t timestamp;
+	uint32_t event;
+	uint32_t nargs;
+	uint64_t args[EL3_TRACE_MAX_ARGS];
+} el3_trace_rec_t;
+
+typedef struct el3_trace_hdr {
+	uint32_t magic;
+	uint16_t version;
+	uint16_t rec_size;
+	uint32_t cpu;
+	uint32_t num_recs;
+	uint64_t write_idx;
+	/* Value of CNTFRQ_EL0, to convert timestamps into time */
+	uint64_t cntfrq;
+	uint64_t reserved[4];
+} el3_trace_hdr_t;
+
+#endif /* EL3_TRACE_FORMAT_H */
@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <platform_def.h>
+
+#include <arch_helpers.h>
+#include <common/debug.h>
+#include <common/runtime_svc.h>
+#include <context.h>
+#include <lib/cassert.h>
+#include <lib/el3_trace/el3_trace.h>
+#include <lib/utils.h>
+#include <plat/common/platform.h>
+#include <smccc_helpers.h>
+
+/*
+ * The platform provides a Non-secure memory region, mapped in BL31, in which
+ * the trace records are written. It is split in one slice per CPU.
+ */
+#define EL3_TRACE_SLICE_SIZE	\
+	((PLAT_EL3_TRACE_BUF_SIZE / PLATFORM_CORE_COUNT) &	\
+		~((uint64_t) CACHE_WRITEBACK_GRANULE - 1U))
+
+#define EL3_TRACE_NUM_RECS	\
+	((EL3_TRACE_SLICE_SIZE - sizeof(el3_trace_hdr_t)) /	\
+		sizeof(el3_trace_rec_t))
+
+CASSERT((PLAT_EL3_TRACE_BUF_BASE & (CACHE_WRITEBACK_GRANULE - 1U)) == 0U,
+	assert_el3_trace_buf_base_alignment);
+CASSERT(EL3_TRACE_SLICE_SIZE > (sizeof(el3_trace_hdr_t) +
+	sizeof(el3_trace_rec_t)), assert_el3_trace_buf_size_too_small);
+CASSERT(sizeof(el3_trace_hdr_t) == 64U, assert_el3_trace_hdr_size);
+CASSERT(sizeof(el3_trace_rec_t) == 48U, assert_el3_trace_rec_size);
+
+/*
+ * Global switch for all tracepoints. It is only written by the SMC handler and
+ * during initialisation; tracepoints read it without synchronisation, so a
+ * change takes effect on other CPUs with some delay.
+ */
+static bool el3_trace_enabled;
+
+/*
+ * Per-CPU count of the records started, odd while el3_trace_record() is
+ * writing one. A reset waits for it to be even on all CPUs after tracing has
+ * been disabled, so that no record is written while the slices are cleared.
+ */
+static volatile unsigned int el3_trace_seq[PLATFORM_CORE_COUNT];
+
+/* Memory barrier that the compiler doesn't move memory accesses across */
+static inline void el3_trace_barrier(void)
+{
+	__asm__ volatile("dmb ish" ::: "memory");
+}
+
+static el3_trace_hdr_t *el3_trace_get_hdr(unsigned int cpu)
+{
+	assert(cpu < PLATFORM_CORE_COUNT);
+
+	return (el3_trace_hdr_t *)(PLAT_EL3_TRACE_BUF_BASE +
+			((uintptr_t)cpu * EL3_TRACE_SLICE_SIZE));
+}
+
+static void el3_trace_reset_hdr(unsigned int cpu)
+{
+	el3_trace_hdr_t *hdr = el3_trace_get_hdr(cpu);
+
+	zeromem(hdr, sizeof(*hdr));
+	hdr->version = (uint16_t)EL3_TRACE_VERSION;
+	hdr->rec_size = (uint16_t)sizeof(el3_trace_rec_t);
+	hdr->cpu = cpu;
+	hdr->num_recs = (uint32_t)EL3_TRACE_NUM_RECS;
+	hdr->cntfrq = read_cntfrq_el0();
+
+	/* Publish the magic last so that readers never see a partial header */
+	dmbishst();
+	hdr->magic = EL3_TRACE_MAGIC;
+}
+
+/*
+ * Initialise the headers of all per-CPU slices of the trace buffer and enable
+ * tracing. Called once by the primary CPU during BL31 cold boot.
+ */
+void el3_trace_init(void)
+{
+	unsigned int cpu;
+
+	for (cpu = 0U; cpu < PLATFORM_CORE_COUNT; cpu++)
+		el3_trace_reset_hdr(cpu);
+
+	el3_trace_enabled = true;
+
+	INFO("BL31: EL3 trace: %u records per CPU at 0x%llx\n",
+		(unsigned int)EL3_TRACE_NUM_RECS,
+		(unsigned long long)PLAT_EL3_TRACE_BUF_BASE);
+}
+
+/*
+ * Append a record to the trace ring of the calling CPU. Only the owning CPU
+ * ever writes to its slice, so no locking is required. The write index is
+ * published after the record contents, so that a Normal world reader that
+ * samples 'write_idx' before and after copying the ring can discard records
+ * that were overwritten in between.
+ */
+void el3_trace_record(unsigned int event, unsigned int nargs, uint64_t a0,
+		uint64_t a1, uint64_t a2, uint64_t a3)
+{
+	el3_trace_hdr_t *hdr;
+	el3_trace_rec_t *rec;
+	uint64_t idx;
+	unsigned int cpu;
+
+	if (!el3_trace_enabled)
+		return;
+
+	assert(nargs <= EL3_TRACE_MAX_ARGS);
+
+	cpu = plat_my_core_pos();
+
+	/*
+	 * Mark the record as started before checking the switch again, so that
+	 * a reset either sees the record in progress or this CPU sees tracing
+	 * disabled.
+	 */
+	el3_trace_seq[cpu]++;
+	el3_trace_barrier();
+	if (!el3_trace_enabled) {
+		el3_trace_seq[cpu]++;
+		return;
+	}
+
+	hdr = el3_trace_get_hdr(cpu);
+	idx = hdr->write_idx;
+	rec = (el3_trace_rec_t *)((uintptr_t)hdr + sizeof(el3_trace_hdr_t)) +
+		(idx % EL3_TRACE_NUM_RECS);
+
+	rec->timestamp = read_cntpct_el0();
+	rec->event = event;
+	rec->nargs = nargs;
+	rec->args[0] = a0;
+	rec->args[1] = a1;
+	rec->args[2] = a2;
+	rec->args[3] = a3;
+
+	el3_trace_barrier();
+	hdr->write_idx = idx + 1U;
+
+	el3_trace_barrier();
+	el3_trace_seq[cpu]++;
+}
+
+/* Wait for the records that other CPUs are writing to be complete */
+static void el3_trace_quiesce(void)
+{
+	unsigned int cpu;
+
+	el3_trace_barrier();
+
+	for (cpu = 0U; cpu < PLATFORM_CORE_COUNT; cpu++) {
+		while ((el3_trace_seq[cpu] & 1U) != 0U)
+			;
+	}
+
+	el3_trace_barrier();
+}
+
+/*
+ * Tracepoints for the SMC entry and exit paths. These are called from
+ * smc_handler64 around the invocation of the runtime service handler. The
+ * buffer is in Non-secure memory, so only the function ID is recorded for
+ * calls made by the Secure world and for returns to it.
+ */
+void el3_trace_smc_entry(u_register_t smc_fid, u_register_t x1,
+		u_register_t x2, u_register_t x3, u_register_t flags)
+{
+	if (is_caller_non_secure(flags))
+		EL3_TRACE4(EL3_TRACE_EV_SMC_ENTRY, smc_fid, x1, x2, x3);
+	else
+		EL3_TRACE1(EL3_TRACE_EV_SMC_ENTRY, smc_fid);
+}
+
+void el3_trace_smc_exit(u_register_t smc_fid, void *handle)
+{
+	u_register_t scr;
+
+	if (handle == NULL) {
+		EL3_TRACE1(EL3_TRACE_EV_SMC_EXIT, smc_fid);
+		return;
+	}
+
+	scr = read_ctx_reg(get_el3state_ctx(handle), CTX_SCR_EL3);
+	if ((scr & SCR_NS_BIT) != 0U)
+		EL3_TRACE2(EL3_TRACE_EV_SMC_EXIT, smc_fid,
+			read_ctx_reg(get_gpregs_ctx(handle), CTX_GPREG_X0));
+	else
+		EL3_TRACE1(EL3_TRACE_EV_SMC_EXIT, smc_fid);
+}
+
+/*
+ * This function is responsible for handling all EL3 trace SMC calls.
+ */
+uintptr_t el3_trace_smc_handler(unsigned int smc_fid,
+			u_register_t x1,
+			u_register_t x2,
+			u_register_t x3,
+			u_register_t x4,
+			void *cookie,
+			void *handle,
+			u_register_t flags)
+{
+	unsigned int cpu;
+
+	/* Only the Non-secure world may query or control the trace */
+	if (!is_caller_non_secure(flags))
+		SMC_RET1(handle, SMC_UNK);
+
+	switch (smc_fid) {
+	case EL3_TRACE_SMC_GET_BUF_64:
+		/*
+		 * x0 --> error code.
+		 * x1 --> base of the shared trace buffer.
+		 * x2 --> size of one per-CPU slice.
+		 * x3 --> number of slices.
+		 */
+		SMC_RET4(handle, SMC_OK, PLAT_EL3_TRACE_BUF_BASE,
+			EL3_TRACE_SLICE_SIZE, PLATFORM_CORE_COUNT);
+
+	case EL3_TRACE_SMC_CTRL_32:
+		switch ((uint32_t)x1) {
+		case EL3_TRACE_CTRL_DISABLE:
+			el3_trace_enabled = false;
+			break;
+		case EL3_TRACE_CTRL_ENABLE:
+			el3_trace_enabled = true;
+			break;
+		case EL3_TRACE_CTRL_RESET:
+			/*
+			 * Resetting the slices of other CPUs while they are
+			 * tracing would corrupt them; require tracing to be
+			 * disabled first, and wait for the records that were
+			 * started before it was.
+			 */
+			if (el3_trace_enabled)
+				SMC_RET1(handle, EL3_TRACE_E_DENIED);
+			el3_trace_quiesce();
+			for (cpu = 0U; cpu < PLATFORM_CORE_COUNT; cpu++)
+				el3_trace_reset_hdr(cpu);
+			break;
+		default:
+			SMC_RET1(handle, EL3_TRACE_E_INVALID_PARAMS);
+		}
+		SMC_RET1(handle, SMC_OK);
+
+	default:
+		break;
+	}
+
+	WARN("Unimplemented EL3 trace Call: 0x%x\n", smc_fid);
+	SMC_RET1(handle, SMC_UNK);
+}
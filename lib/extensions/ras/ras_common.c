@@ -1,30 +1,143 @@
 /*
- * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2018-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
 #include <stdbool.h>
 
+#include <platform_def.h>
+
 #include <arch_helpers.h>
 #include <bl31/ea_handle.h>
 #include <bl31/ehf.h>
 #include <common/debug.h>
+#include <common/runtime_svc.h>
 #include <lib/extensions/ras.h>
 #include <lib/extensions/ras_arch.h>
 #include <plat/common/platform.h>
+#include <smccc_helpers.h>
 
 #ifndef PLAT_RAS_PRI
 # error Platform must define RAS priority value
 #endif
 
+/*
+ * Maximum number of corrected errors in Standard Error Records that each CPU
+ * passes on to the error handlers within a window of PLAT_RAS_CE_WINDOW_MS
+ * milliseconds. Further corrected errors in the window are cleared and only
+ * counted. A value of 0 disables the rate limit.
+ */
+#ifndef PLAT_RAS_CE_RATE_LIMIT
+# define PLAT_RAS_CE_RATE_LIMIT		0U
+#endif
+
+#ifndef PLAT_RAS_CE_WINDOW_MS
+# define PLAT_RAS_CE_WINDOW_MS		1000U
+#endif
+
+/* Per-CPU state of the RAS framework */
+struct ras_cpu_data {
+	struct ras_stats stats;
+
+	/* Start of the current corrected error window, in counter ticks */
+	uint64_t ce_window_start;
+	unsigned int ce_window_count;
+
+	/* Index of the error record group last found in error by an EA */
+	unsigned int hot_record;
+
+	/* Index of the RAS interrupt last taken */
+	unsigned int hot_intr;
+};
+
+static struct ras_cpu_data ras_cpu_data[PLATFORM_CORE_COUNT];
+
+static struct ras_cpu_data *ras_my_cpu_data(void)
+{
+	return &ras_cpu_data[plat_my_core_pos()];
+}
+
+/*
+ * Decide whether an error found by probing a Standard Error Record group is a
+ * corrected error beyond the rate limit of the calling CPU. If so, clear the
+ * error record and return true; the error is then not passed on to the group
+ * handler.
+ */
+static bool ras_ce_throttle(const struct err_record_info *info, int probe_data,
+		struct ras_cpu_data *data)
+{
+	uint64_t status, now, window;
+	unsigned int idx = (unsigned int) probe_data;
+
+	if (PLAT_RAS_CE_RATE_LIMIT == 0U)
+		return false;
+
+	if (info->probe == ras_err_ser_probe_memmap) {
+		status = ser_get_status(info->memmap.base_addr, idx);
+	} else if (info->probe == ras_err_ser_probe_sysreg) {
+		ser_sys_select_record(info->sysreg.idx_start + idx);
+		status = read_erxstatus_el1();
+	} else {
+		return false;
+	}
+
+	/* Only throttle records holding nothing but corrected errors */
+	if ((ERR_STATUS_GET_FIELD(status, V) == 0U) ||
+	    (ERR_STATUS_GET_FIELD(status, CE) == 0U) ||
+	    (ERR_STATUS_GET_FIELD(status, UE) != 0U) ||
+	    (ERR_STATUS_GET_FIELD(status, DE) != 0U))
+		return false;
+
+	now = read_cntpct_el0();
+	window = (read_cntfrq_el0() * PLAT_RAS_CE_WINDOW_MS) / 1000U;
+	if ((now - data->ce_window_start) >= window) {
+		data->ce_window_start = now;
+		data->ce_window_count = 0U;
+	}
+
+	data->ce_window_count++;
+	if (data->ce_window_count <= PLAT_RAS_CE_RATE_LIMIT)
+		return false;
+
+	/* Writing back the status clears the recorded error */
+	if (info->access == ERR_ACCESS_MEMMAP)
+		ser_set_status(info->memmap.base_addr, idx, status);
+	else
+		write_erxstatus_el1(status);
+
+	data->stats.ce_throttled++;
+
+	return true;
+}
+
+/*
+ * Pass an error found in a record group on to its handler, unless it's a
+ * corrected error beyond the rate limit. Returns true if the handler was
+ * called, and its return value in 'ret'.
+ */
+static bool ras_handle_error(const struct err_record_info *info,
+		int probe_data, const struct err_handler_data *err_data,
+		struct ras_cpu_data *data, int *ret)
+{
+	if (ras_ce_throttle(info, probe_data, data))
+		return false;
+
+	assert(info->handler != NULL);
+	*ret = info->handler(info, probe_data, err_data);
+	data->stats.errors_handled++;
+
+	return true;
+}
+
 /* Handler that receives External Aborts on RAS-capable systems */
 int ras_ea_handler(unsigned int ea_reason, uint64_t syndrome, void *cookie,
 		void *handle, uint64_t flags)
 {
-	unsigned int i, n_handled = 0;
-	int probe_data, ret;
+	unsigned int i, n, k, n_handled = 0;
+	int probe_data, ret = 0;
 	struct err_record_info *info;
+	struct ras_cpu_data *data = ras_my_cpu_data();
 
 	const struct err_handler_data err_data = {
 		.version = ERR_HANDLER_VERSION,
@@ -36,21 +149,33 @@ int ras_ea_handler(unsigned int ea_reason, uint64_t syndrome, void *cookie,
 		.handle = handle
 	};
 
-	for_each_err_record_info(i, info) {
+	data->stats.notifications++;
+
+	n = (unsigned int) err_record_mappings.num_err_records;
+	if (n == 0U)
+		return 0;
+
+	/*
+	 * Probe all record groups, starting with the one last found in error
+	 * on this CPU: errors tend to come in bursts from the same node.
+	 */
+	i = (data->hot_record < n) ? data->hot_record : 0U;
+	for (k = 0U; k < n; k++, i = ((i + 1U) < n) ? (i + 1U) : 0U) {
+		info = &err_record_mappings.err_records[i];
 		assert(info->probe != NULL);
-		assert(info->handler != NULL);
 
 		/* Continue probing until the record group signals no error */
 		while (true) {
 			if (info->probe(info, &probe_data) == 0)
 				break;
 
+			data->hot_record = i;
+			n_handled++;
+
 			/* Handle error */
-			ret = info->handler(info, probe_data, &err_data);
-			if (ret != 0)
+			if (ras_handle_error(info, probe_data, &err_data, data,
+					&ret) && (ret != 0))
 				return ret;
-
-			n_handled++;
 		}
 	}
 
@@ -83,7 +208,8 @@ static int ras_interrupt_handler(uint32_t intr_raw, uint32_t flags,
 {
 	struct ras_interrupt *ras_inrs = ras_interrupt_mappings.intrs;
 	struct ras_interrupt *selected = NULL;
-	int start, end, mid, probe_data, ret __unused;
+	struct ras_cpu_data *data = ras_my_cpu_data();
+	int start, end, mid, probe_data = 0, ret = 0;
 
 	const struct err_handler_data err_data = {
 		.version = ERR_HANDLER_VERSION,
@@ -95,19 +221,28 @@ static int ras_interrupt_handler(uint32_t intr_raw, uint32_t flags,
 
 	assert(ras_interrupt_mappings.num_intrs > 0UL);
 
-	start = 0;
-	end = (int) ras_interrupt_mappings.num_intrs;
-	while (start <= end) {
-		mid = ((end + start) / 2);
-		if (intr_raw == ras_inrs[mid].intr_number) {
-			selected = &ras_inrs[mid];
-			break;
-		} else if (intr_raw < ras_inrs[mid].intr_number) {
-			/* Move left */
-			end = mid - 1;
-		} else {
-			/* Move right */
-			start = mid + 1;
+	data->stats.notifications++;
+
+	/* Storms usually repeat the same interrupt; check it before bisecting */
+	if ((data->hot_intr < ras_interrupt_mappings.num_intrs) &&
+	    (ras_inrs[data->hot_intr].intr_number == intr_raw)) {
+		selected = &ras_inrs[data->hot_intr];
+	} else {
+		start = 0;
+		end = (int) ras_interrupt_mappings.num_intrs - 1;
+		while (start <= end) {
+			mid = ((end + start) / 2);
+			if (intr_raw == ras_inrs[mid].intr_number) {
+				selected = &ras_inrs[mid];
+				data->hot_intr = (unsigned int) mid;
+				break;
+			} else if (intr_raw < ras_inrs[mid].intr_number) {
+				/* Move left */
+				end = mid - 1;
+			} else {
+				/* Move right */
+				start = mid + 1;
+			}
 		}
 	}
 
@@ -121,14 +256,86 @@ static int ras_interrupt_handler(uint32_t intr_raw, uint32_t flags,
 		assert(ret != 0);
 	}
 
-	/* Call error handler for the record group */
-	assert(selected->err_record->handler != NULL);
-	(void) selected->err_record->handler(selected->err_record, probe_data,
-			&err_data);
+	/*
+	 * Call error handler for the record group. A throttled corrected error
+	 * has already been cleared, which deasserts the interrupt; complete it
+	 * on behalf of the handler.
+	 */
+	if (!ras_handle_error(selected->err_record, probe_data, &err_data,
+			data, &ret))
+		plat_ic_end_of_interrupt(intr_raw);
 
 	return 0;
 }
 
+/*
+ * Return the RAS statistics of a CPU, or their sum over all CPUs if 'cpu' is
+ * RAS_STATS_ALL_CPUS. Counters of other CPUs are read without synchronisation
+ * and may be slightly out of date.
+ */
+void ras_get_stats(unsigned int cpu, struct ras_stats *stats)
+{
+	unsigned int i;
+
+	assert(stats != NULL);
+
+	if (cpu != RAS_STATS_ALL_CPUS) {
+		assert(cpu < PLATFORM_CORE_COUNT);
+		*stats = ras_cpu_data[cpu].stats;
+		return;
+	}
+
+	stats->notifications = 0U;
+	stats->errors_handled = 0U;
+	stats->ce_throttled = 0U;
+	for (i = 0U; i < PLATFORM_CORE_COUNT; i++) {
+		stats->notifications += ras_cpu_data[i].stats.notifications;
+		stats->errors_handled += ras_cpu_data[i].stats.errors_handled;
+		stats->ce_throttled += ras_cpu_data[i].stats.ce_throttled;
+	}
+}
+
+/*
+ * This function is responsible for handling all RAS SMC calls.
+ */
+uintptr_t ras_smc_handler(unsigned int smc_fid,
+		u_register_t x1,
+		u_register_t x2,
+		u_register_t x3,
+		u_register_t x4,
+		void *cookie,
+		void *handle,
+		u_register_t flags)
+{
+	struct ras_stats stats;
+	unsigned int cpu;
+
+	switch (smc_fid) {
+	case RAS_SMC_GET_STATS_64:
+		/*
+		 * x1 --> core position, or RAS_STATS_ALL_CPUS.
+		 *
+		 * x0 --> error code.
+		 * x1 --> number of External Aborts and RAS interrupts.
+		 * x2 --> number of errors passed on to handlers.
+		 * x3 --> number of rate-limited corrected errors.
+		 */
+		cpu = (unsigned int) x1;
+		if ((cpu != RAS_STATS_ALL_CPUS) && (cpu >= PLATFORM_CORE_COUNT))
+			SMC_RET1(handle, RAS_E_INVALID_PARAMS);
+
+		ras_get_stats(cpu, &stats);
+		SMC_RET4(handle, SMC_OK, stats.notifications,
+				stats.errors_handled, stats.ce_throttled);
+
+	default:
+		break;
+	}
+
+	WARN("Unimplemented RAS Call: 0x%x\n", smc_fid);
+	SMC_RET1(handle, SMC_UNK);
+}
+
 void __init ras_init(void)
 {
 #if ENABLE_ASSERTIONS
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdbool.h>
+
+#include <arch_helpers.h>
+#include <common/debug.h>
+#include <drivers/dma.h>
+#include <lib/mem_scrub.h>
+#include <lib/utils.h>
+#include <lib/utils_def.h>
+#include <lib/xlat_tables/xlat_tables_v2.h>
+
+/*
+ * Map the region to scrub in EL3 and prepare to scrub it in chunks of
+ * 'chunk_size' bytes. The region stays mapped until it has been scrubbed
+ * completely. Returns 0 on success, or the error returned by
+ * mmap_add_dynamic_region().
+ *
+ * A scrub may only be initialised again once the previous region has been
+ * scrubbed completely. CPUs that still call mem_scrub_run() on it at that point
+ * see either the previous region, with nothing left to scrub, or the new one.
+ */
+int mem_scrub_init(mem_scrub_t *scrub, uintptr_t base,
+		   unsigned long long size, size_t chunk_size)
+{
+	int ret;
+
+	assert(scrub != NULL);
+	assert(size != 0ULL);
+	assert((chunk_size != 0U) && ((chunk_size & PAGE_SIZE_MASK) == 0U));
+
+	ret = mmap_add_dynamic_region(base, base, size,
+				      MT_NS | MT_RW | MT_EXECUTE_NEVER);
+	if (ret != 0) {
+		return ret;
+	}
+
+	spin_lock(&scrub->lock);
+	assert(scrub->next == scrub->done);
+	scrub->base = base;
+	scrub->size = size;
+	scrub->chunk_size = chunk_size;
+	scrub->next = 0ULL;
+	scrub->done = 0ULL;
+	scrub->busy_cnt = 0ULL;
+	scrub->start_cnt = read_cntpct_el0();
+	spin_unlock(&scrub->lock);
+
+	return 0;
+}
+
+/* Print how long the scrub took once it is complete */
+static void mem_scrub_print_stats(const mem_scrub_t *scrub)
+{
+	uint64_t freq = read_cntfrq_el0();
+	uint64_t elapsed_us = ((read_cntpct_el0() - scrub->start_cnt) *
+			       1000000ULL) / freq;
+	uint64_t busy_us = (scrub->busy_cnt * 1000000ULL) / freq;
+
+	INFO("Scrubbed %llu MB at 0x%lx in %llu us (%llu us busy, %llu MB/s)\n",
+	     scrub->size >> 20, scrub->base, elapsed_us, busy_us,
+	     (busy_us != 0ULL) ? (scrub->size / busy_us) : 0ULL);
+}
+
+/*
+ * Zero one chunk and write it back to memory. With USE_DMA_MEMCPY, the chunk is
+ * zeroed by the DMA engine when it is free, in which case the zeroes go straight
+ * to memory. The CPU zeroes the chunk when the engine is busy with another
+ * chunk, or if the transfer fails.
+ */
+static void mem_scrub_chunk(uintptr_t addr, size_t len)
+{
+#if USE_DMA_MEMCPY
+	dma_req_t req;
+
+	(void)dma_memset_start(&req, (void *)addr, 0, len);
+	if (req.offloaded) {
+		if (dma_wait(&req) == 0) {
+			return;
+		}
+
+		zero_normalmem((void *)addr, len);
+	}
+#else
+	zero_normalmem((void *)addr, len);
+#endif
+	flush_dcache_range(addr, len);
+}
+
+/*
+ * Scrub chunks of the region until it has been scrubbed completely or, if
+ * 'budget_us' isn't 0, until 'budget_us' microseconds have elapsed. A chunk is
+ * always scrubbed completely, so the budget may be exceeded by the time taken
+ * to scrub one chunk.
+ *
+ * Returns 0 if the whole region has been scrubbed, in which case it has been
+ * unmapped, or -EAGAIN if some of it remains to be scrubbed, possibly by other
+ * CPUs.
+ */
+int mem_scrub_run(mem_scrub_t *scrub, unsigned int budget_us)
+{
+	uint64_t start = read_cntpct_el0();
+	uint64_t budget = ((uint64_t)budget_us * read_cntfrq_el0()) / 1000000ULL;
+	uint64_t chunk_start, now;
+	uintptr_t addr;
+	size_t len;
+	bool complete;
+
+	for (;;) {
+		spin_lock(&scrub->lock);
+		if (scrub->next == scrub->size) {
+			complete = (scrub->done == scrub->size);
+			spin_unlock(&scrub->lock);
+			break;
+		}
+		addr = scrub->base + (uintptr_t)scrub->next;
+		len = (size_t)MIN((unsigned long long)scrub->chunk_size,
+				  scrub->size - scrub->next);
+		scrub->next += len;
+		spin_unlock(&scrub->lock);
+
+		chunk_start = read_cntpct_el0();
+		mem_scrub_chunk(addr, len);
+		now = read_cntpct_el0();
+
+		/*
+		 * The last chunk is only accounted for once the region has
+		 * been unmapped, so that no CPU sees the scrub complete
+		 * before that.
+		 */
+		spin_lock(&scrub->lock);
+		scrub->busy_cnt += now - chunk_start;
+		complete = ((scrub->done + len) == scrub->size);
+		if (!complete) {
+			scrub->done += len;
+		}
+		spin_unlock(&scrub->lock);
+
+		if (complete) {
+			(void)mmap_remove_dynamic_region(scrub->base,
+							 scrub->size);
+			mem_scrub_print_stats(scrub);
+
+			spin_lock(&scrub->lock);
+			scrub->done += len;
+			spin_unlock(&scrub->lock);
+			break;
+		}
+
+		if ((budget != 0ULL) && ((now - start) >= budget)) {
+			break;
+		}
+	}
+
+	return complete ? 0 : -EAGAIN;
+}
+
+/* Return the number of bytes scrubbed so far, and the size of the region */
+void mem_scrub_get_progress(mem_scrub_t *scrub, unsigned long long *done,
+			    unsigned long long *size)
+{
+	spin_lock(&scrub->lock);
+	*done = scrub->done;
+	*size = scrub->size;
+	spin_unlock(&scrub->lock);
+}
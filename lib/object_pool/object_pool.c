@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <stdint.h>
+
+#include <platform_def.h>
+
+#include <lib/object_pool.h>
+#include <lib/spinlock.h>
+#include <plat/common/platform.h>
+
+/* Take an object out of the pool. Called with the pool lock held. */
+static void *pool_take(struct object_free_pool *pool)
+{
+	void *obj = pool->free_list;
+
+	if (obj != NULL) {
+		pool->free_list = *(void **)obj;
+	} else if (pool->carved < pool->capacity) {
+		obj = (char *)(pool->objects) + (pool->obj_size * pool->carved);
+		pool->carved++;
+	} else {
+		return NULL;
+	}
+
+	pool->out++;
+	if (pool->out > pool->high_water)
+		pool->high_water = pool->out;
+
+	return obj;
+}
+
+/* Put an object back in the pool. Called with the pool lock held. */
+static void pool_give(struct object_free_pool *pool, void *obj)
+{
+	assert(pool->out > 0U);
+
+	*(void **)obj = pool->free_list;
+	pool->free_list = obj;
+	pool->out--;
+}
+
+void *pool_obj_alloc(struct object_free_pool *pool)
+{
+	unsigned int cpu, *count;
+	void **mag;
+	void *obj;
+
+	assert(pool->obj_size >= sizeof(void *));
+	assert((pool->obj_size % sizeof(void *)) == 0U);
+
+	if (pool->mag_size == 0U) {
+		spin_lock(&pool->lock);
+		obj = pool_take(pool);
+		if (obj == NULL)
+			pool->failures++;
+		spin_unlock(&pool->lock);
+
+		return obj;
+	}
+
+	cpu = plat_my_core_pos();
+	assert(cpu < PLATFORM_CORE_COUNT);
+
+	mag = &pool->mag_objs[cpu * pool->mag_size];
+	count = &pool->mag_count[cpu];
+
+	if (*count == 0U) {
+		spin_lock(&pool->lock);
+		while (*count < ((pool->mag_size + 1U) / 2U)) {
+			obj = pool_take(pool);
+			if (obj == NULL)
+				break;
+			mag[(*count)++] = obj;
+		}
+		if (*count == 0U)
+			pool->failures++;
+		spin_unlock(&pool->lock);
+
+		if (*count == 0U)
+			return NULL;
+	}
+
+	return mag[--(*count)];
+}
+
+void pool_obj_free(struct object_free_pool *pool, void *obj)
+{
+	uintptr_t offset = (uintptr_t)obj - (uintptr_t)pool->objects;
+	unsigned int cpu, *count;
+	void **mag;
+
+	assert(obj != NULL);
+	assert(offset < (pool->obj_size * pool->carved));
+	assert((offset % pool->obj_size) == 0U);
+	(void)offset;
+
+	if (pool->mag_size == 0U) {
+		spin_lock(&pool->lock);
+		pool_give(pool, obj);
+		spin_unlock(&pool->lock);
+
+		return;
+	}
+
+	cpu = plat_my_core_pos();
+	assert(cpu < PLATFORM_CORE_COUNT);
+
+	mag = &pool->mag_objs[cpu * pool->mag_size];
+	count = &pool->mag_count[cpu];
+
+	if (*count == pool->mag_size) {
+		spin_lock(&pool->lock);
+		while (*count > (pool->mag_size / 2U))
+			pool_give(pool, mag[--(*count)]);
+		spin_unlock(&pool->lock);
+	}
+
+	mag[(*count)++] = obj;
+}
+
+void pool_get_stats(struct object_free_pool *pool,
+		    struct object_pool_stats *stats)
+{
+	size_t cached = 0U;
+	unsigned int cpu;
+
+	/* The magazines of other CPUs may change while they are counted. */
+	if (pool->mag_size != 0U) {
+		for (cpu = 0U; cpu < PLATFORM_CORE_COUNT; cpu++)
+			cached += pool->mag_count[cpu];
+	}
+
+	spin_lock(&pool->lock);
+	stats->capacity = pool->capacity;
+	stats->used = (pool->out > cached) ? (pool->out - cached) : 0U;
+	stats->high_water = pool->high_water;
+	stats->failures = pool->failures;
+	spin_unlock(&pool->lock);
+}
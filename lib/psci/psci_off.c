@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -10,6 +10,8 @@
 #include <arch.h>
 #include <arch_helpers.h>
 #include <common/debug.h>
+#include <drivers/console.h>
+#include <lib/el3_trace/el3_trace.h>
 #include <lib/pmf/pmf.h>
 #include <lib/runtime_instr.h>
 #include <plat/common/platform.h>
@@ -52,6 +54,8 @@ int psci_do_cpu_off(unsigned int end_pwrlvl)
 	 */
 	assert(psci_plat_pm_ops->pwr_domain_off != NULL);
 
+	EL3_TRACE1(EL3_TRACE_EV_PSCI_CPU_OFF, end_pwrlvl);
+
 	/* Construct the psci_power_state for CPU_OFF */
 	psci_set_power_off_state(&state_info);
 
@@ -85,6 +89,14 @@ int psci_do_cpu_off(unsigned int end_pwrlvl)
 	psci_stats_update_pwr_down(end_pwrlvl, &state_info);
 #endif
 
+#if CONSOLE_LINE_BUFFER
+	/*
+	 * Write out the line this CPU may have left partly printed, before its
+	 * data cache is turned off.
+	 */
+	(void)console_flush();
+#endif
+
 #if ENABLE_RUNTIME_INSTRUMENTATION
 
 	/*
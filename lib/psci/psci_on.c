@@ -11,6 +11,7 @@
 #include <arch_helpers.h>
 #include <common/bl_common.h>
 #include <common/debug.h>
+#include <lib/el3_trace/el3_trace.h>
 #include <lib/el3_runtime/context_mgmt.h>
 #include <lib/el3_runtime/pubsub_events.h>
 #include <plat/common/platform.h>
@@ -156,6 +157,9 @@ int psci_cpu_on_start(u_register_t target_cpu,
 
 exit:
 	psci_spin_unlock_cpu(target_idx);
+
+	EL3_TRACE2(EL3_TRACE_EV_PSCI_CPU_ON, target_cpu, rc);
+
 	return rc;
 }
 
@@ -181,6 +185,8 @@ void psci_cpu_on_finish(int cpu_idx, const psci_power_state_t *state_info)
 	psci_do_pwrup_cache_maintenance();
 #endif
 
+	EL3_TRACE1(EL3_TRACE_EV_PSCI_CPU_ON_FINISH, cpu_idx);
+
 	/*
 	 * All the platform specific actions for turning this cpu
 	 * on have completed. Perform enough arch.initialization
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -12,9 +12,11 @@
 #include <common/bl_common.h>
 #include <common/debug.h>
 #include <context.h>
+#include <drivers/console.h>
 #include <lib/el3_runtime/context_mgmt.h>
 #include <lib/el3_runtime/cpu_data.h>
 #include <lib/el3_runtime/pubsub_events.h>
+#include <lib/el3_trace/el3_trace.h>
 #include <lib/pmf/pmf.h>
 #include <lib/runtime_instr.h>
 #include <plat/common/platform.h>
@@ -106,6 +108,14 @@ static void psci_suspend_to_pwrdown_start(unsigned int end_pwrlvl,
 	 */
 	cm_init_my_context(ep);
 
+#if CONSOLE_LINE_BUFFER
+	/*
+	 * Write out the line this CPU may have left partly printed, before its
+	 * data cache is turned off.
+	 */
+	(void)console_flush();
+#endif
+
 #if ENABLE_RUNTIME_INSTRUMENTATION
 
 	/*
@@ -164,6 +174,8 @@ void psci_cpu_suspend_start(const entry_point_info_t *ep,
 	assert((psci_plat_pm_ops->pwr_domain_suspend != NULL) &&
 	       (psci_plat_pm_ops->pwr_domain_suspend_finish != NULL));
 
+	EL3_TRACE2(EL3_TRACE_EV_PSCI_SUSPEND, end_pwrlvl, is_power_down_state);
+
 	/*
 	 * This function acquires the lock corresponding to each power
 	 * level so that by the time all locks are taken, the system topology
@@ -295,6 +307,8 @@ void psci_cpu_suspend_finish(int cpu_idx, const psci_power_state_t *state_info)
 	psci_do_pwrup_cache_maintenance();
 #endif
 
+	EL3_TRACE1(EL3_TRACE_EV_PSCI_SUSPEND_FINISH, cpu_idx);
+
 	/* Re-init the cntfrq_el0 register */
 	counter_freq = plat_get_syscnt_freq2();
 	write_cntfrq_el0(counter_freq);
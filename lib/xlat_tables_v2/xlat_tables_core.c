@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -204,6 +204,57 @@ uint64_t xlat_desc(const xlat_ctx_t *ctx, uint32_t attr,
 	return desc;
 }
 
+#if PLAT_XLAT_TABLES_CONT_HINT
+
+/*
+ * Returns true if the group of XLAT_CONT_ENTRIES descriptors that starts at
+ * index 'idx' of the given table, and maps 'group_va', can be written with the
+ * contiguous hint by the region that is being mapped.
+ *
+ * The decision is taken before any descriptor of the group is written, so the
+ * hint is never changed in a live descriptor. The group must be entirely
+ * covered by the region and all its descriptors must be invalid, so that the
+ * region writes all of them as block or page descriptors and no other region
+ * modifies them afterwards. Groups of page descriptors get the hint as well:
+ * xlat_change_mem_attributes_ctx() rewrites the whole group whenever it changes
+ * the attributes of one of its pages.
+ */
+static bool xlat_cont_group_allowed(const mmap_region_t *mm,
+				    const uint64_t *table_base,
+				    unsigned int table_entries,
+				    unsigned int idx, uintptr_t group_va,
+				    unsigned int level)
+{
+	uintptr_t mm_end_va = mm->base_va + mm->size - 1U;
+	unsigned long long group_pa;
+
+	if (level < MIN_LVL_BLOCK_DESC)
+		return false;
+
+	if ((idx + XLAT_CONT_ENTRIES) > table_entries)
+		return false;
+
+	if ((group_va < mm->base_va) ||
+	    ((group_va + XLAT_CONT_SIZE(level) - 1U) > mm_end_va))
+		return false;
+
+	group_pa = mm->base_pa + group_va - mm->base_va;
+	if ((group_pa & (XLAT_CONT_SIZE(level) - 1U)) != 0U)
+		return false;
+
+	if (mm->granularity < XLAT_BLOCK_SIZE(level))
+		return false;
+
+	for (unsigned int i = 0U; i < XLAT_CONT_ENTRIES; i++) {
+		if (table_base[idx + i] != INVALID_DESC)
+			return false;
+	}
+
+	return true;
+}
+
+#endif /* PLAT_XLAT_TABLES_CONT_HINT */
+
 /*
  * Enumeration of actions that can be made when mapping table entries depending
  * on the previous value in that entry and information about the region being
@@ -327,7 +378,19 @@ static void xlat_tables_unmap_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 		}
 
 		if (action == ACTION_WRITE_BLOCK_ENTRY) {
+#if PLAT_XLAT_TABLES_CONT_HINT
+			uintptr_t group_va = table_idx_va &
+					~(XLAT_CONT_SIZE(level) - 1U);
 
+			/*
+			 * A contiguous group is always written by a single
+			 * region, so it is always unmapped as a whole.
+			 */
+			assert(((desc & XLAT_CONT_DESC) == 0U) ||
+			       ((group_va >= mm->base_va) &&
+				((group_va + XLAT_CONT_SIZE(level) - 1U) <=
+					region_end_va)));
+#endif
 			table_base[table_idx] = INVALID_DESC;
 			xlat_arch_tlbi_va(table_idx_va, ctx->xlat_regime);
 
@@ -524,6 +587,9 @@ static uintptr_t xlat_tables_map_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 	uint64_t desc;
 
 	unsigned int table_idx;
+#if PLAT_XLAT_TABLES_CONT_HINT
+	bool cont = false;
+#endif
 
 	if (mm->base_va > table_base_va) {
 		/* Find the first index of the table affected by the region. */
@@ -550,15 +616,31 @@ static uintptr_t xlat_tables_map_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 
 		table_idx_pa = mm->base_pa + table_idx_va - mm->base_va;
 
+#if PLAT_XLAT_TABLES_CONT_HINT
+		if ((table_idx % XLAT_CONT_ENTRIES) == 0U) {
+			cont = xlat_cont_group_allowed(mm, table_base,
+					table_entries, table_idx, table_idx_va,
+					level);
+		}
+#endif
+
 		action_t action = xlat_tables_map_region_action(mm,
 			(uint32_t)(desc & DESC_MASK), table_idx_pa,
 			table_idx_va, level);
 
+#if PLAT_XLAT_TABLES_CONT_HINT
+		assert(!cont || (action == ACTION_WRITE_BLOCK_ENTRY));
+#endif
+
 		if (action == ACTION_WRITE_BLOCK_ENTRY) {
 
-			table_base[table_idx] =
-				xlat_desc(ctx, (uint32_t)mm->attr, table_idx_pa,
-					  level);
+			desc = xlat_desc(ctx, (uint32_t)mm->attr, table_idx_pa,
+					 level);
+#if PLAT_XLAT_TABLES_CONT_HINT
+			if (cont)
+				desc |= XLAT_CONT_DESC;
+#endif
+			table_base[table_idx] = desc;
 
 		} else if (action == ACTION_CREATE_NEW_TABLE) {
 			uintptr_t end_va;
@@ -997,6 +1079,9 @@ int mmap_add_dynamic_region_ctx(xlat_ctx_t *ctx, mmap_region_t *mm)
 		 * invalid descriptors, that aren't TLB cached.
 		 */
 		dsbishst();
+#if PLAT_XLAT_TABLES_CONT_HINT
+		assert(xlat_tables_check_cont_hint(ctx) >= 0);
+#endif
 	}
 
 	if (end_pa > ctx->max_pa)
@@ -1074,6 +1159,9 @@ int mmap_remove_dynamic_region_ctx(xlat_ctx_t *ctx, uintptr_t base_va,
 			ctx->base_table_entries * sizeof(uint64_t));
 #endif
 		xlat_arch_tlbi_va_sync();
+#if PLAT_XLAT_TABLES_CONT_HINT
+		assert(xlat_tables_check_cont_hint(ctx) >= 0);
+#endif
 	}
 
 	/* Remove this region by moving the rest down by one place. */
@@ -1187,6 +1275,9 @@ void __init init_xlat_tables_ctx(xlat_ctx_t *ctx)
 	assert(ctx->pa_max_address <= xlat_arch_get_max_supported_pa());
 	assert(ctx->max_va <= ctx->va_max_address);
 	assert(ctx->max_pa <= ctx->pa_max_address);
+#if PLAT_XLAT_TABLES_CONT_HINT
+	assert(xlat_tables_check_cont_hint(ctx) >= 0);
+#endif
 
 	ctx->initialized = true;
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -38,6 +38,26 @@
 
 #endif /* PLAT_XLAT_TABLES_DYNAMIC */
 
+#if PLAT_XLAT_TABLES_CONT_HINT
+/*
+ * With the 4KB translation granule, the contiguous hint can be set in a run of
+ * 16 adjacent block or page descriptors, aligned to 16 entries, that map a
+ * contiguous and equally aligned output address range with identical
+ * attributes. This applies to all lookup levels that allow block descriptors.
+ */
+#define XLAT_CONT_ENTRIES	U(16)
+#define XLAT_CONT_SIZE(level)	(XLAT_CONT_ENTRIES * XLAT_BLOCK_SIZE(level))
+#define XLAT_CONT_DESC		UPPER_ATTRS(CONT_HINT)
+
+/*
+ * Check the contiguous hint in all the translation tables of the context.
+ * Returns the number of groups of descriptors that have the hint, or -1 if a
+ * group doesn't meet the architectural requirements or isn't mapped entirely
+ * by one of the regions of the context.
+ */
+int xlat_tables_check_cont_hint(const xlat_ctx_t *ctx);
+#endif /* PLAT_XLAT_TABLES_CONT_HINT */
+
 extern uint64_t mmu_cfg_params[MMU_CFG_PARAM_MAX];
 
 /*
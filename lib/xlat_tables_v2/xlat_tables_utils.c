@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -96,6 +96,11 @@ static void xlat_desc_print(const xlat_ctx_t *ctx, uint64_t desc)
 	}
 
 	printf(((LOWER_ATTRS(NS) & desc) != 0ULL) ? "-NS" : "-S");
+
+#if PLAT_XLAT_TABLES_CONT_HINT
+	if ((desc & XLAT_CONT_DESC) != 0ULL)
+		printf("-CONT");
+#endif
 }
 
 static const char * const level_spacers[] = {
@@ -231,6 +236,9 @@ void xlat_tables_print(xlat_ctx_t *ctx)
 	VERBOSE("  Used %d sub-tables out of %d (spare: %d)\n",
 		used_page_tables, ctx->tables_num,
 		ctx->tables_num - used_page_tables);
+#if PLAT_XLAT_TABLES_CONT_HINT
+	VERBOSE("  Contiguous groups: %d\n", xlat_tables_check_cont_hint(ctx));
+#endif
 
 	xlat_tables_print_internal(ctx, 0U, ctx->base_table,
 				   ctx->base_table_entries, ctx->base_level);
@@ -238,6 +246,129 @@ void xlat_tables_print(xlat_ctx_t *ctx)
 
 #endif /* LOG_LEVEL >= LOG_LEVEL_VERBOSE */
 
+#if PLAT_XLAT_TABLES_CONT_HINT
+/*
+ * Returns true if the XLAT_CONT_ENTRIES descriptors starting at 'group' are
+ * valid block or page descriptors that all have the contiguous hint and
+ * identical attributes, and map a contiguous output range aligned to its size.
+ */
+static bool xlat_cont_group_is_valid(const uint64_t *group, unsigned int level)
+{
+	uint64_t first = group[0];
+	unsigned long long first_pa = first & TABLE_ADDR_MASK;
+	uint64_t attr_mask = ~TABLE_ADDR_MASK;
+	uint64_t desc_type = (level == XLAT_TABLE_LEVEL_MAX) ?
+			     PAGE_DESC : BLOCK_DESC;
+
+	if ((level < MIN_LVL_BLOCK_DESC) || ((first & DESC_MASK) != desc_type) ||
+	    ((first & XLAT_CONT_DESC) == 0ULL))
+		return false;
+
+	if ((first_pa & (XLAT_CONT_SIZE(level) - 1U)) != 0U)
+		return false;
+
+	for (unsigned int i = 1U; i < XLAT_CONT_ENTRIES; i++) {
+		uint64_t desc = group[i];
+
+		/* The type and the hint are part of the compared attributes */
+		if ((desc & attr_mask) != (first & attr_mask))
+			return false;
+
+		if ((desc & TABLE_ADDR_MASK) !=
+		    (first_pa + ((unsigned long long)i * XLAT_BLOCK_SIZE(level))))
+			return false;
+	}
+
+	return true;
+}
+
+/*
+ * Returns true if the group of descriptors that maps 'group_va' to
+ * 'group_pa' at the given level agrees with the mmap regions of the context:
+ * a region must map the whole group with the same output address, and no
+ * other region may cover only part of it.
+ */
+static bool xlat_cont_group_matches_mmap(const xlat_ctx_t *ctx,
+		uintptr_t group_va, unsigned long long group_pa,
+		unsigned int level)
+{
+	uintptr_t group_end_va = group_va + XLAT_CONT_SIZE(level) - 1U;
+	bool found = false;
+
+	for (const mmap_region_t *mm = ctx->mmap; mm->size != 0U; ++mm) {
+		uintptr_t mm_end_va = mm->base_va + mm->size - 1U;
+
+		if ((mm_end_va < group_va) || (mm->base_va > group_end_va))
+			continue;
+
+		if ((mm->base_va > group_va) || (mm_end_va < group_end_va))
+			return false;
+
+		if ((mm->base_pa + (group_va - mm->base_va)) == group_pa)
+			found = true;
+	}
+
+	return found;
+}
+
+/*
+ * Recursive function that returns the number of groups of descriptors that
+ * have the contiguous hint set in the given translation table, or -1 if one of
+ * them isn't valid.
+ */
+static int xlat_tables_check_cont_groups(const xlat_ctx_t *ctx,
+		uintptr_t table_base_va, const uint64_t *table_base,
+		unsigned int table_entries, unsigned int level)
+{
+	unsigned int group;
+	uintptr_t table_idx_va;
+	int count = 0, ret;
+
+	for (unsigned int i = 0U; i < table_entries; i++) {
+		uint64_t desc = table_base[i];
+
+		table_idx_va = table_base_va +
+			((uintptr_t)i << XLAT_ADDR_SHIFT(level));
+
+		if (((desc & DESC_MASK) == TABLE_DESC) &&
+		    (level < XLAT_TABLE_LEVEL_MAX)) {
+			ret = xlat_tables_check_cont_groups(ctx, table_idx_va,
+				(uint64_t *)(uintptr_t)(desc & TABLE_ADDR_MASK),
+				XLAT_TABLE_ENTRIES, level + 1U);
+			if (ret < 0)
+				return ret;
+			count += ret;
+		} else if ((desc & XLAT_CONT_DESC) != 0ULL) {
+			group = i & ~(XLAT_CONT_ENTRIES - 1U);
+			if (((group + XLAT_CONT_ENTRIES) > table_entries) ||
+			    !xlat_cont_group_is_valid(&table_base[group],
+						      level)) {
+				ERROR("Invalid contiguous group at level %u\n",
+				      level);
+				return -1;
+			}
+			if (i != group)
+				continue;
+			if (!xlat_cont_group_matches_mmap(ctx, table_idx_va,
+					desc & TABLE_ADDR_MASK, level)) {
+				ERROR("Contiguous group at VA 0x%lx doesn't match the memory map\n",
+				      table_idx_va);
+				return -1;
+			}
+			count++;
+		}
+	}
+
+	return count;
+}
+
+int xlat_tables_check_cont_hint(const xlat_ctx_t *ctx)
+{
+	return xlat_tables_check_cont_groups(ctx, 0U, ctx->base_table,
+			ctx->base_table_entries, ctx->base_level);
+}
+#endif /* PLAT_XLAT_TABLES_CONT_HINT */
+
 /*
  * Do a translation table walk to find the block or page descriptor that maps
  * virtual_addr.
@@ -420,6 +551,85 @@ int xlat_get_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
 }
 
 
+#if PLAT_XLAT_TABLES_CONT_HINT
+/*
+ * Returns true if the contiguous group of pages that contains 'va' is entirely
+ * inside the range of 'size' bytes that starts at 'base_va'.
+ */
+static bool xlat_cont_group_in_range(uintptr_t va, uintptr_t base_va,
+				     size_t size)
+{
+	uintptr_t group_va = va & ~(XLAT_CONT_SIZE(XLAT_TABLE_LEVEL_MAX) - 1U);
+
+	return (group_va >= base_va) &&
+	       ((group_va + XLAT_CONT_SIZE(XLAT_TABLE_LEVEL_MAX) - 1U) <=
+		(base_va + size - 1U));
+}
+
+/*
+ * Changes the attributes of the pages of the contiguous group that contains
+ * the page descriptor 'entry', which maps 'va'. The pages of the group between
+ * 'va' and 'end_va' (both included) get the attributes 'attr', the other ones
+ * keep their descriptors.
+ *
+ * All the descriptors of the group are invalidated before any of them is
+ * written again, so that the TLBs never hold entries from a group whose
+ * descriptors disagree. The group keeps the contiguous hint only if all its
+ * pages get the new attributes.
+ *
+ * Returns the number of pages of the group that have been changed.
+ */
+static unsigned int xlat_change_cont_group_attributes(const xlat_ctx_t *ctx,
+		uint64_t *entry, uintptr_t va, uintptr_t end_va, uint32_t attr)
+{
+	unsigned int idx = (unsigned int)XLAT_TABLE_IDX(va, XLAT_TABLE_LEVEL_MAX);
+	uint64_t *group = entry - (idx & (XLAT_CONT_ENTRIES - 1U));
+	uintptr_t group_va = va & ~(XLAT_CONT_SIZE(XLAT_TABLE_LEVEL_MAX) - 1U);
+	uint64_t old_desc = group[0] & ~XLAT_CONT_DESC;
+	unsigned long long group_pa = old_desc & TABLE_ADDR_MASK;
+	bool keep_hint = (va == group_va) &&
+		((end_va - group_va) >= (XLAT_CONT_SIZE(XLAT_TABLE_LEVEL_MAX) - 1U));
+	unsigned int changed = 0U;
+
+	for (unsigned int i = 0U; i < XLAT_CONT_ENTRIES; i++) {
+		group[i] = INVALID_DESC;
+#if !(HW_ASSISTED_COHERENCY || WARMBOOT_ENABLE_DCACHE_EARLY)
+		dccvac((uintptr_t)&group[i]);
+#endif
+	}
+
+	for (unsigned int i = 0U; i < XLAT_CONT_ENTRIES; i++)
+		xlat_arch_tlbi_va(group_va + (i * PAGE_SIZE), ctx->xlat_regime);
+
+	xlat_arch_tlbi_va_sync();
+
+	for (unsigned int i = 0U; i < XLAT_CONT_ENTRIES; i++) {
+		uintptr_t page_va = group_va + (i * PAGE_SIZE);
+		unsigned long long page_pa = group_pa +
+				((unsigned long long)i * PAGE_SIZE);
+		uint64_t desc;
+
+		if ((page_va >= va) && (page_va <= end_va)) {
+			desc = xlat_desc(ctx, attr, page_pa,
+					 XLAT_TABLE_LEVEL_MAX);
+			changed++;
+		} else {
+			desc = (old_desc & ~TABLE_ADDR_MASK) | page_pa;
+		}
+
+		if (keep_hint)
+			desc |= XLAT_CONT_DESC;
+
+		group[i] = desc;
+#if !(HW_ASSISTED_COHERENCY || WARMBOOT_ENABLE_DCACHE_EARLY)
+		dccvac((uintptr_t)&group[i]);
+#endif
+	}
+
+	return changed;
+}
+#endif /* PLAT_XLAT_TABLES_CONT_HINT */
+
 int xlat_change_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
 				   size_t size, uint32_t attr)
 {
@@ -495,6 +705,23 @@ int xlat_change_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
 			return -EINVAL;
 		}
 
+#if PLAT_XLAT_TABLES_CONT_HINT
+		/*
+		 * Changing part of a contiguous group requires invalidating the
+		 * whole group for a while. Don't do that to pages of the
+		 * translation regime that is being used, as they may hold the
+		 * code or the stack of the caller.
+		 */
+		if (((desc & XLAT_CONT_DESC) != 0ULL) &&
+		    (ctx->xlat_regime == (int)xlat_arch_current_el()) &&
+		    !xlat_cont_group_in_range(base_va, base_va_original,
+					      size)) {
+			WARN("%s: Address 0x%lx is part of a contiguous group that isn't fully in the range.\n",
+			     __func__, base_va);
+			return -EINVAL;
+		}
+#endif
+
 		/*
 		 * If the region type is device, it shouldn't be executable.
 		 */
@@ -513,7 +740,7 @@ int xlat_change_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
 	/* Restore original value. */
 	base_va = base_va_original;
 
-	for (unsigned int i = 0U; i < pages_count; ++i) {
+	for (size_t i = 0U; i < pages_count; ++i) {
 
 		uint32_t old_attr = 0U, new_attr;
 		uint64_t *entry = NULL;
@@ -538,6 +765,20 @@ int xlat_change_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
 		 */
 		new_attr |= attr & (MT_RW | MT_EXECUTE_NEVER | MT_USER);
 
+#if PLAT_XLAT_TABLES_CONT_HINT
+		if ((*entry & XLAT_CONT_DESC) != 0ULL) {
+			unsigned int changed;
+
+			changed = xlat_change_cont_group_attributes(ctx, entry,
+					base_va,
+					base_va_original + size - 1U,
+					new_attr);
+			i += changed - 1U;
+			base_va += (uintptr_t)changed * PAGE_SIZE;
+			continue;
+		}
+#endif
+
 		/*
 		 * The break-before-make sequence requires writing an invalid
 		 * descriptor and making sure that the system sees the change
@@ -33,10 +33,23 @@ BL2_AT_EL3			:= 0
 # when BL2_AT_EL3 is 1.
 BL2_IN_XIP_MEM			:= 0
 
+# Start reading each image in BL2 before the previous one is authenticated
+BL2_OVERLAP_IMAGE_LOAD		:= 0
+
 # By default, consider that the platform may release several CPUs out of reset.
 # The platform Makefile is free to override this value.
 COLD_BOOT_SINGLE_CPU		:= 0
 
+# Flag to buffer the console output of each CPU by lines
+CONSOLE_LINE_BUFFER		:= 0
+
+# Directory where the certificate generation tool caches image hashes and
+# certificates across builds. Caching is disabled by default.
+CERT_CREATE_CACHE_DIR		:=
+
+# Number of threads used by the certificate generation tool
+CERT_CREATE_JOBS		:= 1
+
 # Flag to compile in coreboot support code. Exclude by default. The coreboot
 # Makefile system will set this when compiling TF as part of a coreboot image.
 COREBOOT			:= 0
@@ -82,12 +95,21 @@ ENABLE_STACK_PROTECTOR		:= 0
 # Flag to enable exception handling in EL3
 EL3_EXCEPTION_HANDLING		:= 0
 
+# Flag to record statistics of the EL3 exception priority levels using PMF
+ENABLE_EHF_STATS		:= 0
+
+# Flag to enable the binary trace of EL3 runtime events
+ENABLE_EL3_TRACE		:= 0
+
 # Build flag to treat usage of deprecated platform and framework APIs as error.
 ERROR_DEPRECATED		:= 0
 
 # Fault injection support
 FAULT_INJECTION_SUPPORT		:= 0
 
+# Flag to let the fdt_wrappers lookups use an index of the DTB
+FDT_INDEX			:= 0
+
 # Byte alignment that each component in FIP is aligned to
 FIP_ALIGN			:= 0
 
@@ -156,6 +178,10 @@ SEPARATE_CODE_AND_RODATA	:= 0
 # cores stack
 RECLAIM_INIT_CODE		:= 0
 
+# Whether selected value-returning fast SMCs are handled by leaf runtime
+# services that skip the full context save in BL31
+SMC_LEAF_FAST_PATH		:= 0
+
 # SPD choice
 SPD				:= none
 
@@ -165,6 +191,10 @@ ENABLE_SPM			:= 0
 # Use the SPM based on MM
 SPM_MM				:= 1
 
+# Flag to queue the SPCI blocking requests that can't be served straight away
+# as non-blocking requests instead of returning SPCI_BUSY
+SPM_DEFER_BLOCKING_REQUESTS	:= 0
+
 # Flag to introduce an infinite loop in BL1 just before it exits into the next
 # image. This is meant to help debugging the post-BL2 phase.
 SPIN_ON_BL1_EXIT		:= 0
@@ -175,6 +205,10 @@ TRUSTED_BOARD_BOOT		:= 0
 # Build option to choose whether Trusted Firmware uses Coherent memory or not.
 USE_COHERENT_MEM		:= 1
 
+# Build option to offload large memory copies to a DMA engine registered by
+# the platform
+USE_DMA_MEMCPY			:= 0
+
 # Build option to choose whether Trusted Firmware uses library at ROM
 USE_ROMLIB			:= 0
 
@@ -130,6 +130,9 @@ const mmap_region_t plat_arm_mmap[] = {
 #endif
 #if ENABLE_SPM && !SPM_MM
 	PLAT_MAP_SP_PACKAGE_MEM_RO,
+#endif
+#if ENABLE_EL3_TRACE
+	ARM_MAP_EL3_TRACE_BUF,
 #endif
 	{0}
 };
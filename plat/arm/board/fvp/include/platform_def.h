@@ -256,6 +256,14 @@
 
 #define PLAT_ARM_G0_IRQ_PROPS(grp)	ARM_G0_IRQ_PROPS(grp)
 
+/*
+ * SPIs of the FVP peripherals that the Normal world may configure. The device
+ * trees in fdts/ use SPIs 32 to 92. Only these blocks of SPIs, and those in use
+ * by EL3 or enabled at the time, are saved on system suspend with GICv3.
+ */
+#define PLAT_ARM_NS_SPI_RANGES \
+	{ .base = 32U, .num = 64U }
+
 #define PLAT_ARM_PRIVATE_SDEI_EVENTS	ARM_SDEI_PRIVATE_EVENTS
 #define PLAT_ARM_SHARED_SDEI_EVENTS	ARM_SDEI_SHARED_EVENTS
 
@@ -247,6 +247,12 @@ else
     endif
 endif
 
+# Use the contiguous hint in the translation tables of BL31 and of the Secure
+# Partitions managed by it.
+ifeq (${ARCH},aarch64)
+    BL31_CFLAGS	+=	-DPLAT_XLAT_TABLES_CONT_HINT=1
+endif
+
 # Add support for platform supplied linker script for BL31 build
 $(eval $(call add_define,PLAT_EXTRA_LD_SCRIPT))
 
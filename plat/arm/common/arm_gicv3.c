@@ -8,6 +8,8 @@
 
 #include <common/interrupt_props.h>
 #include <drivers/arm/gicv3.h>
+#include <lib/pmf/pmf.h>
+#include <lib/runtime_instr.h>
 #include <lib/utils.h>
 #include <plat/arm/common/plat_arm.h>
 #include <plat/common/platform.h>
@@ -32,6 +34,16 @@ static const interrupt_prop_t arm_interrupt_props[] = {
 	PLAT_ARM_G0_IRQ_PROPS(INTR_GROUP0)
 };
 
+/*
+ * SPIs that the Normal world may configure, whose Distributor context is saved
+ * on system suspend. Without them, the context of all SPIs is saved.
+ */
+#ifdef PLAT_ARM_NS_SPI_RANGES
+static const gicv3_spi_range_t arm_ns_spi_ranges[] = {
+	PLAT_ARM_NS_SPI_RANGES
+};
+#endif
+
 /*
  * We save and restore the GICv3 context on system suspend. Allocate the
  * data in the designated EL3 Secure carve-out memory. The `volatile`
@@ -72,7 +84,11 @@ static const gicv3_driver_data_t arm_gic_data __unused = {
 	.interrupt_props_num = ARRAY_SIZE(arm_interrupt_props),
 	.rdistif_num = PLATFORM_CORE_COUNT,
 	.rdistif_base_addrs = rdistif_base_addrs,
-	.mpidr_to_core_pos = arm_gicv3_mpidr_hash
+	.mpidr_to_core_pos = arm_gicv3_mpidr_hash,
+#ifdef PLAT_ARM_NS_SPI_RANGES
+	.spi_ctx_ranges = arm_ns_spi_ranges,
+	.spi_ctx_ranges_num = ARRAY_SIZE(arm_ns_spi_ranges),
+#endif
 };
 
 void __init plat_arm_gic_driver_init(void)
@@ -146,6 +162,12 @@ void plat_arm_gic_save(void)
 	gicv3_dist_ctx_t * const dist_context =
 			(gicv3_dist_ctx_t *)LOAD_ADDR_OF(dist_ctx);
 
+#if ENABLE_RUNTIME_INSTRUMENTATION
+	PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
+		RT_INSTR_ENTER_GIC_SAVE,
+		PMF_NO_CACHE_MAINT);
+#endif
+
 	/*
 	 * If an ITS is available, save its context before
 	 * the Redistributor using:
@@ -165,6 +187,16 @@ void plat_arm_gic_save(void)
 	/* Save the GIC Distributor context */
 	gicv3_distif_save(dist_context);
 
+#if ENABLE_RUNTIME_INSTRUMENTATION
+	/*
+	 * The GIC may lose its state once this function returns, flush the
+	 * timestamp so that it is reflected in memory.
+	 */
+	PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
+		RT_INSTR_EXIT_GIC_SAVE,
+		PMF_CACHE_MAINT);
+#endif
+
 	/*
 	 * From here, all the components of the GIC can be safely powered down
 	 * as long as there is an alternate way to handle wakeup interrupt
@@ -179,6 +211,12 @@ void plat_arm_gic_resume(void)
 	const gicv3_dist_ctx_t *dist_context =
 			(gicv3_dist_ctx_t *)LOAD_ADDR_OF(dist_ctx);
 
+#if ENABLE_RUNTIME_INSTRUMENTATION
+	PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
+		RT_INSTR_ENTER_GIC_RESTORE,
+		PMF_NO_CACHE_MAINT);
+#endif
+
 	/* Restore the GIC Distributor context */
 	gicv3_distif_init_restore(dist_context);
 
@@ -198,4 +236,10 @@ void plat_arm_gic_resume(void)
 	 * restore the whole ITS state. The ITS must also be
 	 * re-enabled after this sequence has been executed.
 	 */
+
+#if ENABLE_RUNTIME_INSTRUMENTATION
+	PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
+		RT_INSTR_EXIT_GIC_RESTORE,
+		PMF_NO_CACHE_MAINT);
+#endif
 }
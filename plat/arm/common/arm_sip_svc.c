@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -8,6 +8,8 @@
 
 #include <common/debug.h>
 #include <common/runtime_svc.h>
+#include <lib/el3_trace/el3_trace.h>
+#include <lib/extensions/ras.h>
 #include <lib/pmf/pmf.h>
 #include <plat/arm/common/arm_sip_svc.h>
 #include <plat/arm/common/plat_arm.h>
@@ -48,6 +50,28 @@ static uintptr_t arm_sip_handler(unsigned int smc_fid,
 				handle, flags);
 	}
 
+#if ENABLE_EL3_TRACE
+	/*
+	 * Dispatch EL3 trace calls to the EL3 trace SMC handler and return its
+	 * return value
+	 */
+	if (is_el3_trace_fid(smc_fid)) {
+		return el3_trace_smc_handler(smc_fid, x1, x2, x3, x4, cookie,
+				handle, flags);
+	}
+#endif
+
+#if RAS_EXTENSION
+	/*
+	 * Dispatch RAS calls to the RAS SMC handler and return its return
+	 * value
+	 */
+	if (is_ras_fid(smc_fid)) {
+		return ras_smc_handler(smc_fid, x1, x2, x3, x4, cookie,
+				handle, flags);
+	}
+#endif
+
 	switch (smc_fid) {
 	case ARM_SIP_SVC_EXE_STATE_SWITCH: {
 		u_register_t pc;
@@ -69,6 +93,17 @@ static uintptr_t arm_sip_handler(unsigned int smc_fid,
 				(uint32_t) x4, handle);
 		}
 
+#if SMC_LEAF_FAST_PATH
+	case ARM_SIP_SVC_BENCH_NOP:
+	case ARM_SIP_SVC_BENCH_NOP_LEAF:
+		/*
+		 * ARM_SIP_SVC_BENCH_NOP_LEAF only gets here if the leaf
+		 * lookup failed, which makes a benchmark meaningless.
+		 */
+		SMC_RET1(handle, (smc_fid == ARM_SIP_SVC_BENCH_NOP) ?
+				SMC_OK : SMC_UNK);
+#endif
+
 	case ARM_SIP_SVC_CALL_COUNT:
 		/* PMF calls */
 		call_count += PMF_NUM_SMC_CALLS;
@@ -76,6 +111,21 @@ static uintptr_t arm_sip_handler(unsigned int smc_fid,
 		/* State switch call */
 		call_count += 1;
 
+#if SMC_LEAF_FAST_PATH
+		/* Benchmark calls */
+		call_count += 2;
+#endif
+
+#if ENABLE_EL3_TRACE
+		/* EL3 trace calls */
+		call_count += EL3_TRACE_NUM_SMC_CALLS;
+#endif
+
+#if RAS_EXTENSION
+		/* RAS calls */
+		call_count += RAS_NUM_SMC_CALLS;
+#endif
+
 		SMC_RET1(handle, call_count);
 
 	case ARM_SIP_SVC_UID:
@@ -93,6 +143,39 @@ static uintptr_t arm_sip_handler(unsigned int smc_fid,
 
 }
 
+#if SMC_LEAF_FAST_PATH
+/*
+ * Leaf handler for the PMF time-stamp query of 64-bit callers and for the
+ * benchmark call. They only return values, so they do not need the full
+ * context save done for the other calls.
+ */
+static rt_svc_leaf_ret_t arm_sip_leaf_handler(uint32_t smc_fid,
+			u_register_t x1,
+			u_register_t x2,
+			u_register_t x3,
+			u_register_t flags)
+{
+	rt_svc_leaf_ret_t ret = { SMC_OK, 0U };
+	unsigned long long ts_value = 0U;
+
+	if (smc_fid == PMF_SMC_GET_TIMESTAMP_64) {
+		/*
+		 * x0 --> error code.
+		 * x1 --> time-stamp value.
+		 */
+		ret.x0 = (u_register_t)pmf_get_timestamp_smc((unsigned int)x1,
+				x2, (unsigned int)x3, &ts_value);
+		ret.x1 = ts_value;
+	}
+
+	return ret;
+}
+
+DECLARE_RT_SVC_LEAF(arm_sip_pmf_timestamp, PMF_SMC_GET_TIMESTAMP_64,
+		arm_sip_leaf_handler);
+DECLARE_RT_SVC_LEAF(arm_sip_bench_nop, ARM_SIP_SVC_BENCH_NOP_LEAF,
+		arm_sip_leaf_handler);
+#endif /* SMC_LEAF_FAST_PATH */
 
 /* Define a runtime service descriptor for fast SMC calls */
 DECLARE_RT_SVC(
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -64,6 +64,8 @@ static const io_block_dev_spec_t emmc_dev_spec = {
 	.ops		= {
 		.read	= mmc_read_blocks,
 		.write	= mmc_write_blocks,
+		.read_start	= mmc_read_blocks_start,
+		.read_wait	= mmc_read_blocks_wait,
 	},
 	.block_size	= MMC_BLOCK_SIZE,
 };
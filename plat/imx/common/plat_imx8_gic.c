@@ -86,6 +86,5 @@ void plat_gic_restore(unsigned int proc_num, struct plat_gic_ctx *ctx)
 {
 	/* restore the gic rdist/dist context */
 	gicv3_distif_init_restore(&ctx->dist_ctx);
-	for (int i = 0; i < PLATFORM_CORE_COUNT; i++)
-		gicv3_rdistif_init_restore(i, &ctx->rdist_ctx[i]);
+	gicv3_rdistif_init_restore_all(ctx->rdist_ctx, PLATFORM_CORE_COUNT);
 }
@@ -71,6 +71,8 @@ static const io_block_dev_spec_t mmc_dev_spec = {
 	.ops	= {
 		.read	= mmc_read_blocks,
 		.write	= mmc_write_blocks,
+		.read_start	= mmc_read_blocks_start,
+		.read_wait	= mmc_read_blocks_wait,
 	},
 
 	.block_size = MMC_BLOCK_SIZE,
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2018, NVIDIA CORPORATION. All rights reserved.
+ * Copyright (c) 2017-2019, NVIDIA CORPORATION. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -19,17 +19,16 @@
 #include "ivc.h"
 
 /**
- * Holds IVC channel data
+ * Holds one request to the BPMP and the buffer for its response
  */
-struct ccplex_bpmp_channel_data {
-	/* Buffer for incoming data */
-	struct frame_data *ib;
-
-	/* Buffer for outgoing data */
-	struct frame_data *ob;
+struct bpmp_req {
+	uint32_t mrq;
+	const void *p_out;
+	uint32_t size_out;
+	void *p_in;
+	uint32_t size_in;
 };
 
-static struct ccplex_bpmp_channel_data s_channel;
 static struct ivc ivc_ccplex_bpmp_channel;
 
 /*
@@ -45,61 +44,6 @@ static inline void hsp_db_write(uint32_t reg, uint32_t val)
 	mmio_write_32((uint32_t)(TEGRA_HSP_DBELL_BASE + reg), val);
 }
 
-/*******************************************************************************
- *      IVC wrappers for CCPLEX <-> BPMP communication.
- ******************************************************************************/
-
-static void tegra_bpmp_ring_bpmp_doorbell(void);
-
-/*
- * Get the next frame where data can be written.
- */
-static struct frame_data *tegra_bpmp_get_next_out_frame(void)
-{
-	struct frame_data *frame;
-	const struct ivc *ch = &ivc_ccplex_bpmp_channel;
-
-	frame = (struct frame_data *)tegra_ivc_write_get_next_frame(ch);
-	if (frame == NULL) {
-		ERROR("%s: Error in getting next frame, exiting\n", __func__);
-	} else {
-		s_channel.ob = frame;
-	}
-
-	return frame;
-}
-
-static void tegra_bpmp_signal_slave(void)
-{
-	(void)tegra_ivc_write_advance(&ivc_ccplex_bpmp_channel);
-	tegra_bpmp_ring_bpmp_doorbell();
-}
-
-static int32_t tegra_bpmp_free_master(void)
-{
-	return tegra_ivc_read_advance(&ivc_ccplex_bpmp_channel);
-}
-
-static bool tegra_bpmp_slave_acked(void)
-{
-	struct frame_data *frame;
-	bool ret = true;
-
-	frame = (struct frame_data *)tegra_ivc_read_get_next_frame(&ivc_ccplex_bpmp_channel);
-	if (frame == NULL) {
-		ret = false;
-	} else {
-		s_channel.ib = frame;
-	}
-
-	return ret;
-}
-
-static struct frame_data *tegra_bpmp_get_cur_in_frame(void)
-{
-	return s_channel.ib;
-}
-
 /*
  * Enables BPMP to ring CCPlex doorbell
  */
@@ -139,14 +83,19 @@ static bool tegra_bpmp_can_ccplex_ring_doorbell(void)
 	return ((reg & HSP_MASTER_CCPLEX_BIT) != 0U);
 }
 
-static int32_t tegra_bpmp_wait_for_slave_ack(void)
+/*
+ * Wait until the responses to the 'num' requests sent last are all in, and
+ * return their frames.
+ */
+static int32_t tegra_bpmp_wait_for_slave_acks(const void **frames, uint32_t num)
 {
 	uint32_t timeout = TIMEOUT_RESPONSE_FROM_BPMP_US;
 
-	while (!tegra_bpmp_slave_acked() && (timeout != 0U)) {
+	while ((tegra_ivc_read_get_frames(&ivc_ccplex_bpmp_channel, frames,
+			num) != (int32_t)num) && (timeout != 0U)) {
 		udelay(1);
 		timeout--;
-	};
+	}
 
 	return ((timeout == 0U) ? -ETIMEDOUT : 0);
 }
@@ -162,62 +111,107 @@ static void tegra_bpmp_ivc_notify(const struct ivc *ivc)
 }
 
 /*
- * Atomic send/receive API, which means it waits until slave acks
+ * Atomic send/receive API for several requests, which means it waits until
+ * slave acks all of them. As many requests as there are free frames are
+ * written in place and published with a single update of the channel, so
+ * that the BPMP doorbell is rung once for all of them. Their responses are
+ * then released together once they have all been received.
  */
-static int32_t tegra_bpmp_ipc_send_req_atomic(uint32_t mrq, void *p_out,
-			uint32_t size_out, void *p_in, uint32_t size_in)
+static int32_t tegra_bpmp_ipc_send_reqs_atomic(const struct bpmp_req *reqs,
+			uint32_t num)
 {
-	struct frame_data *frame = tegra_bpmp_get_next_out_frame();
-	const struct frame_data *f_in = NULL;
+	struct ivc *ch = &ivc_ccplex_bpmp_channel;
+	void *frames_out[BPMP_IVC_NFRAMES];
+	const void *frames_in[BPMP_IVC_NFRAMES];
+	struct frame_data *frame;
+	const struct frame_data *f_in;
+	const struct bpmp_req *req;
+	uint32_t i, count, done = 0U;
 	int32_t ret = 0;
-	void *p_fdata;
 
-	if ((p_out == NULL) || (size_out > IVC_DATA_SZ_BYTES) ||
-	    (frame == NULL)) {
-		ERROR("%s: invalid parameters, exiting\n", __func__);
-		ret = -EINVAL;
+	for (i = 0U; i < num; i++) {
+		if ((reqs[i].p_out == NULL) ||
+		    (reqs[i].size_out > IVC_DATA_SZ_BYTES) ||
+		    (reqs[i].size_in > IVC_DATA_SZ_BYTES)) {
+			ERROR("%s: invalid parameters, exiting\n", __func__);
+			return -EINVAL;
+		}
 	}
 
-	if (ret == 0) {
+	while ((ret == 0) && (done < num)) {
 
-		/* prepare the command frame */
-		frame->mrq = mrq;
-		frame->flags = FLAG_DO_ACK;
-		p_fdata = frame->data;
-		(void)memcpy(p_fdata, p_out, (size_t)size_out);
+		/* get the frames for as many requests as possible */
+		ret = tegra_ivc_write_get_frames(ch, frames_out,
+				MIN(num - done, BPMP_IVC_NFRAMES));
+		if (ret < 0) {
+			ERROR("%s: Error in getting next frame, exiting\n",
+			      __func__);
+			break;
+		}
+		count = (uint32_t)ret;
+
+		/* prepare the command frames */
+		for (i = 0U; i < count; i++) {
+			req = &reqs[done + i];
+			frame = (struct frame_data *)frames_out[i];
+			frame->mrq = req->mrq;
+			frame->flags = FLAG_DO_ACK;
+			(void)memcpy(frame->data, req->p_out,
+				     (size_t)req->size_out);
+		}
 
-		/* signal the slave */
-		tegra_bpmp_signal_slave();
+		/* signal the slave, through the ivc notification */
+		ret = tegra_ivc_write_advance_frames(ch, count);
+		if (ret != 0) {
+			ERROR("Failed to send the frames\n");
+			break;
+		}
 
 		/* wait for slave to ack */
-		ret = tegra_bpmp_wait_for_slave_ack();
+		ret = tegra_bpmp_wait_for_slave_acks(frames_in, count);
 		if (ret != 0) {
 			ERROR("failed waiting for the slave to ack\n");
+			break;
 		}
 
-		/* retrieve the response frame */
-		if ((size_in <= IVC_DATA_SZ_BYTES) && (p_in != NULL) &&
-		    (ret == 0)) {
-
-			f_in = tegra_bpmp_get_cur_in_frame();
-			if (f_in != NULL) {
-				ERROR("Failed to get next input frame!\n");
-			} else {
-				(void)memcpy(p_in, p_fdata, (size_t)size_in);
+		/* retrieve the response frames */
+		for (i = 0U; i < count; i++) {
+			req = &reqs[done + i];
+			f_in = (const struct frame_data *)frames_in[i];
+			if (req->p_in != NULL) {
+				(void)memcpy(req->p_in, f_in->data,
+					     (size_t)req->size_in);
 			}
 		}
 
-		if (ret == 0) {
-			ret = tegra_bpmp_free_master();
-			if (ret != 0) {
-				ERROR("Failed to free master\n");
-			}
+		ret = tegra_ivc_read_advance_frames(ch, count);
+		if (ret != 0) {
+			ERROR("Failed to free master\n");
 		}
+
+		done += count;
 	}
 
 	return ret;
 }
 
+/*
+ * Atomic send/receive API, which means it waits until slave acks
+ */
+static int32_t tegra_bpmp_ipc_send_req_atomic(uint32_t mrq, void *p_out,
+			uint32_t size_out, void *p_in, uint32_t size_in)
+{
+	const struct bpmp_req req = {
+		.mrq = mrq,
+		.p_out = p_out,
+		.size_out = size_out,
+		.p_in = p_in,
+		.size_in = size_in
+	};
+
+	return tegra_bpmp_ipc_send_reqs_atomic(&req, 1U);
+}
+
 /*
  * Initializes the BPMP<--->CCPlex communication path.
  */
@@ -254,7 +248,8 @@ int32_t tegra_bpmp_ipc_init(void)
 	error = tegra_ivc_init(&ivc_ccplex_bpmp_channel,
 				(uint32_t)TEGRA_BPMP_IPC_RX_PHYS_BASE,
 				(uint32_t)TEGRA_BPMP_IPC_TX_PHYS_BASE,
-				1U, frame_size, tegra_bpmp_ivc_notify);
+				BPMP_IVC_NFRAMES, frame_size,
+				tegra_bpmp_ivc_notify);
 	if (error != 0) {
 
 		ERROR("%s: IVC init failed (%d)\n", __func__, error);
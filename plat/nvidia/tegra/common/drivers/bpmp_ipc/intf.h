@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2018, NVIDIA CORPORATION. All rights reserved.
+ * Copyright (c) 2017-2019, NVIDIA CORPORATION. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -29,6 +29,8 @@
  */
 #define IVC_CMD_SZ_BYTES		U(128)
 #define IVC_DATA_SZ_BYTES		U(120)
+/* Frames in each direction of the channel set up by the BPMP firmware */
+#define BPMP_IVC_NFRAMES		U(1)
 
 /**
  * Holds frame data for an IPC request
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ * Copyright (c) 2017-2019, NVIDIA CORPORATION. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -133,26 +133,35 @@ static inline uint32_t ivc_channel_avail_count(const struct ivc *ivc,
 	return (wr_count - rd_count);
 }
 
-static inline void ivc_advance_tx(struct ivc *ivc)
+/*
+ * Number of free frames in the tx channel, sampling the counters once. An
+ * over-full channel, which only a misbehaving peer can cause, has none.
+ */
+static inline uint32_t ivc_tx_free_count(const struct ivc *ivc)
 {
-	ivc->tx_channel->w_count++;
+	uint32_t avail = ivc_channel_avail_count(ivc, ivc->tx_channel);
 
-	if (ivc->w_pos == (ivc->nframes - (uint32_t)1U)) {
-		ivc->w_pos = 0U;
-	} else {
-		ivc->w_pos++;
-	}
+	return (avail >= ivc->nframes) ? 0U : (ivc->nframes - avail);
 }
 
-static inline void ivc_advance_rx(struct ivc *ivc)
+static inline uint32_t ivc_next_pos(const struct ivc *ivc, uint32_t pos,
+		uint32_t count)
 {
-	ivc->rx_channel->r_count++;
+	uint32_t next = pos + count;
 
-	if (ivc->r_pos == (ivc->nframes - (uint32_t)1U)) {
-		ivc->r_pos = 0U;
-	} else {
-		ivc->r_pos++;
-	}
+	return (next >= ivc->nframes) ? (next - ivc->nframes) : next;
+}
+
+static inline void ivc_advance_tx(struct ivc *ivc, uint32_t count)
+{
+	ivc->tx_channel->w_count += count;
+	ivc->w_pos = ivc_next_pos(ivc, ivc->w_pos, count);
+}
+
+static inline void ivc_advance_rx(struct ivc *ivc, uint32_t count)
+{
+	ivc->rx_channel->r_count += count;
+	ivc->r_pos = ivc_next_pos(ivc, ivc->r_pos, count);
 }
 
 static inline int32_t ivc_check_read(const struct ivc *ivc)
@@ -254,7 +263,7 @@ int32_t tegra_ivc_read(struct ivc *ivc, void *buf, size_t max_read)
 
 	(void)memcpy(buf, src, max_read);
 
-	ivc_advance_rx(ivc);
+	ivc_advance_rx(ivc, 1U);
 
 	/*
 	 * Ensure our write to r_pos occurs before our read from w_pos.
@@ -301,7 +310,7 @@ int32_t tegra_ivc_read_advance(struct ivc *ivc)
 		return result;
 	}
 
-	ivc_advance_rx(ivc);
+	ivc_advance_rx(ivc, 1U);
 
 	/*
 	 * Ensure our write to r_pos occurs before our read from w_pos.
@@ -349,7 +358,7 @@ int32_t tegra_ivc_write(struct ivc *ivc, const void *buf, size_t size)
 	 */
 	dmbst();
 
-	ivc_advance_tx(ivc);
+	ivc_advance_tx(ivc, 1U);
 
 	/*
 	 * Ensure our write to w_pos occurs before our read from r_pos.
@@ -392,7 +401,7 @@ int32_t tegra_ivc_write_advance(struct ivc *ivc)
 	 */
 	dmbst();
 
-	ivc_advance_tx(ivc);
+	ivc_advance_tx(ivc, 1U);
 
 	/*
 	 * Ensure our write to w_pos occurs before our read from r_pos.
@@ -411,6 +420,160 @@ int32_t tegra_ivc_write_advance(struct ivc *ivc)
 	return 0;
 }
 
+/*
+ * Get up to 'max' frames to be tx'ed, in order, and return their number.
+ * The frames are written in place and then sent all at once by
+ * tegra_ivc_write_advance_frames().
+ */
+int32_t tegra_ivc_write_get_frames(const struct ivc *ivc, void **frames,
+		uint32_t max)
+{
+	uint32_t i, count, pos;
+	int32_t result;
+
+	if ((frames == NULL) || (max > ivc->nframes)) {
+		return -EINVAL;
+	}
+
+	result = ivc_check_write(ivc);
+	if (result != 0) {
+		return result;
+	}
+
+	count = ivc_tx_free_count(ivc);
+	if (count == 0U) {
+		return -ENOMEM;
+	}
+	if (count > max) {
+		count = max;
+	}
+
+	pos = ivc->w_pos;
+	for (i = 0U; i < count; i++) {
+		frames[i] = ivc_frame_pointer(ivc, ivc->tx_channel, pos);
+		pos = ivc_next_pos(ivc, pos, 1U);
+	}
+
+	return (int32_t)count;
+}
+
+/* send 'count' frames obtained from tegra_ivc_write_get_frames() */
+int32_t tegra_ivc_write_advance_frames(struct ivc *ivc, uint32_t count)
+{
+	int32_t result = ivc_check_write(ivc);
+
+	if (result != 0) {
+		return result;
+	}
+
+	if ((count == 0U) || (count > ivc_tx_free_count(ivc))) {
+		return -EINVAL;
+	}
+
+	/*
+	 * Order any possible stores to the frames before update of w_pos.
+	 */
+	dmbst();
+
+	ivc_advance_tx(ivc, count);
+
+	/*
+	 * Ensure our write to w_pos occurs before our read from r_pos.
+	 */
+	dmbish();
+
+	/*
+	 * Notify only upon transition from empty to non-empty. The available
+	 * count can only asynchronously decrease, so it is at most 'count'
+	 * after such a transition, and the worst possible side-effect will be
+	 * a spurious notification.
+	 */
+	if (ivc_channel_avail_count(ivc, ivc->tx_channel) <= count) {
+		ivc->notify(ivc);
+	}
+
+	return 0;
+}
+
+/*
+ * Get up to 'max' frames rx'ed, in order, and return their number. The frames
+ * are released all at once by tegra_ivc_read_advance_frames().
+ */
+int32_t tegra_ivc_read_get_frames(const struct ivc *ivc, const void **frames,
+		uint32_t max)
+{
+	uint32_t i, count, pos;
+	int32_t result;
+
+	if ((frames == NULL) || (max > ivc->nframes)) {
+		return -EINVAL;
+	}
+
+	result = ivc_check_read(ivc);
+	if (result != 0) {
+		return result;
+	}
+
+	/*
+	 * Order observation of w_pos potentially indicating new data before
+	 * data read.
+	 */
+	dmbld();
+
+	/* sample the counters again, rejecting an over-full channel */
+	count = ivc_channel_avail_count(ivc, ivc->rx_channel);
+	if ((count > ivc->nframes) || (count == 0U)) {
+		return -ENOMEM;
+	}
+	if (count > max) {
+		count = max;
+	}
+
+	pos = ivc->r_pos;
+	for (i = 0U; i < count; i++) {
+		frames[i] = ivc_frame_pointer(ivc, ivc->rx_channel, pos);
+		pos = ivc_next_pos(ivc, pos, 1U);
+	}
+
+	return (int32_t)count;
+}
+
+/* release 'count' frames obtained from tegra_ivc_read_get_frames() */
+int32_t tegra_ivc_read_advance_frames(struct ivc *ivc, uint32_t count)
+{
+	uint32_t avail;
+	int32_t result = ivc_check_read(ivc);
+
+	if (result != 0) {
+		return result;
+	}
+
+	avail = ivc_channel_avail_count(ivc, ivc->rx_channel);
+	if ((count == 0U) || (count > avail) || (avail > ivc->nframes)) {
+		return -EINVAL;
+	}
+
+	ivc_advance_rx(ivc, count);
+
+	/*
+	 * Ensure our write to r_pos occurs before our read from w_pos.
+	 */
+	dmbish();
+
+	/*
+	 * Notify only upon transition from full to non-full. The available
+	 * count can only asynchronously increase, so it is at least
+	 * 'nframes - count' after such a transition, and the worst possible
+	 * side-effect will be a spurious notification.
+	 */
+	if (ivc_channel_avail_count(ivc, ivc->rx_channel) >=
+			(ivc->nframes - count)) {
+		ivc->notify(ivc);
+	}
+
+	return 0;
+}
+
 void tegra_ivc_channel_reset(const struct ivc *ivc)
 {
 	ivc->tx_channel->state = ivc_state_sync;
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017, NVIDIA CORPORATION. All rights reserved.
+ * Copyright (c) 2017-2019, NVIDIA CORPORATION. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -7,6 +7,7 @@
 #ifndef IVC_H
 #define IVC_H
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stddef.h>
 #include <utils_def.h>
@@ -44,6 +45,12 @@ int32_t tegra_ivc_write(struct ivc *ivc, const void *buf, size_t size);
 int32_t tegra_ivc_read_advance(struct ivc *ivc);
 void *tegra_ivc_read_get_next_frame(const struct ivc *ivc);
 int32_t tegra_ivc_read(struct ivc *ivc, void *buf, size_t max_read);
+int32_t tegra_ivc_write_get_frames(const struct ivc *ivc, void **frames,
+		uint32_t max);
+int32_t tegra_ivc_write_advance_frames(struct ivc *ivc, uint32_t count);
+int32_t tegra_ivc_read_get_frames(const struct ivc *ivc, const void **frames,
+		uint32_t max);
+int32_t tegra_ivc_read_advance_frames(struct ivc *ivc, uint32_t count);
 bool tegra_ivc_tx_empty(const struct ivc *ivc);
 bool tegra_ivc_can_write(const struct ivc *ivc);
 bool tegra_ivc_can_read(const struct ivc *ivc);
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -53,6 +53,9 @@
 #define GPCDMA_TIMEOUT_MS			U(100)
 #define GPCDMA_RESET_BIT			(U(1) << 1)
 
+/* smaller transfers are quicker to do on the CPU */
+#define GPCDMA_MIN_OFFLOAD_SIZE			U(4096)
+
 static bool init_done;
 
 static void tegra_gpcdma_write32(uint32_t offset, uint32_t val)
@@ -78,10 +81,11 @@ static void tegra_gpcdma_init(void)
 		      GPCDMA_RESET_BIT);
 }
 
-static void tegra_gpcdma_memcpy_priv(uint64_t dst_addr, uint64_t src_addr,
-				     uint32_t num_bytes, uint32_t mode)
+static int32_t tegra_gpcdma_start(uint64_t dst_addr, uint64_t src_addr,
+				  uint32_t num_bytes, uint32_t mode,
+				  uint32_t pattern)
 {
-	uint32_t val, timeout = 0;
+	uint32_t val;
 	int32_t ret = 0;
 
 	/* sanity check byte count */
@@ -115,8 +119,8 @@ static void tegra_gpcdma_memcpy_priv(uint64_t dst_addr, uint64_t src_addr,
 		      (DMA_CH_MC_SEQ_BURST_16_WORDS << DMA_CH_MC_SEQ_BURST_SHIFT);
 		tegra_gpcdma_write32(DMA_CH_MC_SEQ, val);
 
-		/* reset fixed pattern */
-		tegra_gpcdma_write32(DMA_CH_FIXED_PATTERN, 0);
+		/* program fixed pattern */
+		tegra_gpcdma_write32(DMA_CH_FIXED_PATTERN, pattern);
 
 		/* populate src and dst address registers */
 		tegra_gpcdma_write32(DMA_CH_SRC_PTR, (uint32_t)src_addr);
@@ -140,31 +144,50 @@ static void tegra_gpcdma_memcpy_priv(uint64_t dst_addr, uint64_t src_addr,
 		val = tegra_gpcdma_read32(DMA_CH_CSR);
 		val |= DMA_CH_CSR_ENABLE;
 		tegra_gpcdma_write32(DMA_CH_CSR, val);
+	}
 
-		/* wait till transfer completes */
-		do {
-
-			/* read the status */
-			val = tegra_gpcdma_read32(DMA_CH_STAT);
-			if ((val & DMA_CH_STAT_BUSY) != DMA_CH_STAT_BUSY) {
-				break;
-			}
+	return ret;
+}
 
-			mdelay(1);
-			timeout++;
+static int32_t tegra_gpcdma_wait(void)
+{
+	uint32_t val, timeout = 0;
+	int32_t ret = 0;
 
-		} while (timeout < GPCDMA_TIMEOUT_MS);
+	/* wait till transfer completes */
+	do {
 
-		/* flag timeout error */
-		if (timeout == GPCDMA_TIMEOUT_MS) {
-			ERROR("DMA transfer timed out\n");
+		/* read the status */
+		val = tegra_gpcdma_read32(DMA_CH_STAT);
+		if ((val & DMA_CH_STAT_BUSY) != DMA_CH_STAT_BUSY) {
+			break;
 		}
 
-		dsbsy();
+		mdelay(1);
+		timeout++;
 
-		/* disable DMA access to TZDRAM */
-		tegra_gpcdma_write32(DMA_CH_TZ, DMA_CH_TZ_ACCESS_DISABLE);
-		isb();
+	} while (timeout < GPCDMA_TIMEOUT_MS);
+
+	/* flag timeout error */
+	if (timeout == GPCDMA_TIMEOUT_MS) {
+		ERROR("DMA transfer timed out\n");
+		ret = -ETIMEDOUT;
+	}
+
+	dsbsy();
+
+	/* disable DMA access to TZDRAM */
+	tegra_gpcdma_write32(DMA_CH_TZ, DMA_CH_TZ_ACCESS_DISABLE);
+	isb();
+
+	return ret;
+}
+
+static void tegra_gpcdma_memcpy_priv(uint64_t dst_addr, uint64_t src_addr,
+				     uint32_t num_bytes, uint32_t mode)
+{
+	if (tegra_gpcdma_start(dst_addr, src_addr, num_bytes, mode, 0U) == 0) {
+		(void)tegra_gpcdma_wait();
 	}
 }
 
@@ -186,3 +209,47 @@ void tegra_gpcdma_zeromem(uint64_t dst_addr, uint32_t num_bytes)
 	tegra_gpcdma_memcpy_priv(dst_addr, 0, num_bytes,
 				 DMA_CH_CSR_DMA_MODE_FIXEDPATTERN);
 }
+
+/*******************************************************************************
+ * Handlers for the generic DMA interface. The channel only moves whole words,
+ * so any other transfer is left to the CPU.
+ ******************************************************************************/
+static bool tegra_gpcdma_can_xfer(uintptr_t dst, uintptr_t src, size_t len)
+{
+	return (((dst | src | len) & 0x3U) == 0U) &&
+	       (len <= (size_t)MAX_TRANSFER_SIZE);
+}
+
+static int tegra_gpcdma_copy_start(uintptr_t dst, uintptr_t src, size_t len)
+{
+	if (!tegra_gpcdma_can_xfer(dst, src, len)) {
+		return -ENOTSUP;
+	}
+
+	return tegra_gpcdma_start(dst, src, (uint32_t)len,
+				  DMA_CH_CSR_DMA_MODE_MEM2MEM, 0U);
+}
+
+static int tegra_gpcdma_fill_start(uintptr_t dst, int val, size_t len)
+{
+	if (!tegra_gpcdma_can_xfer(dst, 0U, len)) {
+		return -ENOTSUP;
+	}
+
+	return tegra_gpcdma_start(dst, 0U, (uint32_t)len,
+				  DMA_CH_CSR_DMA_MODE_FIXEDPATTERN,
+				  (uint32_t)(uint8_t)val * U(0x01010101));
+}
+
+static int tegra_gpcdma_dma_wait(void)
+{
+	return tegra_gpcdma_wait();
+}
+
+const dma_ops_t tegra_gpcdma_dma_ops = {
+	.copy_start = tegra_gpcdma_copy_start,
+	.fill_start = tegra_gpcdma_fill_start,
+	.wait = tegra_gpcdma_dma_wait,
+	.min_size = GPCDMA_MIN_OFFLOAD_SIZE,
+	.coherent = false,
+};
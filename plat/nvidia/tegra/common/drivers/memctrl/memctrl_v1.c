@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -133,7 +133,7 @@ static void tegra_clear_videomem(uintptr_t non_overlap_area_start,
  * phys_base = physical base of aperture
  * size_in_bytes = size of aperture in bytes
  */
-void tegra_memctrl_videomem_setup(uint64_t phys_base, uint32_t size_in_bytes)
+int tegra_memctrl_videomem_setup(uint64_t phys_base, uint32_t size_in_bytes)
 {
 	uintptr_t vmem_end_old = video_mem_base + (video_mem_size << 20);
 	uintptr_t vmem_end_new = phys_base + size_in_bytes;
@@ -182,6 +182,22 @@ done:
 	/* store new values */
 	video_mem_base = phys_base;
 	video_mem_size = size_in_bytes >> 20;
+
+	return 0;
+}
+
+/*
+ * The v1 driver clears the previous Video Memory carveout before
+ * tegra_memctrl_videomem_setup() returns, so there is never anything left to
+ * clear.
+ */
+int tegra_memctrl_videomem_scrub(unsigned long long *done,
+				 unsigned long long *total)
+{
+	*done = 0ULL;
+	*total = 0ULL;
+
+	return 0;
 }
 
 /*
@@ -1,16 +1,20 @@
 /*
- * Copyright (c) 2015-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
 #include <assert.h>
+#include <errno.h>
+#include <stdbool.h>
 #include <string.h>
 
 #include <arch_helpers.h>
 #include <common/bl_common.h>
 #include <common/debug.h>
+#include <lib/mem_scrub.h>
 #include <lib/mmio.h>
+#include <lib/spinlock.h>
 #include <lib/utils.h>
 #include <lib/xlat_tables/xlat_tables_v2.h>
 
@@ -294,25 +298,139 @@ static void tegra_unlock_videomem_nonoverlap(void)
 	tegra_mc_write_32(MC_VIDEO_PROTECT_CLEAR_SIZE, 0);
 }
 
-static void tegra_clear_videomem(uintptr_t non_overlap_area_start,
-				 unsigned long long non_overlap_area_size)
+/* Largest amount of Video Memory cleared at a time */
+#define VIDEOMEM_SCRUB_CHUNK_SIZE	(U(2) << 20)
+
+/*
+ * Regions of the previous Video Memory carveout that are being cleared before
+ * the new carveout settings take effect. If TEGRA_VIDEOMEM_SCRUB_BUDGET_US is
+ * not 0, they are cleared over several SMCs, possibly issued by several CPUs,
+ * see tegra_memctrl_videomem_scrub().
+ *
+ * Each region has its own scrub, initialised under the lock before 'cur'
+ * reaches it, so a CPU still running the scrub of a previous region never
+ * sees it change under its feet.
+ */
+static struct {
+	spinlock_t lock;
+	bool pending;
+
+	/* Regions to clear, and the index of the one being cleared */
+	uintptr_t base[2];
+	unsigned long long size[2];
+	mem_scrub_t scrub[2];
+	unsigned int num;
+	unsigned int cur;
+
+	/* Carveout settings to program once the regions are cleared */
+	uint64_t new_base;
+	uint32_t new_size;
+} vmem_scrub;
+
+/* Map the current region to clear. Called with the lock held. */
+static void tegra_videomem_scrub_region(void)
 {
+	unsigned int cur = vmem_scrub.cur;
 	int ret;
 
+	ret = mem_scrub_init(&vmem_scrub.scrub[cur], vmem_scrub.base[cur],
+			     vmem_scrub.size[cur], VIDEOMEM_SCRUB_CHUNK_SIZE);
+	assert(ret == 0);
+	(void)ret;
+}
+
+/* Program the Video Memory carveout. Called with the lock held. */
+static void tegra_videomem_program(uint64_t phys_base, uint32_t size_in_bytes)
+{
+	/* program the Videomem aperture */
+	tegra_mc_write_32(MC_VIDEO_PROTECT_BASE_LO, (uint32_t)phys_base);
+	tegra_mc_write_32(MC_VIDEO_PROTECT_BASE_HI,
+			  (uint32_t)(phys_base >> 32));
+	tegra_mc_write_32(MC_VIDEO_PROTECT_SIZE_MB, size_in_bytes >> 20);
+
+	/* unlock the previous locked nonoverlapping aperture */
+	tegra_unlock_videomem_nonoverlap();
+
+	/* store new values */
+	video_mem_base = phys_base;
+	video_mem_size_mb = size_in_bytes >> 20;
+
 	/*
-	 * Map the NS memory first, clean it and then unmap it.
+	 * MCE propagates the VideoMem configuration values across the
+	 * CCPLEX.
 	 */
-	ret = mmap_add_dynamic_region(non_overlap_area_start, /* PA */
-				non_overlap_area_start, /* VA */
-				non_overlap_area_size, /* size */
-				MT_NS | MT_RW | MT_EXECUTE_NEVER); /* attrs */
-	assert(ret == 0);
+	mce_update_gsc_videomem();
+}
+
+/*
+ * Clear the regions of the previous Video Memory carveout for at most
+ * TEGRA_VIDEOMEM_SCRUB_BUDGET_US, and program the new carveout once they are
+ * all cleared. Several CPUs may call this function at the same time to clear
+ * the regions faster.
+ *
+ * Returns 0 if the new carveout has been programmed, or -EAGAIN if this
+ * function must be called again. 'done' and 'total' return the number of
+ * bytes cleared so far and the number of bytes to clear.
+ */
+int tegra_memctrl_videomem_scrub(unsigned long long *done,
+				 unsigned long long *total)
+{
+	unsigned long long scrub_done, scrub_size;
+	mem_scrub_t *scrub = NULL;
+	unsigned int i;
+	int ret;
+
+	spin_lock(&vmem_scrub.lock);
+	if (vmem_scrub.pending) {
+		scrub = &vmem_scrub.scrub[vmem_scrub.cur];
+	}
+	spin_unlock(&vmem_scrub.lock);
+
+	if (scrub != NULL) {
+		(void)mem_scrub_run(scrub, TEGRA_VIDEOMEM_SCRUB_BUDGET_US);
+	}
 
-	zero_normalmem((void *)non_overlap_area_start, non_overlap_area_size);
-	flush_dcache_range(non_overlap_area_start, non_overlap_area_size);
+	spin_lock(&vmem_scrub.lock);
 
-	(void)mmap_remove_dynamic_region(non_overlap_area_start,
-		non_overlap_area_size);
+	/*
+	 * Move past the regions that are completely cleared, whichever CPU
+	 * cleared them, and program the new carveout settings once they all
+	 * are.
+	 */
+	while (vmem_scrub.pending) {
+		mem_scrub_get_progress(&vmem_scrub.scrub[vmem_scrub.cur],
+				       &scrub_done, &scrub_size);
+		if (scrub_done != scrub_size) {
+			break;
+		}
+
+		vmem_scrub.cur++;
+		if (vmem_scrub.cur < vmem_scrub.num) {
+			tegra_videomem_scrub_region();
+		} else {
+			tegra_videomem_program(vmem_scrub.new_base,
+					       vmem_scrub.new_size);
+			vmem_scrub.pending = false;
+		}
+	}
+
+	*done = 0ULL;
+	*total = 0ULL;
+	if (vmem_scrub.pending) {
+		for (i = 0U; i < vmem_scrub.num; i++) {
+			*total += vmem_scrub.size[i];
+			if (i < vmem_scrub.cur)
+				*done += vmem_scrub.size[i];
+		}
+		mem_scrub_get_progress(&vmem_scrub.scrub[vmem_scrub.cur],
+				       &scrub_done, &scrub_size);
+		*done += scrub_done;
+	}
+
+	ret = vmem_scrub.pending ? -EAGAIN : 0;
+	spin_unlock(&vmem_scrub.lock);
+
+	return ret;
 }
 
 /*
@@ -320,12 +438,16 @@ static void tegra_clear_videomem(uintptr_t non_overlap_area_start,
  *
  * phys_base = physical base of aperture
  * size_in_bytes = size of aperture in bytes
+ *
+ * Returns 0 if the new carveout has been programmed, -EAGAIN if the previous
+ * carveout is still being cleared and tegra_memctrl_videomem_scrub() must be
+ * called to finish, or -EBUSY if a previous change is still in progress.
  */
-void tegra_memctrl_videomem_setup(uint64_t phys_base, uint32_t size_in_bytes)
+int tegra_memctrl_videomem_setup(uint64_t phys_base, uint32_t size_in_bytes)
 {
-	uintptr_t vmem_end_old = video_mem_base + (video_mem_size_mb << 20);
-	uintptr_t vmem_end_new = phys_base + size_in_bytes;
-	unsigned long long non_overlap_area_size;
+	uintptr_t vmem_end_old, vmem_end_new = phys_base + size_in_bytes;
+	unsigned long long done, total;
+	int ret;
 
 	/*
 	 * Setup the Memory controller to restrict CPU accesses to the Video
@@ -333,11 +455,24 @@ void tegra_memctrl_videomem_setup(uint64_t phys_base, uint32_t size_in_bytes)
 	 */
 	INFO("Configuring Video Memory Carveout\n");
 
+	spin_lock(&vmem_scrub.lock);
+
+	if (vmem_scrub.pending) {
+		spin_unlock(&vmem_scrub.lock);
+		ERROR("Video Memory Carveout change already in progress\n");
+		return -EBUSY;
+	}
+
+	vmem_end_old = video_mem_base + (video_mem_size_mb << 20);
+
 	/*
 	 * Configure Memory Controller directly for the first time.
 	 */
-	if (video_mem_base == 0U)
-		goto done;
+	if (video_mem_base == 0U) {
+		tegra_videomem_program(phys_base, size_in_bytes);
+		spin_unlock(&vmem_scrub.lock);
+		return 0;
+	}
 
 	/*
 	 * Lock the non overlapping memory being cleared so that other masters
@@ -358,41 +493,46 @@ void tegra_memctrl_videomem_setup(uint64_t phys_base, uint32_t size_in_bytes)
 	 */
 	INFO("Cleaning previous Video Memory Carveout\n");
 
+	vmem_scrub.num = 0U;
 	if ((phys_base > vmem_end_old) || (video_mem_base > vmem_end_new)) {
-		tegra_clear_videomem(video_mem_base,
-				     (uint32_t)video_mem_size_mb << 20U);
+		vmem_scrub.base[0] = video_mem_base;
+		vmem_scrub.size[0] = video_mem_size_mb << 20U;
+		vmem_scrub.num = 1U;
 	} else {
 		if (video_mem_base < phys_base) {
-			non_overlap_area_size = phys_base - video_mem_base;
-			tegra_clear_videomem(video_mem_base,
-					(uint32_t)non_overlap_area_size);
+			vmem_scrub.base[vmem_scrub.num] = video_mem_base;
+			vmem_scrub.size[vmem_scrub.num] =
+				phys_base - video_mem_base;
+			vmem_scrub.num++;
 		}
 		if (vmem_end_old > vmem_end_new) {
-			non_overlap_area_size = vmem_end_old - vmem_end_new;
-			tegra_clear_videomem(vmem_end_new,
-					(uint32_t)non_overlap_area_size);
+			vmem_scrub.base[vmem_scrub.num] = vmem_end_new;
+			vmem_scrub.size[vmem_scrub.num] =
+				vmem_end_old - vmem_end_new;
+			vmem_scrub.num++;
 		}
 	}
 
-done:
-	/* program the Videomem aperture */
-	tegra_mc_write_32(MC_VIDEO_PROTECT_BASE_LO, (uint32_t)phys_base);
-	tegra_mc_write_32(MC_VIDEO_PROTECT_BASE_HI,
-			  (uint32_t)(phys_base >> 32));
-	tegra_mc_write_32(MC_VIDEO_PROTECT_SIZE_MB, size_in_bytes >> 20);
+	if (vmem_scrub.num == 0U) {
+		tegra_videomem_program(phys_base, size_in_bytes);
+		spin_unlock(&vmem_scrub.lock);
+		return 0;
+	}
 
-	/* unlock the previous locked nonoverlapping aperture */
-	tegra_unlock_videomem_nonoverlap();
+	vmem_scrub.cur = 0U;
+	vmem_scrub.new_base = phys_base;
+	vmem_scrub.new_size = size_in_bytes;
+	vmem_scrub.pending = true;
+	tegra_videomem_scrub_region();
 
-	/* store new values */
-	video_mem_base = phys_base;
-	video_mem_size_mb = size_in_bytes >> 20;
+	spin_unlock(&vmem_scrub.lock);
 
-	/*
-	 * MCE propagates the VideoMem configuration values across the
-	 * CCPLEX.
-	 */
-	mce_update_gsc_videomem();
+	/* Without a time budget, clear the regions before returning */
+	do {
+		ret = tegra_memctrl_videomem_scrub(&done, &total);
+	} while ((ret != 0) && (TEGRA_VIDEOMEM_SCRUB_BUDGET_US == 0U));
+
+	return ret;
 }
 
 /*
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -20,6 +20,7 @@
 #include <cortex_a57.h>
 #include <denver.h>
 #include <drivers/console.h>
+#include <drivers/dma.h>
 #include <lib/mmio.h>
 #include <lib/utils.h>
 #include <lib/utils_def.h>
@@ -120,6 +121,28 @@ plat_params_from_bl2_t *bl31_get_plat_params(void)
 	return &plat_bl31_params_from_bl2;
 }
 
+/*******************************************************************************
+ * Copy the BL32 image to its entry point in TZDRAM and clean up the non-secure
+ * intermediate buffer. With USE_DMA_MEMCPY, both are done by the DMA engine
+ * registered from plat_early_platform_setup(), if any. The CPU does them if
+ * the engine can't.
+ ******************************************************************************/
+static void tegra_relocate_bl32(uintptr_t dst, uintptr_t src, size_t size)
+{
+#if USE_DMA_MEMCPY
+	if (dma_memcpy((void *)dst, (const void *)src, size) != 0) {
+		(void)memcpy16((void *)dst, (void *)src, size);
+	}
+
+	if (dma_memset((void *)src, 0, size) != 0) {
+		zeromem((void *)src, size);
+	}
+#else
+	(void)memcpy16((void *)dst, (void *)src, size);
+	zeromem((void *)src, size);
+#endif
+}
+
 /*******************************************************************************
  * Perform any BL31 specific platform actions. Populate the BL33 and BL32 image
  * info.
@@ -270,13 +293,9 @@ void bl31_early_platform_setup2(u_register_t arg0, u_register_t arg1,
 
 			INFO("Relocate BL32 to TZDRAM\n");
 
-			(void)memcpy16((void *)(uintptr_t)bl32_image_ep_info.pc,
-				 (void *)(uintptr_t)bl32_start,
-				 bl32_img_info.image_size);
-
-			/* clean up non-secure intermediate buffer */
-			zeromem((void *)(uintptr_t)bl32_start,
-				bl32_img_info.image_size);
+			tegra_relocate_bl32((uintptr_t)bl32_image_ep_info.pc,
+					    (uintptr_t)bl32_start,
+					    bl32_img_info.image_size);
 		}
 	}
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -25,6 +25,7 @@
 #define TEGRA_SIP_FIQ_NS_ENTRYPOINT		0x82000005
 #define TEGRA_SIP_FIQ_NS_GET_CONTEXT		0x82000006
 #define TEGRA_SIP_ENABLE_FAKE_SYSTEM_SUSPEND	0xC2000007
+#define TEGRA_SIP_VIDEOMEM_SCRUB_CONTINUE	0xC2000008
 
 /*******************************************************************************
  * Fake system suspend mode control var
@@ -57,6 +58,20 @@ int32_t plat_sip_handler(uint32_t smc_fid,
 	return -ENOTSUP;
 }
 
+/*******************************************************************************
+ * Ensure that the GPU is still in reset after the Video Memory resize
+ ******************************************************************************/
+static void tegra_videomem_check_gpu_reset(void)
+{
+	uint32_t regval;
+
+	regval = mmio_read_32(TEGRA_CAR_RESET_BASE + TEGRA_GPU_RESET_REG_OFFSET);
+	if ((regval & GPU_RESET_BIT) == 0U) {
+		mmio_write_32(TEGRA_CAR_RESET_BASE + TEGRA_GPU_RESET_GPU_SET_OFFSET,
+								GPU_SET_BIT);
+	}
+}
+
 /*******************************************************************************
  * This function is responsible for handling all SiP calls
  ******************************************************************************/
@@ -70,6 +85,7 @@ uintptr_t tegra_sip_handler(uint32_t smc_fid,
 			    u_register_t flags)
 {
 	uint32_t regval, local_x2_32 = (uint32_t)x2;
+	unsigned long long done, total;
 	int32_t err;
 
 	/* Check if this is a SoC specific SiP */
@@ -113,20 +129,35 @@ uintptr_t tegra_sip_handler(uint32_t smc_fid,
 				SMC_RET1(handle, (uint64_t)-ENOTSUP);
 			}
 
-			/* new video memory carveout settings */
-			tegra_memctrl_videomem_setup(x1, local_x2_32);
-
 			/*
-			 * Ensure again that GPU is still in reset after VPR resize
+			 * new video memory carveout settings. If the previous
+			 * carveout isn't cleared within the time budget, the
+			 * NS world finishes the change with
+			 * TEGRA_SIP_VIDEOMEM_SCRUB_CONTINUE.
 			 */
-			regval = mmio_read_32(TEGRA_CAR_RESET_BASE +
-					      TEGRA_GPU_RESET_REG_OFFSET);
-			if ((regval & GPU_RESET_BIT) == 0U) {
-				mmio_write_32(TEGRA_CAR_RESET_BASE + TEGRA_GPU_RESET_GPU_SET_OFFSET,
-									GPU_SET_BIT);
+			err = tegra_memctrl_videomem_setup(x1, local_x2_32);
+			if (err == 0) {
+				tegra_videomem_check_gpu_reset();
 			}
 
-			SMC_RET1(handle, 0);
+			SMC_RET1(handle, (uint64_t)err);
+
+		/*
+		 * Continue clearing the previous Video Memory carveout, and
+		 * program the new one once done. The NS world issues this SMC,
+		 * possibly from several CPUs at the same time, until it returns
+		 * 0. While it returns -EAGAIN, x1 and x2 hold the number of
+		 * bytes cleared so far and the number of bytes to clear. These
+		 * are 64-bit values, so this is an SMC64 call.
+		 */
+		case TEGRA_SIP_VIDEOMEM_SCRUB_CONTINUE:
+
+			err = tegra_memctrl_videomem_scrub(&done, &total);
+			if (err == 0) {
+				tegra_videomem_check_gpu_reset();
+			}
+
+			SMC_RET3(handle, (uint64_t)err, done, total);
 
 		/*
 		 * The NS world registers the address of its handler to be
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -9,8 +9,13 @@
 
 #include <stdint.h>
 
+#include <drivers/dma.h>
+
 void tegra_gpcdma_memcpy(uint64_t dst_addr, uint64_t src_addr,
 			    uint32_t num_bytes);
 void tegra_gpcdma_zeromem(uint64_t dst_addr, uint32_t num_bytes);
 
+/* GPCDMA channel as an engine for the generic DMA interface */
+extern const dma_ops_t tegra_gpcdma_dma_ops;
+
 #endif /* __GPCDMA_H__ */
@@ -1,5 +1,5 @@
 #
-# Copyright (c) 2015-2018, ARM Limited and Contributors. All rights reserved.
+# Copyright (c) 2015-2019, ARM Limited and Contributors. All rights reserved.
 #
 # SPDX-License-Identifier: BSD-3-Clause
 #
@@ -19,6 +19,11 @@ $(eval $(call add_define,PLAT_LOG_LEVEL_ASSERT))
 PLAT_XLAT_TABLES_DYNAMIC :=	1
 $(eval $(call add_define,PLAT_XLAT_TABLES_DYNAMIC))
 
+# max. time (in us) spent clearing the old Video Memory carveout in one SMC,
+# 0 clears it completely before returning
+TEGRA_VIDEOMEM_SCRUB_BUDGET_US	?=	0
+$(eval $(call add_define,TEGRA_VIDEOMEM_SCRUB_BUDGET_US))
+
 # Enable PSCI v1.0 extended state ID format
 PSCI_EXTENDED_STATE_ID	:=	1
 
@@ -18,10 +18,12 @@
 #include <drivers/arm/gic_common.h>
 #include <drivers/arm/gicv2.h>
 #include <drivers/console.h>
+#include <drivers/dma.h>
 #include <lib/el3_runtime/context_mgmt.h>
 #include <lib/xlat_tables/xlat_tables_v2.h>
 #include <plat/common/platform.h>
 
+#include <gpcdma.h>
 #include <mce.h>
 #include <tegra_def.h>
 #include <tegra_platform.h>
@@ -180,6 +182,11 @@ void plat_early_platform_setup(void)
 		val |= CORTEX_A57_L2_ECC_PARITY_PROTECTION_BIT;
 		write_l2ctlr_el1(val);
 	}
+
+#if USE_DMA_MEMCPY
+	/* offload large memory copies to the GPCDMA channel */
+	dma_init(&tegra_gpcdma_dma_ops);
+#endif
 }
 
 /* Secure IRQs for Tegra186 */
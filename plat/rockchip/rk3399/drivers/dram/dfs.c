@@ -1,9 +1,11 @@
 /*
- * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <assert.h>
+
 #include <arch_helpers.h>
 #include <common/debug.h>
 #include <drivers/delay_timer.h>
@@ -43,6 +45,9 @@ struct rk3399_dram_status {
 	uint32_t low_power_stat;
 	struct timing_related_config timing_config;
 	struct drv_odt_lp_config drv_odt_lp_cfg;
+	/* Duration of the last and of the longest frequency switch, in us */
+	uint32_t switch_us;
+	uint32_t switch_max_us;
 };
 
 struct rk3399_saved_status {
@@ -56,6 +61,107 @@ static struct rk3399_saved_status rk3399_suspend_status;
 static uint32_t wrdqs_delay_val[2][2][4];
 static uint32_t rddqs_delay_ps;
 
+/*
+ * DRAM timings of each entry of dpll_rates_table. They only depend on the
+ * frequency and on the DRAM configuration, of which only the ODT setting can
+ * change at run time, so they are computed for all the frequencies at once,
+ * and again when the ODT setting changes.
+ */
+static struct dram_timing_t dram_timing_cache[ARRAY_SIZE(dpll_rates_table)];
+static uint32_t dram_timing_cache_odt = 0xffffffff;
+
+/*
+ * Register writes done by gen_rk3399_ctl_params(), gen_rk3399_pi_params() and
+ * gen_rk3399_phy_params() for each entry of dpll_rates_table and each of the
+ * two frequency sets. Like the DRAM timings, they only depend on the frequency
+ * and on the ODT setting, so they are recorded the first time they are
+ * generated and written again on the next switches to that frequency. The DLL
+ * bypass settings depend on the state of the PHY, and are always generated.
+ */
+#define DFS_IMAGE_MAX_WRITES	336	/* Two channels of at most 167 writes */
+
+struct dfs_reg_write {
+	uint32_t addr;
+	uint32_t clr;
+	uint32_t set;
+};
+
+struct dfs_image {
+	uint32_t count;		/* 0 until recorded */
+	bool overflow;		/* Too many writes, always generate them */
+	struct dfs_reg_write writes[DFS_IMAGE_MAX_WRITES];
+};
+
+static struct dfs_image dfs_images[ARRAY_SIZE(dpll_rates_table)][2];
+static struct dfs_image *dfs_image_rec;	/* Image being recorded, or NULL */
+
+static void dfs_image_record(uintptr_t addr, uint32_t clr, uint32_t set)
+{
+	struct dfs_image *image = dfs_image_rec;
+
+	if ((image == NULL) || image->overflow)
+		return;
+
+	if (image->count == DFS_IMAGE_MAX_WRITES) {
+		image->overflow = true;
+		return;
+	}
+
+	image->writes[image->count].addr = (uint32_t)addr;
+	image->writes[image->count].clr = clr;
+	image->writes[image->count].set = set;
+	image->count++;
+}
+
+static void dfs_image_write(const struct dfs_image *image)
+{
+	const struct dfs_reg_write *w;
+	uint32_t i;
+
+	for (i = 0; i < image->count; i++) {
+		w = &image->writes[i];
+		if (w->clr == 0xffffffff)
+			mmio_write_32(w->addr, w->set);
+		else
+			mmio_clrsetbits_32(w->addr, w->clr, w->set);
+	}
+}
+
+static void dfs_image_invalidate(void)
+{
+	uint32_t i, j;
+
+	for (i = 0; i < ARRAY_SIZE(dfs_images); i++) {
+		for (j = 0; j < ARRAY_SIZE(dfs_images[i]); j++) {
+			dfs_images[i][j].count = 0;
+			dfs_images[i][j].overflow = false;
+		}
+	}
+}
+
+/* Register accessors of the gen_rk3399_* functions, which record the writes */
+static void dfs_write_32(uintptr_t addr, uint32_t value)
+{
+	mmio_write_32(addr, value);
+	dfs_image_record(addr, 0xffffffff, value);
+}
+
+static void dfs_clrsetbits_32(uintptr_t addr, uint32_t clr, uint32_t set)
+{
+	mmio_clrsetbits_32(addr, clr, set);
+	dfs_image_record(addr, clr, set);
+}
+
+static void dfs_setbits_32(uintptr_t addr, uint32_t set)
+{
+	dfs_clrsetbits_32(addr, 0, set);
+}
+
+static void dfs_clrbits_32(uintptr_t addr, uint32_t clr)
+{
+	dfs_clrsetbits_32(addr, clr, 0);
+}
+
 static struct rk3399_sdram_default_config ddr3_default_config = {
 	.bl = 8,
 	.ap = 0,
@@ -495,171 +601,171 @@ static void gen_rk3399_ctl_params_f0(struct timing_related_config
 				999) / 1000;
 			tmp += pdram_timing->txsnr + (pdram_timing->tmrd * 3) +
 			    pdram_timing->tmod + pdram_timing->tzqinit;
-			mmio_write_32(CTL_REG(i, 5), tmp);
+			dfs_write_32(CTL_REG(i, 5), tmp);
 
-			mmio_clrsetbits_32(CTL_REG(i, 22), 0xffff,
-					   pdram_timing->tdllk);
+			dfs_clrsetbits_32(CTL_REG(i, 22), 0xffff,
+					  pdram_timing->tdllk);
 
-			mmio_write_32(CTL_REG(i, 32),
-				      (pdram_timing->tmod << 8) |
-				       pdram_timing->tmrd);
+			dfs_write_32(CTL_REG(i, 32),
+				     (pdram_timing->tmod << 8) |
+				      pdram_timing->tmrd);
 
-			mmio_clrsetbits_32(CTL_REG(i, 59), 0xffff << 16,
-					   (pdram_timing->txsr -
-					    pdram_timing->trcd) << 16);
+			dfs_clrsetbits_32(CTL_REG(i, 59), 0xffff << 16,
+					  (pdram_timing->txsr -
+					   pdram_timing->trcd) << 16);
 		} else if (timing_config->dram_type == LPDDR4) {
-			mmio_write_32(CTL_REG(i, 5), pdram_timing->tinit1 +
-						     pdram_timing->tinit3);
-			mmio_write_32(CTL_REG(i, 32),
-				      (pdram_timing->tmrd << 8) |
-				      pdram_timing->tmrd);
-			mmio_clrsetbits_32(CTL_REG(i, 59), 0xffff << 16,
-					   pdram_timing->txsr << 16);
+			dfs_write_32(CTL_REG(i, 5), pdram_timing->tinit1 +
+						    pdram_timing->tinit3);
+			dfs_write_32(CTL_REG(i, 32),
+				     (pdram_timing->tmrd << 8) |
+				     pdram_timing->tmrd);
+			dfs_clrsetbits_32(CTL_REG(i, 59), 0xffff << 16,
+					  pdram_timing->txsr << 16);
 		} else {
-			mmio_write_32(CTL_REG(i, 5), pdram_timing->tinit1);
-			mmio_write_32(CTL_REG(i, 7), pdram_timing->tinit4);
-			mmio_write_32(CTL_REG(i, 32),
-				      (pdram_timing->tmrd << 8) |
-				      pdram_timing->tmrd);
-			mmio_clrsetbits_32(CTL_REG(i, 59), 0xffff << 16,
-					   pdram_timing->txsr << 16);
+			dfs_write_32(CTL_REG(i, 5), pdram_timing->tinit1);
+			dfs_write_32(CTL_REG(i, 7), pdram_timing->tinit4);
+			dfs_write_32(CTL_REG(i, 32),
+				     (pdram_timing->tmrd << 8) |
+				     pdram_timing->tmrd);
+			dfs_clrsetbits_32(CTL_REG(i, 59), 0xffff << 16,
+					  pdram_timing->txsr << 16);
 		}
-		mmio_write_32(CTL_REG(i, 6), pdram_timing->tinit3);
-		mmio_write_32(CTL_REG(i, 8), pdram_timing->tinit5);
-		mmio_clrsetbits_32(CTL_REG(i, 23), (0x7f << 16),
-				   ((pdram_timing->cl * 2) << 16));
-		mmio_clrsetbits_32(CTL_REG(i, 23), (0x1f << 24),
-				   (pdram_timing->cwl << 24));
-		mmio_clrsetbits_32(CTL_REG(i, 24), 0x3f, pdram_timing->al);
-		mmio_clrsetbits_32(CTL_REG(i, 26), 0xffff << 16,
-				   (pdram_timing->trc << 24) |
-				   (pdram_timing->trrd << 16));
-		mmio_write_32(CTL_REG(i, 27),
-			      (pdram_timing->tfaw << 24) |
-			      (pdram_timing->trppb << 16) |
-			      (pdram_timing->twtr << 8) |
-			      pdram_timing->tras_min);
-
-		mmio_clrsetbits_32(CTL_REG(i, 31), 0xff << 24,
-				   max(4, pdram_timing->trtp) << 24);
-		mmio_write_32(CTL_REG(i, 33), (pdram_timing->tcke << 24) |
-					      pdram_timing->tras_max);
-		mmio_clrsetbits_32(CTL_REG(i, 34), 0xff,
-				   max(1, pdram_timing->tckesr));
-		mmio_clrsetbits_32(CTL_REG(i, 39),
-				   (0x3f << 16) | (0xff << 8),
-				   (pdram_timing->twr << 16) |
-				   (pdram_timing->trcd << 8));
-		mmio_clrsetbits_32(CTL_REG(i, 42), 0x1f << 16,
-				   pdram_timing->tmrz << 16);
+		dfs_write_32(CTL_REG(i, 6), pdram_timing->tinit3);
+		dfs_write_32(CTL_REG(i, 8), pdram_timing->tinit5);
+		dfs_clrsetbits_32(CTL_REG(i, 23), (0x7f << 16),
+				  ((pdram_timing->cl * 2) << 16));
+		dfs_clrsetbits_32(CTL_REG(i, 23), (0x1f << 24),
+				  (pdram_timing->cwl << 24));
+		dfs_clrsetbits_32(CTL_REG(i, 24), 0x3f, pdram_timing->al);
+		dfs_clrsetbits_32(CTL_REG(i, 26), 0xffff << 16,
+				  (pdram_timing->trc << 24) |
+				  (pdram_timing->trrd << 16));
+		dfs_write_32(CTL_REG(i, 27),
+			     (pdram_timing->tfaw << 24) |
+			     (pdram_timing->trppb << 16) |
+			     (pdram_timing->twtr << 8) |
+			     pdram_timing->tras_min);
+
+		dfs_clrsetbits_32(CTL_REG(i, 31), 0xff << 24,
+				  max(4, pdram_timing->trtp) << 24);
+		dfs_write_32(CTL_REG(i, 33), (pdram_timing->tcke << 24) |
+					     pdram_timing->tras_max);
+		dfs_clrsetbits_32(CTL_REG(i, 34), 0xff,
+				  max(1, pdram_timing->tckesr));
+		dfs_clrsetbits_32(CTL_REG(i, 39),
+				  (0x3f << 16) | (0xff << 8),
+				  (pdram_timing->twr << 16) |
+				  (pdram_timing->trcd << 8));
+		dfs_clrsetbits_32(CTL_REG(i, 42), 0x1f << 16,
+				  pdram_timing->tmrz << 16);
 		tmp = pdram_timing->tdal ? pdram_timing->tdal :
 		      (pdram_timing->twr + pdram_timing->trp);
-		mmio_clrsetbits_32(CTL_REG(i, 44), 0xff, tmp);
-		mmio_clrsetbits_32(CTL_REG(i, 45), 0xff, pdram_timing->trp);
-		mmio_write_32(CTL_REG(i, 48),
-			      ((pdram_timing->trefi - 8) << 16) |
-			      pdram_timing->trfc);
-		mmio_clrsetbits_32(CTL_REG(i, 52), 0xffff, pdram_timing->txp);
-		mmio_clrsetbits_32(CTL_REG(i, 53), 0xffff << 16,
-				   pdram_timing->txpdll << 16);
-		mmio_clrsetbits_32(CTL_REG(i, 55), 0xf << 24,
-				   pdram_timing->tcscke << 24);
-		mmio_clrsetbits_32(CTL_REG(i, 55), 0xff, pdram_timing->tmrri);
-		mmio_write_32(CTL_REG(i, 56),
-			      (pdram_timing->tzqcke << 24) |
-			      (pdram_timing->tmrwckel << 16) |
-			      (pdram_timing->tckehcs << 8) |
-			      pdram_timing->tckelcs);
-		mmio_clrsetbits_32(CTL_REG(i, 60), 0xffff, pdram_timing->txsnr);
-		mmio_clrsetbits_32(CTL_REG(i, 62), 0xffff << 16,
-				   (pdram_timing->tckehcmd << 24) |
-				   (pdram_timing->tckelcmd << 16));
-		mmio_write_32(CTL_REG(i, 63),
-			      (pdram_timing->tckelpd << 24) |
-			      (pdram_timing->tescke << 16) |
-			      (pdram_timing->tsr << 8) |
-			      pdram_timing->tckckel);
-		mmio_clrsetbits_32(CTL_REG(i, 64), 0xfff,
-				   (pdram_timing->tcmdcke << 8) |
-				   pdram_timing->tcsckeh);
-		mmio_clrsetbits_32(CTL_REG(i, 92), 0xffff << 8,
-				   (pdram_timing->tcksrx << 16) |
-				   (pdram_timing->tcksre << 8));
-		mmio_clrsetbits_32(CTL_REG(i, 108), 0x1 << 24,
-				   (timing_config->dllbp << 24));
-		mmio_clrsetbits_32(CTL_REG(i, 122), 0x3ff << 16,
-				   (pdram_timing->tvrcg_enable << 16));
-		mmio_write_32(CTL_REG(i, 123), (pdram_timing->tfc_long << 16) |
-					       pdram_timing->tvrcg_disable);
-		mmio_write_32(CTL_REG(i, 124),
-			      (pdram_timing->tvref_long << 16) |
-			      (pdram_timing->tckfspx << 8) |
-			      pdram_timing->tckfspe);
-		mmio_write_32(CTL_REG(i, 133), (pdram_timing->mr[1] << 16) |
-					       pdram_timing->mr[0]);
-		mmio_clrsetbits_32(CTL_REG(i, 134), 0xffff,
-				   pdram_timing->mr[2]);
-		mmio_clrsetbits_32(CTL_REG(i, 138), 0xffff,
-				   pdram_timing->mr[3]);
-		mmio_clrsetbits_32(CTL_REG(i, 139), 0xff << 24,
-				   pdram_timing->mr11 << 24);
-		mmio_write_32(CTL_REG(i, 147),
-			      (pdram_timing->mr[1] << 16) |
-			      pdram_timing->mr[0]);
-		mmio_clrsetbits_32(CTL_REG(i, 148), 0xffff,
-				   pdram_timing->mr[2]);
-		mmio_clrsetbits_32(CTL_REG(i, 152), 0xffff,
-				   pdram_timing->mr[3]);
-		mmio_clrsetbits_32(CTL_REG(i, 153), 0xff << 24,
-				   pdram_timing->mr11 << 24);
+		dfs_clrsetbits_32(CTL_REG(i, 44), 0xff, tmp);
+		dfs_clrsetbits_32(CTL_REG(i, 45), 0xff, pdram_timing->trp);
+		dfs_write_32(CTL_REG(i, 48),
+			     ((pdram_timing->trefi - 8) << 16) |
+			     pdram_timing->trfc);
+		dfs_clrsetbits_32(CTL_REG(i, 52), 0xffff, pdram_timing->txp);
+		dfs_clrsetbits_32(CTL_REG(i, 53), 0xffff << 16,
+				  pdram_timing->txpdll << 16);
+		dfs_clrsetbits_32(CTL_REG(i, 55), 0xf << 24,
+				  pdram_timing->tcscke << 24);
+		dfs_clrsetbits_32(CTL_REG(i, 55), 0xff, pdram_timing->tmrri);
+		dfs_write_32(CTL_REG(i, 56),
+			     (pdram_timing->tzqcke << 24) |
+			     (pdram_timing->tmrwckel << 16) |
+			     (pdram_timing->tckehcs << 8) |
+			     pdram_timing->tckelcs);
+		dfs_clrsetbits_32(CTL_REG(i, 60), 0xffff, pdram_timing->txsnr);
+		dfs_clrsetbits_32(CTL_REG(i, 62), 0xffff << 16,
+				  (pdram_timing->tckehcmd << 24) |
+				  (pdram_timing->tckelcmd << 16));
+		dfs_write_32(CTL_REG(i, 63),
+			     (pdram_timing->tckelpd << 24) |
+			     (pdram_timing->tescke << 16) |
+			     (pdram_timing->tsr << 8) |
+			     pdram_timing->tckckel);
+		dfs_clrsetbits_32(CTL_REG(i, 64), 0xfff,
+				  (pdram_timing->tcmdcke << 8) |
+				  pdram_timing->tcsckeh);
+		dfs_clrsetbits_32(CTL_REG(i, 92), 0xffff << 8,
+				  (pdram_timing->tcksrx << 16) |
+				  (pdram_timing->tcksre << 8));
+		dfs_clrsetbits_32(CTL_REG(i, 108), 0x1 << 24,
+				  (timing_config->dllbp << 24));
+		dfs_clrsetbits_32(CTL_REG(i, 122), 0x3ff << 16,
+				  (pdram_timing->tvrcg_enable << 16));
+		dfs_write_32(CTL_REG(i, 123), (pdram_timing->tfc_long << 16) |
+					      pdram_timing->tvrcg_disable);
+		dfs_write_32(CTL_REG(i, 124),
+			     (pdram_timing->tvref_long << 16) |
+			     (pdram_timing->tckfspx << 8) |
+			     pdram_timing->tckfspe);
+		dfs_write_32(CTL_REG(i, 133), (pdram_timing->mr[1] << 16) |
+					      pdram_timing->mr[0]);
+		dfs_clrsetbits_32(CTL_REG(i, 134), 0xffff,
+				  pdram_timing->mr[2]);
+		dfs_clrsetbits_32(CTL_REG(i, 138), 0xffff,
+				  pdram_timing->mr[3]);
+		dfs_clrsetbits_32(CTL_REG(i, 139), 0xff << 24,
+				  pdram_timing->mr11 << 24);
+		dfs_write_32(CTL_REG(i, 147),
+			     (pdram_timing->mr[1] << 16) |
+			     pdram_timing->mr[0]);
+		dfs_clrsetbits_32(CTL_REG(i, 148), 0xffff,
+				  pdram_timing->mr[2]);
+		dfs_clrsetbits_32(CTL_REG(i, 152), 0xffff,
+				  pdram_timing->mr[3]);
+		dfs_clrsetbits_32(CTL_REG(i, 153), 0xff << 24,
+				  pdram_timing->mr11 << 24);
 		if (timing_config->dram_type == LPDDR4) {
-			mmio_clrsetbits_32(CTL_REG(i, 140), 0xffff << 16,
-					   pdram_timing->mr12 << 16);
-			mmio_clrsetbits_32(CTL_REG(i, 142), 0xffff << 16,
-					   pdram_timing->mr14 << 16);
-			mmio_clrsetbits_32(CTL_REG(i, 145), 0xffff << 16,
-					   pdram_timing->mr22 << 16);
-			mmio_clrsetbits_32(CTL_REG(i, 154), 0xffff << 16,
-					   pdram_timing->mr12 << 16);
-			mmio_clrsetbits_32(CTL_REG(i, 156), 0xffff << 16,
-					   pdram_timing->mr14 << 16);
-			mmio_clrsetbits_32(CTL_REG(i, 159), 0xffff << 16,
-					   pdram_timing->mr22 << 16);
+			dfs_clrsetbits_32(CTL_REG(i, 140), 0xffff << 16,
+					  pdram_timing->mr12 << 16);
+			dfs_clrsetbits_32(CTL_REG(i, 142), 0xffff << 16,
+					  pdram_timing->mr14 << 16);
+			dfs_clrsetbits_32(CTL_REG(i, 145), 0xffff << 16,
+					  pdram_timing->mr22 << 16);
+			dfs_clrsetbits_32(CTL_REG(i, 154), 0xffff << 16,
+					  pdram_timing->mr12 << 16);
+			dfs_clrsetbits_32(CTL_REG(i, 156), 0xffff << 16,
+					  pdram_timing->mr14 << 16);
+			dfs_clrsetbits_32(CTL_REG(i, 159), 0xffff << 16,
+					  pdram_timing->mr22 << 16);
 		}
-		mmio_clrsetbits_32(CTL_REG(i, 179), 0xfff << 8,
-				   pdram_timing->tzqinit << 8);
-		mmio_write_32(CTL_REG(i, 180), (pdram_timing->tzqcs << 16) |
-					       (pdram_timing->tzqinit / 2));
-		mmio_write_32(CTL_REG(i, 181), (pdram_timing->tzqlat << 16) |
-					       pdram_timing->tzqcal);
-		mmio_clrsetbits_32(CTL_REG(i, 212), 0xff << 8,
-				   pdram_timing->todton << 8);
+		dfs_clrsetbits_32(CTL_REG(i, 179), 0xfff << 8,
+				  pdram_timing->tzqinit << 8);
+		dfs_write_32(CTL_REG(i, 180), (pdram_timing->tzqcs << 16) |
+					      (pdram_timing->tzqinit / 2));
+		dfs_write_32(CTL_REG(i, 181), (pdram_timing->tzqlat << 16) |
+					      pdram_timing->tzqcal);
+		dfs_clrsetbits_32(CTL_REG(i, 212), 0xff << 8,
+				  pdram_timing->todton << 8);
 
 		if (timing_config->odt) {
-			mmio_setbits_32(CTL_REG(i, 213), 1 << 16);
+			dfs_setbits_32(CTL_REG(i, 213), 1 << 16);
 			if (timing_config->freq < 400)
 				tmp = 4 << 24;
 			else
 				tmp = 8 << 24;
 		} else {
-			mmio_clrbits_32(CTL_REG(i, 213), 1 << 16);
+			dfs_clrbits_32(CTL_REG(i, 213), 1 << 16);
 			tmp = 2 << 24;
 		}
 
-		mmio_clrsetbits_32(CTL_REG(i, 216), 0x1f << 24, tmp);
-		mmio_clrsetbits_32(CTL_REG(i, 221), (0x3 << 16) | (0xf << 8),
-				   (pdram_timing->tdqsck << 16) |
-				   (pdram_timing->tdqsck_max << 8));
+		dfs_clrsetbits_32(CTL_REG(i, 216), 0x1f << 24, tmp);
+		dfs_clrsetbits_32(CTL_REG(i, 221), (0x3 << 16) | (0xf << 8),
+				  (pdram_timing->tdqsck << 16) |
+				  (pdram_timing->tdqsck_max << 8));
 		tmp =
 		    (get_wrlat_adj(timing_config->dram_type, pdram_timing->cwl)
 		     << 8) | get_rdlat_adj(timing_config->dram_type,
 					   pdram_timing->cl);
-		mmio_clrsetbits_32(CTL_REG(i, 284), 0xffff, tmp);
-		mmio_clrsetbits_32(CTL_REG(i, 82), 0xffff << 16,
-				   (4 * pdram_timing->trefi) << 16);
+		dfs_clrsetbits_32(CTL_REG(i, 284), 0xffff, tmp);
+		dfs_clrsetbits_32(CTL_REG(i, 82), 0xffff << 16,
+				  (4 * pdram_timing->trefi) << 16);
 
-		mmio_clrsetbits_32(CTL_REG(i, 83), 0xffff,
-				   (2 * pdram_timing->trefi) & 0xffff);
+		dfs_clrsetbits_32(CTL_REG(i, 83), 0xffff,
+				  (2 * pdram_timing->trefi) & 0xffff);
 
 		if ((timing_config->dram_type == LPDDR3) ||
 		    (timing_config->dram_type == LPDDR4)) {
@@ -669,8 +775,8 @@ static void gen_rk3399_ctl_params_f0(struct timing_related_config
 		} else {
 			tmp = 0;
 		}
-		mmio_clrsetbits_32(CTL_REG(i, 214), 0x3f << 16,
-				   (tmp & 0x3f) << 16);
+		dfs_clrsetbits_32(CTL_REG(i, 214), 0x3f << 16,
+				  (tmp & 0x3f) << 16);
 
 		if ((timing_config->dram_type == LPDDR3) ||
 		    (timing_config->dram_type == LPDDR4)) {
@@ -683,32 +789,32 @@ static void gen_rk3399_ctl_params_f0(struct timing_related_config
 		} else {
 			tmp = pdram_timing->cl - pdram_timing->cwl;
 		}
-		mmio_clrsetbits_32(CTL_REG(i, 215), 0x3f << 8,
-				   (tmp & 0x3f) << 8);
+		dfs_clrsetbits_32(CTL_REG(i, 215), 0x3f << 8,
+				  (tmp & 0x3f) << 8);
 
-		mmio_clrsetbits_32(CTL_REG(i, 275), 0xff << 16,
-				   (get_pi_tdfi_phy_rdlat(pdram_timing,
-							  timing_config) &
-				    0xff) << 16);
+		dfs_clrsetbits_32(CTL_REG(i, 275), 0xff << 16,
+				  (get_pi_tdfi_phy_rdlat(pdram_timing,
+							 timing_config) &
+				   0xff) << 16);
 
-		mmio_clrsetbits_32(CTL_REG(i, 277), 0xffff,
-				   (2 * pdram_timing->trefi) & 0xffff);
+		dfs_clrsetbits_32(CTL_REG(i, 277), 0xffff,
+				  (2 * pdram_timing->trefi) & 0xffff);
 
-		mmio_clrsetbits_32(CTL_REG(i, 282), 0xffff,
-				   (2 * pdram_timing->trefi) & 0xffff);
+		dfs_clrsetbits_32(CTL_REG(i, 282), 0xffff,
+				  (2 * pdram_timing->trefi) & 0xffff);
 
-		mmio_write_32(CTL_REG(i, 283), 20 * pdram_timing->trefi);
+		dfs_write_32(CTL_REG(i, 283), 20 * pdram_timing->trefi);
 
 		/* CTL_308 TDFI_CALVL_CAPTURE_F0:RW:16:10 */
 		tmp1 = 20000 / (1000000 / pdram_timing->mhz) + 1;
 		if ((20000 % (1000000 / pdram_timing->mhz)) != 0)
 			tmp1++;
 		tmp = (tmp1 >> 1) + (tmp1 % 2) + 5;
-		mmio_clrsetbits_32(CTL_REG(i, 308), 0x3ff << 16, tmp << 16);
+		dfs_clrsetbits_32(CTL_REG(i, 308), 0x3ff << 16, tmp << 16);
 
 		/* CTL_308 TDFI_CALVL_CC_F0:RW:0:10 */
 		tmp = tmp + 18;
-		mmio_clrsetbits_32(CTL_REG(i, 308), 0x3ff, tmp);
+		dfs_clrsetbits_32(CTL_REG(i, 308), 0x3ff, tmp);
 
 		/* CTL_314 TDFI_WRCSLAT_F0:RW:8:8 */
 		tmp1 = get_pi_wrlat_adj(pdram_timing, timing_config);
@@ -722,7 +828,7 @@ static void gen_rk3399_ctl_params_f0(struct timing_related_config
 		} else {
 			tmp = tmp1 - 2;
 		}
-		mmio_clrsetbits_32(CTL_REG(i, 314), 0xff << 8, tmp << 8);
+		dfs_clrsetbits_32(CTL_REG(i, 314), 0xff << 8, tmp << 8);
 
 		/* CTL_314 TDFI_RDCSLAT_F0:RW:0:8 */
 		if ((timing_config->freq <= TDFI_LAT_THRESHOLD_FREQ) &&
@@ -730,7 +836,7 @@ static void gen_rk3399_ctl_params_f0(struct timing_related_config
 			tmp = pdram_timing->cl - 5;
 		else
 			tmp = pdram_timing->cl - 2;
-		mmio_clrsetbits_32(CTL_REG(i, 314), 0xff, tmp);
+		dfs_clrsetbits_32(CTL_REG(i, 314), 0xff, tmp);
 	}
 }
 
@@ -747,168 +853,168 @@ static void gen_rk3399_ctl_params_f1(struct timing_related_config
 			    ((700000 + 10) * timing_config->freq + 999) / 1000;
 			tmp += pdram_timing->txsnr + (pdram_timing->tmrd * 3) +
 			       pdram_timing->tmod + pdram_timing->tzqinit;
-			mmio_write_32(CTL_REG(i, 9), tmp);
-			mmio_clrsetbits_32(CTL_REG(i, 22), 0xffff << 16,
-					   pdram_timing->tdllk << 16);
-			mmio_clrsetbits_32(CTL_REG(i, 34), 0xffffff00,
-					   (pdram_timing->tmod << 24) |
-					   (pdram_timing->tmrd << 16) |
-					   (pdram_timing->trtp << 8));
-			mmio_clrsetbits_32(CTL_REG(i, 60), 0xffff << 16,
-					   (pdram_timing->txsr -
-					    pdram_timing->trcd) << 16);
+			dfs_write_32(CTL_REG(i, 9), tmp);
+			dfs_clrsetbits_32(CTL_REG(i, 22), 0xffff << 16,
+					  pdram_timing->tdllk << 16);
+			dfs_clrsetbits_32(CTL_REG(i, 34), 0xffffff00,
+					  (pdram_timing->tmod << 24) |
+					  (pdram_timing->tmrd << 16) |
+					  (pdram_timing->trtp << 8));
+			dfs_clrsetbits_32(CTL_REG(i, 60), 0xffff << 16,
+					  (pdram_timing->txsr -
+					   pdram_timing->trcd) << 16);
 		} else if (timing_config->dram_type == LPDDR4) {
-			mmio_write_32(CTL_REG(i, 9), pdram_timing->tinit1 +
-						     pdram_timing->tinit3);
-			mmio_clrsetbits_32(CTL_REG(i, 34), 0xffffff00,
-					   (pdram_timing->tmrd << 24) |
-					   (pdram_timing->tmrd << 16) |
-					   (pdram_timing->trtp << 8));
-			mmio_clrsetbits_32(CTL_REG(i, 60), 0xffff << 16,
-					   pdram_timing->txsr << 16);
+			dfs_write_32(CTL_REG(i, 9), pdram_timing->tinit1 +
+						    pdram_timing->tinit3);
+			dfs_clrsetbits_32(CTL_REG(i, 34), 0xffffff00,
+					  (pdram_timing->tmrd << 24) |
+					  (pdram_timing->tmrd << 16) |
+					  (pdram_timing->trtp << 8));
+			dfs_clrsetbits_32(CTL_REG(i, 60), 0xffff << 16,
+					  pdram_timing->txsr << 16);
 		} else {
-			mmio_write_32(CTL_REG(i, 9), pdram_timing->tinit1);
-			mmio_write_32(CTL_REG(i, 11), pdram_timing->tinit4);
-			mmio_clrsetbits_32(CTL_REG(i, 34), 0xffffff00,
-					   (pdram_timing->tmrd << 24) |
-					   (pdram_timing->tmrd << 16) |
-					   (pdram_timing->trtp << 8));
-			mmio_clrsetbits_32(CTL_REG(i, 60), 0xffff << 16,
-					   pdram_timing->txsr << 16);
+			dfs_write_32(CTL_REG(i, 9), pdram_timing->tinit1);
+			dfs_write_32(CTL_REG(i, 11), pdram_timing->tinit4);
+			dfs_clrsetbits_32(CTL_REG(i, 34), 0xffffff00,
+					  (pdram_timing->tmrd << 24) |
+					  (pdram_timing->tmrd << 16) |
+					  (pdram_timing->trtp << 8));
+			dfs_clrsetbits_32(CTL_REG(i, 60), 0xffff << 16,
+					  pdram_timing->txsr << 16);
 		}
-		mmio_write_32(CTL_REG(i, 10), pdram_timing->tinit3);
-		mmio_write_32(CTL_REG(i, 12), pdram_timing->tinit5);
-		mmio_clrsetbits_32(CTL_REG(i, 24), (0x7f << 8),
-				   ((pdram_timing->cl * 2) << 8));
-		mmio_clrsetbits_32(CTL_REG(i, 24), (0x1f << 16),
-				   (pdram_timing->cwl << 16));
-		mmio_clrsetbits_32(CTL_REG(i, 24), 0x3f << 24,
-				   pdram_timing->al << 24);
-		mmio_clrsetbits_32(CTL_REG(i, 28), 0xffffff00,
-				   (pdram_timing->tras_min << 24) |
-				   (pdram_timing->trc << 16) |
-				   (pdram_timing->trrd << 8));
-		mmio_clrsetbits_32(CTL_REG(i, 29), 0xffffff,
-				   (pdram_timing->tfaw << 16) |
-				   (pdram_timing->trppb << 8) |
-				   pdram_timing->twtr);
-		mmio_write_32(CTL_REG(i, 35), (pdram_timing->tcke << 24) |
-					      pdram_timing->tras_max);
-		mmio_clrsetbits_32(CTL_REG(i, 36), 0xff,
-				   max(1, pdram_timing->tckesr));
-		mmio_clrsetbits_32(CTL_REG(i, 39), (0xff << 24),
-				   (pdram_timing->trcd << 24));
-		mmio_clrsetbits_32(CTL_REG(i, 40), 0x3f, pdram_timing->twr);
-		mmio_clrsetbits_32(CTL_REG(i, 42), 0x1f << 24,
-				   pdram_timing->tmrz << 24);
+		dfs_write_32(CTL_REG(i, 10), pdram_timing->tinit3);
+		dfs_write_32(CTL_REG(i, 12), pdram_timing->tinit5);
+		dfs_clrsetbits_32(CTL_REG(i, 24), (0x7f << 8),
+				  ((pdram_timing->cl * 2) << 8));
+		dfs_clrsetbits_32(CTL_REG(i, 24), (0x1f << 16),
+				  (pdram_timing->cwl << 16));
+		dfs_clrsetbits_32(CTL_REG(i, 24), 0x3f << 24,
+				  pdram_timing->al << 24);
+		dfs_clrsetbits_32(CTL_REG(i, 28), 0xffffff00,
+				  (pdram_timing->tras_min << 24) |
+				  (pdram_timing->trc << 16) |
+				  (pdram_timing->trrd << 8));
+		dfs_clrsetbits_32(CTL_REG(i, 29), 0xffffff,
+				  (pdram_timing->tfaw << 16) |
+				  (pdram_timing->trppb << 8) |
+				  pdram_timing->twtr);
+		dfs_write_32(CTL_REG(i, 35), (pdram_timing->tcke << 24) |
+					     pdram_timing->tras_max);
+		dfs_clrsetbits_32(CTL_REG(i, 36), 0xff,
+				  max(1, pdram_timing->tckesr));
+		dfs_clrsetbits_32(CTL_REG(i, 39), (0xff << 24),
+				  (pdram_timing->trcd << 24));
+		dfs_clrsetbits_32(CTL_REG(i, 40), 0x3f, pdram_timing->twr);
+		dfs_clrsetbits_32(CTL_REG(i, 42), 0x1f << 24,
+				  pdram_timing->tmrz << 24);
 		tmp = pdram_timing->tdal ? pdram_timing->tdal :
 		      (pdram_timing->twr + pdram_timing->trp);
-		mmio_clrsetbits_32(CTL_REG(i, 44), 0xff << 8, tmp << 8);
-		mmio_clrsetbits_32(CTL_REG(i, 45), 0xff << 8,
-				   pdram_timing->trp << 8);
-		mmio_write_32(CTL_REG(i, 49),
-			      ((pdram_timing->trefi - 8) << 16) |
-			      pdram_timing->trfc);
-		mmio_clrsetbits_32(CTL_REG(i, 52), 0xffff << 16,
-				   pdram_timing->txp << 16);
-		mmio_clrsetbits_32(CTL_REG(i, 54), 0xffff,
-				   pdram_timing->txpdll);
-		mmio_clrsetbits_32(CTL_REG(i, 55), 0xff << 8,
-				   pdram_timing->tmrri << 8);
-		mmio_write_32(CTL_REG(i, 57), (pdram_timing->tmrwckel << 24) |
-					      (pdram_timing->tckehcs << 16) |
-					      (pdram_timing->tckelcs << 8) |
-					      pdram_timing->tcscke);
-		mmio_clrsetbits_32(CTL_REG(i, 58), 0xf, pdram_timing->tzqcke);
-		mmio_clrsetbits_32(CTL_REG(i, 61), 0xffff, pdram_timing->txsnr);
-		mmio_clrsetbits_32(CTL_REG(i, 64), 0xffff << 16,
-				   (pdram_timing->tckehcmd << 24) |
-				   (pdram_timing->tckelcmd << 16));
-		mmio_write_32(CTL_REG(i, 65), (pdram_timing->tckelpd << 24) |
-					      (pdram_timing->tescke << 16) |
-					      (pdram_timing->tsr << 8) |
-					      pdram_timing->tckckel);
-		mmio_clrsetbits_32(CTL_REG(i, 66), 0xfff,
-				   (pdram_timing->tcmdcke << 8) |
-				   pdram_timing->tcsckeh);
-		mmio_clrsetbits_32(CTL_REG(i, 92), (0xff << 24),
-				   (pdram_timing->tcksre << 24));
-		mmio_clrsetbits_32(CTL_REG(i, 93), 0xff,
-				   pdram_timing->tcksrx);
-		mmio_clrsetbits_32(CTL_REG(i, 108), (0x1 << 25),
-				   (timing_config->dllbp << 25));
-		mmio_write_32(CTL_REG(i, 125),
-			      (pdram_timing->tvrcg_disable << 16) |
-			      pdram_timing->tvrcg_enable);
-		mmio_write_32(CTL_REG(i, 126), (pdram_timing->tckfspx << 24) |
-					       (pdram_timing->tckfspe << 16) |
-					       pdram_timing->tfc_long);
-		mmio_clrsetbits_32(CTL_REG(i, 127), 0xffff,
-				   pdram_timing->tvref_long);
-		mmio_clrsetbits_32(CTL_REG(i, 134), 0xffff << 16,
-				   pdram_timing->mr[0] << 16);
-		mmio_write_32(CTL_REG(i, 135), (pdram_timing->mr[2] << 16) |
-					       pdram_timing->mr[1]);
-		mmio_clrsetbits_32(CTL_REG(i, 138), 0xffff << 16,
-				   pdram_timing->mr[3] << 16);
-		mmio_clrsetbits_32(CTL_REG(i, 140), 0xff, pdram_timing->mr11);
-		mmio_clrsetbits_32(CTL_REG(i, 148), 0xffff << 16,
-				   pdram_timing->mr[0] << 16);
-		mmio_write_32(CTL_REG(i, 149), (pdram_timing->mr[2] << 16) |
-					       pdram_timing->mr[1]);
-		mmio_clrsetbits_32(CTL_REG(i, 152), 0xffff << 16,
-				   pdram_timing->mr[3] << 16);
-		mmio_clrsetbits_32(CTL_REG(i, 154), 0xff, pdram_timing->mr11);
+		dfs_clrsetbits_32(CTL_REG(i, 44), 0xff << 8, tmp << 8);
+		dfs_clrsetbits_32(CTL_REG(i, 45), 0xff << 8,
+				  pdram_timing->trp << 8);
+		dfs_write_32(CTL_REG(i, 49),
+			     ((pdram_timing->trefi - 8) << 16) |
+			     pdram_timing->trfc);
+		dfs_clrsetbits_32(CTL_REG(i, 52), 0xffff << 16,
+				  pdram_timing->txp << 16);
+		dfs_clrsetbits_32(CTL_REG(i, 54), 0xffff,
+				  pdram_timing->txpdll);
+		dfs_clrsetbits_32(CTL_REG(i, 55), 0xff << 8,
+				  pdram_timing->tmrri << 8);
+		dfs_write_32(CTL_REG(i, 57), (pdram_timing->tmrwckel << 24) |
+					     (pdram_timing->tckehcs << 16) |
+					     (pdram_timing->tckelcs << 8) |
+					     pdram_timing->tcscke);
+		dfs_clrsetbits_32(CTL_REG(i, 58), 0xf, pdram_timing->tzqcke);
+		dfs_clrsetbits_32(CTL_REG(i, 61), 0xffff, pdram_timing->txsnr);
+		dfs_clrsetbits_32(CTL_REG(i, 64), 0xffff << 16,
+				  (pdram_timing->tckehcmd << 24) |
+				  (pdram_timing->tckelcmd << 16));
+		dfs_write_32(CTL_REG(i, 65), (pdram_timing->tckelpd << 24) |
+					     (pdram_timing->tescke << 16) |
+					     (pdram_timing->tsr << 8) |
+					     pdram_timing->tckckel);
+		dfs_clrsetbits_32(CTL_REG(i, 66), 0xfff,
+				  (pdram_timing->tcmdcke << 8) |
+				  pdram_timing->tcsckeh);
+		dfs_clrsetbits_32(CTL_REG(i, 92), (0xff << 24),
+				  (pdram_timing->tcksre << 24));
+		dfs_clrsetbits_32(CTL_REG(i, 93), 0xff,
+				  pdram_timing->tcksrx);
+		dfs_clrsetbits_32(CTL_REG(i, 108), (0x1 << 25),
+				  (timing_config->dllbp << 25));
+		dfs_write_32(CTL_REG(i, 125),
+			     (pdram_timing->tvrcg_disable << 16) |
+			     pdram_timing->tvrcg_enable);
+		dfs_write_32(CTL_REG(i, 126), (pdram_timing->tckfspx << 24) |
+					      (pdram_timing->tckfspe << 16) |
+					      pdram_timing->tfc_long);
+		dfs_clrsetbits_32(CTL_REG(i, 127), 0xffff,
+				  pdram_timing->tvref_long);
+		dfs_clrsetbits_32(CTL_REG(i, 134), 0xffff << 16,
+				  pdram_timing->mr[0] << 16);
+		dfs_write_32(CTL_REG(i, 135), (pdram_timing->mr[2] << 16) |
+					      pdram_timing->mr[1]);
+		dfs_clrsetbits_32(CTL_REG(i, 138), 0xffff << 16,
+				  pdram_timing->mr[3] << 16);
+		dfs_clrsetbits_32(CTL_REG(i, 140), 0xff, pdram_timing->mr11);
+		dfs_clrsetbits_32(CTL_REG(i, 148), 0xffff << 16,
+				  pdram_timing->mr[0] << 16);
+		dfs_write_32(CTL_REG(i, 149), (pdram_timing->mr[2] << 16) |
+					      pdram_timing->mr[1]);
+		dfs_clrsetbits_32(CTL_REG(i, 152), 0xffff << 16,
+				  pdram_timing->mr[3] << 16);
+		dfs_clrsetbits_32(CTL_REG(i, 154), 0xff, pdram_timing->mr11);
 		if (timing_config->dram_type == LPDDR4) {
-			mmio_clrsetbits_32(CTL_REG(i, 141), 0xffff,
-					   pdram_timing->mr12);
-			mmio_clrsetbits_32(CTL_REG(i, 143), 0xffff,
-					   pdram_timing->mr14);
-			mmio_clrsetbits_32(CTL_REG(i, 146), 0xffff,
-					   pdram_timing->mr22);
-			mmio_clrsetbits_32(CTL_REG(i, 155), 0xffff,
-					   pdram_timing->mr12);
-			mmio_clrsetbits_32(CTL_REG(i, 157), 0xffff,
-					   pdram_timing->mr14);
-			mmio_clrsetbits_32(CTL_REG(i, 160), 0xffff,
-					   pdram_timing->mr22);
+			dfs_clrsetbits_32(CTL_REG(i, 141), 0xffff,
+					  pdram_timing->mr12);
+			dfs_clrsetbits_32(CTL_REG(i, 143), 0xffff,
+					  pdram_timing->mr14);
+			dfs_clrsetbits_32(CTL_REG(i, 146), 0xffff,
+					  pdram_timing->mr22);
+			dfs_clrsetbits_32(CTL_REG(i, 155), 0xffff,
+					  pdram_timing->mr12);
+			dfs_clrsetbits_32(CTL_REG(i, 157), 0xffff,
+					  pdram_timing->mr14);
+			dfs_clrsetbits_32(CTL_REG(i, 160), 0xffff,
+					  pdram_timing->mr22);
 		}
-		mmio_write_32(CTL_REG(i, 182),
-			      ((pdram_timing->tzqinit / 2) << 16) |
-			      pdram_timing->tzqinit);
-		mmio_write_32(CTL_REG(i, 183), (pdram_timing->tzqcal << 16) |
-					       pdram_timing->tzqcs);
-		mmio_clrsetbits_32(CTL_REG(i, 184), 0x3f, pdram_timing->tzqlat);
-		mmio_clrsetbits_32(CTL_REG(i, 188), 0xfff,
-				   pdram_timing->tzqreset);
-		mmio_clrsetbits_32(CTL_REG(i, 212), 0xff << 16,
-				   pdram_timing->todton << 16);
+		dfs_write_32(CTL_REG(i, 182),
+			     ((pdram_timing->tzqinit / 2) << 16) |
+			     pdram_timing->tzqinit);
+		dfs_write_32(CTL_REG(i, 183), (pdram_timing->tzqcal << 16) |
+					      pdram_timing->tzqcs);
+		dfs_clrsetbits_32(CTL_REG(i, 184), 0x3f, pdram_timing->tzqlat);
+		dfs_clrsetbits_32(CTL_REG(i, 188), 0xfff,
+				  pdram_timing->tzqreset);
+		dfs_clrsetbits_32(CTL_REG(i, 212), 0xff << 16,
+				  pdram_timing->todton << 16);
 
 		if (timing_config->odt) {
-			mmio_setbits_32(CTL_REG(i, 213), (1 << 24));
+			dfs_setbits_32(CTL_REG(i, 213), (1 << 24));
 			if (timing_config->freq < 400)
 				tmp = 4 << 24;
 			else
 				tmp = 8 << 24;
 		} else {
-			mmio_clrbits_32(CTL_REG(i, 213), (1 << 24));
+			dfs_clrbits_32(CTL_REG(i, 213), (1 << 24));
 			tmp = 2 << 24;
 		}
-		mmio_clrsetbits_32(CTL_REG(i, 217), 0x1f << 24, tmp);
-		mmio_clrsetbits_32(CTL_REG(i, 221), 0xf << 24,
-				   (pdram_timing->tdqsck_max << 24));
-		mmio_clrsetbits_32(CTL_REG(i, 222), 0x3, pdram_timing->tdqsck);
-		mmio_clrsetbits_32(CTL_REG(i, 291), 0xffff,
-				   (get_wrlat_adj(timing_config->dram_type,
-						  pdram_timing->cwl) << 8) |
-				   get_rdlat_adj(timing_config->dram_type,
-						 pdram_timing->cl));
-
-		mmio_clrsetbits_32(CTL_REG(i, 84), 0xffff,
-				   (4 * pdram_timing->trefi) & 0xffff);
-
-		mmio_clrsetbits_32(CTL_REG(i, 84), 0xffff << 16,
-				   ((2 * pdram_timing->trefi) & 0xffff) << 16);
+		dfs_clrsetbits_32(CTL_REG(i, 217), 0x1f << 24, tmp);
+		dfs_clrsetbits_32(CTL_REG(i, 221), 0xf << 24,
+				  (pdram_timing->tdqsck_max << 24));
+		dfs_clrsetbits_32(CTL_REG(i, 222), 0x3, pdram_timing->tdqsck);
+		dfs_clrsetbits_32(CTL_REG(i, 291), 0xffff,
+				  (get_wrlat_adj(timing_config->dram_type,
+						 pdram_timing->cwl) << 8) |
+				  get_rdlat_adj(timing_config->dram_type,
+						pdram_timing->cl));
+
+		dfs_clrsetbits_32(CTL_REG(i, 84), 0xffff,
+				  (4 * pdram_timing->trefi) & 0xffff);
+
+		dfs_clrsetbits_32(CTL_REG(i, 84), 0xffff << 16,
+				  ((2 * pdram_timing->trefi) & 0xffff) << 16);
 
 		if ((timing_config->dram_type == LPDDR3) ||
 		    (timing_config->dram_type == LPDDR4)) {
@@ -918,8 +1024,8 @@ static void gen_rk3399_ctl_params_f1(struct timing_related_config
 		} else {
 			tmp = 0;
 		}
-		mmio_clrsetbits_32(CTL_REG(i, 214), 0x3f << 24,
-				   (tmp & 0x3f) << 24);
+		dfs_clrsetbits_32(CTL_REG(i, 214), 0x3f << 24,
+				  (tmp & 0x3f) << 24);
 
 		if ((timing_config->dram_type == LPDDR3) ||
 		    (timing_config->dram_type == LPDDR4)) {
@@ -933,32 +1039,32 @@ static void gen_rk3399_ctl_params_f1(struct timing_related_config
 		} else {
 			tmp = pdram_timing->cl - pdram_timing->cwl;
 		}
-		mmio_clrsetbits_32(CTL_REG(i, 215), 0x3f << 16,
-				   (tmp & 0x3f) << 16);
+		dfs_clrsetbits_32(CTL_REG(i, 215), 0x3f << 16,
+				  (tmp & 0x3f) << 16);
 
-		mmio_clrsetbits_32(CTL_REG(i, 275), 0xff << 24,
-				   (get_pi_tdfi_phy_rdlat(pdram_timing,
-							  timing_config) &
-				    0xff) << 24);
+		dfs_clrsetbits_32(CTL_REG(i, 275), 0xff << 24,
+				  (get_pi_tdfi_phy_rdlat(pdram_timing,
+							 timing_config) &
+				   0xff) << 24);
 
-		mmio_clrsetbits_32(CTL_REG(i, 284), 0xffff << 16,
-				   ((2 * pdram_timing->trefi) & 0xffff) << 16);
+		dfs_clrsetbits_32(CTL_REG(i, 284), 0xffff << 16,
+				  ((2 * pdram_timing->trefi) & 0xffff) << 16);
 
-		mmio_clrsetbits_32(CTL_REG(i, 289), 0xffff,
-				   (2 * pdram_timing->trefi) & 0xffff);
+		dfs_clrsetbits_32(CTL_REG(i, 289), 0xffff,
+				  (2 * pdram_timing->trefi) & 0xffff);
 
-		mmio_write_32(CTL_REG(i, 290), 20 * pdram_timing->trefi);
+		dfs_write_32(CTL_REG(i, 290), 20 * pdram_timing->trefi);
 
 		/* CTL_309 TDFI_CALVL_CAPTURE_F1:RW:16:10 */
 		tmp1 = 20000 / (1000000 / pdram_timing->mhz) + 1;
 		if ((20000 % (1000000 / pdram_timing->mhz)) != 0)
 			tmp1++;
 		tmp = (tmp1 >> 1) + (tmp1 % 2) + 5;
-		mmio_clrsetbits_32(CTL_REG(i, 309), 0x3ff << 16, tmp << 16);
+		dfs_clrsetbits_32(CTL_REG(i, 309), 0x3ff << 16, tmp << 16);
 
 		/* CTL_309 TDFI_CALVL_CC_F1:RW:0:10 */
 		tmp = tmp + 18;
-		mmio_clrsetbits_32(CTL_REG(i, 309), 0x3ff, tmp);
+		dfs_clrsetbits_32(CTL_REG(i, 309), 0x3ff, tmp);
 
 		/* CTL_314 TDFI_WRCSLAT_F1:RW:24:8 */
 		tmp1 = get_pi_wrlat_adj(pdram_timing, timing_config);
@@ -973,7 +1079,7 @@ static void gen_rk3399_ctl_params_f1(struct timing_related_config
 			tmp = tmp1 - 2;
 		}
 
-		mmio_clrsetbits_32(CTL_REG(i, 314), 0xff << 24, tmp << 24);
+		dfs_clrsetbits_32(CTL_REG(i, 314), 0xff << 24, tmp << 24);
 
 		/* CTL_314 TDFI_RDCSLAT_F1:RW:16:8 */
 		if ((timing_config->freq <= TDFI_LAT_THRESHOLD_FREQ) &&
@@ -981,7 +1087,7 @@ static void gen_rk3399_ctl_params_f1(struct timing_related_config
 			tmp = pdram_timing->cl - 5;
 		else
 			tmp = pdram_timing->cl - 2;
-		mmio_clrsetbits_32(CTL_REG(i, 314), 0xff << 16, tmp << 16);
+		dfs_clrsetbits_32(CTL_REG(i, 314), 0xff << 16, tmp << 16);
 	}
 }
 
@@ -1031,12 +1137,12 @@ static void gen_rk3399_pi_params_f0(struct timing_related_config *timing_config,
 	for (i = 0; i < timing_config->ch_cnt; i++) {
 		/* PI_02 PI_TDFI_PHYMSTR_MAX_F0:RW:0:32 */
 		tmp = 4 * pdram_timing->trefi;
-		mmio_write_32(PI_REG(i, 2), tmp);
+		dfs_write_32(PI_REG(i, 2), tmp);
 		/* PI_03 PI_TDFI_PHYMSTR_RESP_F0:RW:0:16 */
 		tmp = 2 * pdram_timing->trefi;
-		mmio_clrsetbits_32(PI_REG(i, 3), 0xffff, tmp);
+		dfs_clrsetbits_32(PI_REG(i, 3), 0xffff, tmp);
 		/* PI_07 PI_TDFI_PHYUPD_RESP_F0:RW:16:16 */
-		mmio_clrsetbits_32(PI_REG(i, 7), 0xffff << 16, tmp << 16);
+		dfs_clrsetbits_32(PI_REG(i, 7), 0xffff << 16, tmp << 16);
 
 		/* PI_42 PI_TDELAY_RDWR_2_BUS_IDLE_F0:RW:0:8 */
 		if (timing_config->dram_type == LPDDR4)
@@ -1046,29 +1152,29 @@ static void gen_rk3399_pi_params_f0(struct timing_related_config *timing_config,
 		tmp = (pdram_timing->bl / 2) + 4 +
 		      (get_pi_rdlat_adj(pdram_timing) - 2) + tmp +
 		      get_pi_tdfi_phy_rdlat(pdram_timing, timing_config);
-		mmio_clrsetbits_32(PI_REG(i, 42), 0xff, tmp);
+		dfs_clrsetbits_32(PI_REG(i, 42), 0xff, tmp);
 		/* PI_43 PI_WRLAT_F0:RW:0:5 */
 		if (timing_config->dram_type == LPDDR3) {
 			tmp = get_pi_wrlat(pdram_timing, timing_config);
-			mmio_clrsetbits_32(PI_REG(i, 43), 0x1f, tmp);
+			dfs_clrsetbits_32(PI_REG(i, 43), 0x1f, tmp);
 		}
 		/* PI_43 PI_ADDITIVE_LAT_F0:RW:8:6 */
-		mmio_clrsetbits_32(PI_REG(i, 43), 0x3f << 8,
-				   PI_ADD_LATENCY << 8);
+		dfs_clrsetbits_32(PI_REG(i, 43), 0x3f << 8,
+				  PI_ADD_LATENCY << 8);
 
 		/* PI_43 PI_CASLAT_LIN_F0:RW:16:7 */
-		mmio_clrsetbits_32(PI_REG(i, 43), 0x7f << 16,
-				   (pdram_timing->cl * 2) << 16);
+		dfs_clrsetbits_32(PI_REG(i, 43), 0x7f << 16,
+				  (pdram_timing->cl * 2) << 16);
 		/* PI_46 PI_TREF_F0:RW:16:16 */
-		mmio_clrsetbits_32(PI_REG(i, 46), 0xffff << 16,
-				   pdram_timing->trefi << 16);
+		dfs_clrsetbits_32(PI_REG(i, 46), 0xffff << 16,
+				  pdram_timing->trefi << 16);
 		/* PI_46 PI_TRFC_F0:RW:0:10 */
-		mmio_clrsetbits_32(PI_REG(i, 46), 0x3ff, pdram_timing->trfc);
+		dfs_clrsetbits_32(PI_REG(i, 46), 0x3ff, pdram_timing->trfc);
 		/* PI_66 PI_TODTL_2CMD_F0:RW:24:8 */
 		if (timing_config->dram_type == LPDDR3) {
 			tmp = get_pi_todtoff_max(pdram_timing, timing_config);
-			mmio_clrsetbits_32(PI_REG(i, 66), 0xff << 24,
-					   tmp << 24);
+			dfs_clrsetbits_32(PI_REG(i, 66), 0xff << 24,
+					  tmp << 24);
 		}
 		/* PI_72 PI_WR_TO_ODTH_F0:RW:16:6 */
 		if ((timing_config->dram_type == LPDDR3) ||
@@ -1082,7 +1188,7 @@ static void gen_rk3399_pi_params_f0(struct timing_related_config *timing_config,
 		} else if (timing_config->dram_type == DDR3) {
 			tmp = 0;
 		}
-		mmio_clrsetbits_32(PI_REG(i, 72), 0x3f << 16, tmp << 16);
+		dfs_clrsetbits_32(PI_REG(i, 72), 0x3f << 16, tmp << 16);
 		/* PI_73 PI_RD_TO_ODTH_F0:RW:8:6 */
 		if ((timing_config->dram_type == LPDDR3) ||
 		    (timing_config->dram_type == LPDDR4)) {
@@ -1099,13 +1205,13 @@ static void gen_rk3399_pi_params_f0(struct timing_related_config *timing_config,
 		} else if (timing_config->dram_type == DDR3) {
 			tmp = pdram_timing->cl - pdram_timing->cwl;
 		}
-		mmio_clrsetbits_32(PI_REG(i, 73), 0x3f << 8, tmp << 8);
+		dfs_clrsetbits_32(PI_REG(i, 73), 0x3f << 8, tmp << 8);
 		/* PI_89 PI_RDLAT_ADJ_F0:RW:16:8 */
 		tmp = get_pi_rdlat_adj(pdram_timing);
-		mmio_clrsetbits_32(PI_REG(i, 89), 0xff << 16, tmp << 16);
+		dfs_clrsetbits_32(PI_REG(i, 89), 0xff << 16, tmp << 16);
 		/* PI_90 PI_WRLAT_ADJ_F0:RW:16:8 */
 		tmp = get_pi_wrlat_adj(pdram_timing, timing_config);
-		mmio_clrsetbits_32(PI_REG(i, 90), 0xff << 16, tmp << 16);
+		dfs_clrsetbits_32(PI_REG(i, 90), 0xff << 16, tmp << 16);
 		/* PI_91 PI_TDFI_WRCSLAT_F0:RW:16:8 */
 		tmp1 = tmp;
 		if (tmp1 == 0)
@@ -1114,25 +1220,25 @@ static void gen_rk3399_pi_params_f0(struct timing_related_config *timing_config,
 			tmp = tmp1 - 1;
 		else
 			tmp = tmp1 - 5;
-		mmio_clrsetbits_32(PI_REG(i, 91), 0xff << 16, tmp << 16);
+		dfs_clrsetbits_32(PI_REG(i, 91), 0xff << 16, tmp << 16);
 		/* PI_95 PI_TDFI_CALVL_CAPTURE_F0:RW:16:10 */
 		tmp1 = 20000 / (1000000 / pdram_timing->mhz) + 1;
 		if ((20000 % (1000000 / pdram_timing->mhz)) != 0)
 			tmp1++;
 		tmp = (tmp1 >> 1) + (tmp1 % 2) + 5;
-		mmio_clrsetbits_32(PI_REG(i, 95), 0x3ff << 16, tmp << 16);
+		dfs_clrsetbits_32(PI_REG(i, 95), 0x3ff << 16, tmp << 16);
 		/* PI_95 PI_TDFI_CALVL_CC_F0:RW:0:10 */
-		mmio_clrsetbits_32(PI_REG(i, 95), 0x3ff, tmp + 18);
+		dfs_clrsetbits_32(PI_REG(i, 95), 0x3ff, tmp + 18);
 		/* PI_102 PI_TMRZ_F0:RW:8:5 */
-		mmio_clrsetbits_32(PI_REG(i, 102), 0x1f << 8,
-				   pdram_timing->tmrz << 8);
+		dfs_clrsetbits_32(PI_REG(i, 102), 0x1f << 8,
+				  pdram_timing->tmrz << 8);
 		/* PI_111 PI_TDFI_CALVL_STROBE_F0:RW:8:4 */
 		tmp1 = 2 * 1000 / (1000000 / pdram_timing->mhz);
 		if ((2 * 1000 % (1000000 / pdram_timing->mhz)) != 0)
 			tmp1++;
 		/* pi_tdfi_calvl_strobe=tds_train+5 */
 		tmp = tmp1 + 5;
-		mmio_clrsetbits_32(PI_REG(i, 111), 0xf << 8, tmp << 8);
+		dfs_clrsetbits_32(PI_REG(i, 111), 0xf << 8, tmp << 8);
 		/* PI_116 PI_TCKEHDQS_F0:RW:16:6 */
 		tmp = 10000 / (1000000 / pdram_timing->mhz);
 		if ((10000 % (1000000 / pdram_timing->mhz)) != 0)
@@ -1141,62 +1247,62 @@ static void gen_rk3399_pi_params_f0(struct timing_related_config *timing_config,
 			tmp = tmp + 1;
 		else
 			tmp = tmp + 8;
-		mmio_clrsetbits_32(PI_REG(i, 116), 0x3f << 16, tmp << 16);
+		dfs_clrsetbits_32(PI_REG(i, 116), 0x3f << 16, tmp << 16);
 		/* PI_125 PI_MR1_DATA_F0_0:RW+:8:16 */
-		mmio_clrsetbits_32(PI_REG(i, 125), 0xffff << 8,
-				   pdram_timing->mr[1] << 8);
+		dfs_clrsetbits_32(PI_REG(i, 125), 0xffff << 8,
+				  pdram_timing->mr[1] << 8);
 		/* PI_133 PI_MR1_DATA_F0_1:RW+:0:16 */
-		mmio_clrsetbits_32(PI_REG(i, 133), 0xffff, pdram_timing->mr[1]);
+		dfs_clrsetbits_32(PI_REG(i, 133), 0xffff, pdram_timing->mr[1]);
 		/* PI_140 PI_MR1_DATA_F0_2:RW+:16:16 */
-		mmio_clrsetbits_32(PI_REG(i, 140), 0xffff << 16,
-				   pdram_timing->mr[1] << 16);
+		dfs_clrsetbits_32(PI_REG(i, 140), 0xffff << 16,
+				  pdram_timing->mr[1] << 16);
 		/* PI_148 PI_MR1_DATA_F0_3:RW+:0:16 */
-		mmio_clrsetbits_32(PI_REG(i, 148), 0xffff, pdram_timing->mr[1]);
+		dfs_clrsetbits_32(PI_REG(i, 148), 0xffff, pdram_timing->mr[1]);
 		/* PI_126 PI_MR2_DATA_F0_0:RW+:0:16 */
-		mmio_clrsetbits_32(PI_REG(i, 126), 0xffff, pdram_timing->mr[2]);
+		dfs_clrsetbits_32(PI_REG(i, 126), 0xffff, pdram_timing->mr[2]);
 		/* PI_133 PI_MR2_DATA_F0_1:RW+:16:16 */
-		mmio_clrsetbits_32(PI_REG(i, 133), 0xffff << 16,
-				   pdram_timing->mr[2] << 16);
+		dfs_clrsetbits_32(PI_REG(i, 133), 0xffff << 16,
+				  pdram_timing->mr[2] << 16);
 		/* PI_141 PI_MR2_DATA_F0_2:RW+:0:16 */
-		mmio_clrsetbits_32(PI_REG(i, 141), 0xffff, pdram_timing->mr[2]);
+		dfs_clrsetbits_32(PI_REG(i, 141), 0xffff, pdram_timing->mr[2]);
 		/* PI_148 PI_MR2_DATA_F0_3:RW+:16:16 */
-		mmio_clrsetbits_32(PI_REG(i, 148), 0xffff << 16,
-				   pdram_timing->mr[2] << 16);
+		dfs_clrsetbits_32(PI_REG(i, 148), 0xffff << 16,
+				  pdram_timing->mr[2] << 16);
 		/* PI_156 PI_TFC_F0:RW:0:10 */
-		mmio_clrsetbits_32(PI_REG(i, 156), 0x3ff,
-				   pdram_timing->tfc_long);
+		dfs_clrsetbits_32(PI_REG(i, 156), 0x3ff,
+				  pdram_timing->tfc_long);
 		/* PI_158 PI_TWR_F0:RW:24:6 */
-		mmio_clrsetbits_32(PI_REG(i, 158), 0x3f << 24,
-				   pdram_timing->twr << 24);
+		dfs_clrsetbits_32(PI_REG(i, 158), 0x3f << 24,
+				  pdram_timing->twr << 24);
 		/* PI_158 PI_TWTR_F0:RW:16:6 */
-		mmio_clrsetbits_32(PI_REG(i, 158), 0x3f << 16,
-				   pdram_timing->twtr << 16);
+		dfs_clrsetbits_32(PI_REG(i, 158), 0x3f << 16,
+				  pdram_timing->twtr << 16);
 		/* PI_158 PI_TRCD_F0:RW:8:8 */
-		mmio_clrsetbits_32(PI_REG(i, 158), 0xff << 8,
-				   pdram_timing->trcd << 8);
+		dfs_clrsetbits_32(PI_REG(i, 158), 0xff << 8,
+				  pdram_timing->trcd << 8);
 		/* PI_158 PI_TRP_F0:RW:0:8 */
-		mmio_clrsetbits_32(PI_REG(i, 158), 0xff, pdram_timing->trp);
+		dfs_clrsetbits_32(PI_REG(i, 158), 0xff, pdram_timing->trp);
 		/* PI_157 PI_TRTP_F0:RW:24:8 */
-		mmio_clrsetbits_32(PI_REG(i, 157), 0xff << 24,
-				   pdram_timing->trtp << 24);
+		dfs_clrsetbits_32(PI_REG(i, 157), 0xff << 24,
+				  pdram_timing->trtp << 24);
 		/* PI_159 PI_TRAS_MIN_F0:RW:24:8 */
-		mmio_clrsetbits_32(PI_REG(i, 159), 0xff << 24,
-				   pdram_timing->tras_min << 24);
+		dfs_clrsetbits_32(PI_REG(i, 159), 0xff << 24,
+				  pdram_timing->tras_min << 24);
 		/* PI_159 PI_TRAS_MAX_F0:RW:0:17 */
 		tmp = pdram_timing->tras_max * 99 / 100;
-		mmio_clrsetbits_32(PI_REG(i, 159), 0x1ffff, tmp);
+		dfs_clrsetbits_32(PI_REG(i, 159), 0x1ffff, tmp);
 		/* PI_160 PI_TMRD_F0:RW:16:6 */
-		mmio_clrsetbits_32(PI_REG(i, 160), 0x3f << 16,
-				   pdram_timing->tmrd << 16);
+		dfs_clrsetbits_32(PI_REG(i, 160), 0x3f << 16,
+				  pdram_timing->tmrd << 16);
 		/*PI_160 PI_TDQSCK_MAX_F0:RW:0:4 */
-		mmio_clrsetbits_32(PI_REG(i, 160), 0xf,
-				   pdram_timing->tdqsck_max);
+		dfs_clrsetbits_32(PI_REG(i, 160), 0xf,
+				  pdram_timing->tdqsck_max);
 		/* PI_187 PI_TDFI_CTRLUPD_MAX_F0:RW:8:16 */
-		mmio_clrsetbits_32(PI_REG(i, 187), 0xffff << 8,
-				   (2 * pdram_timing->trefi) << 8);
+		dfs_clrsetbits_32(PI_REG(i, 187), 0xffff << 8,
+				  (2 * pdram_timing->trefi) << 8);
 		/* PI_188 PI_TDFI_CTRLUPD_INTERVAL_F0:RW:0:32 */
-		mmio_clrsetbits_32(PI_REG(i, 188), 0xffffffff,
-				   20 * pdram_timing->trefi);
+		dfs_clrsetbits_32(PI_REG(i, 188), 0xffffffff,
+				  20 * pdram_timing->trefi);
 	}
 }
 
@@ -1209,12 +1315,12 @@ static void gen_rk3399_pi_params_f1(struct timing_related_config *timing_config,
 	for (i = 0; i < timing_config->ch_cnt; i++) {
 		/* PI_04 PI_TDFI_PHYMSTR_MAX_F1:RW:0:32 */
 		tmp = 4 * pdram_timing->trefi;
-		mmio_write_32(PI_REG(i, 4), tmp);
+		dfs_write_32(PI_REG(i, 4), tmp);
 		/* PI_05 PI_TDFI_PHYMSTR_RESP_F1:RW:0:16 */
 		tmp = 2 * pdram_timing->trefi;
-		mmio_clrsetbits_32(PI_REG(i, 5), 0xffff, tmp);
+		dfs_clrsetbits_32(PI_REG(i, 5), 0xffff, tmp);
 		/* PI_12 PI_TDFI_PHYUPD_RESP_F1:RW:0:16 */
-		mmio_clrsetbits_32(PI_REG(i, 12), 0xffff, tmp);
+		dfs_clrsetbits_32(PI_REG(i, 12), 0xffff, tmp);
 
 		/* PI_42 PI_TDELAY_RDWR_2_BUS_IDLE_F1:RW:8:8 */
 		if (timing_config->dram_type == LPDDR4)
@@ -1224,27 +1330,27 @@ static void gen_rk3399_pi_params_f1(struct timing_related_config *timing_config,
 		tmp = (pdram_timing->bl / 2) + 4 +
 		      (get_pi_rdlat_adj(pdram_timing) - 2) + tmp +
 		      get_pi_tdfi_phy_rdlat(pdram_timing, timing_config);
-		mmio_clrsetbits_32(PI_REG(i, 42), 0xff << 8, tmp << 8);
+		dfs_clrsetbits_32(PI_REG(i, 42), 0xff << 8, tmp << 8);
 		/* PI_43 PI_WRLAT_F1:RW:24:5 */
 		if (timing_config->dram_type == LPDDR3) {
 			tmp = get_pi_wrlat(pdram_timing, timing_config);
-			mmio_clrsetbits_32(PI_REG(i, 43), 0x1f << 24,
-					   tmp << 24);
+			dfs_clrsetbits_32(PI_REG(i, 43), 0x1f << 24,
+					  tmp << 24);
 		}
 		/* PI_44 PI_ADDITIVE_LAT_F1:RW:0:6 */
-		mmio_clrsetbits_32(PI_REG(i, 44), 0x3f, PI_ADD_LATENCY);
+		dfs_clrsetbits_32(PI_REG(i, 44), 0x3f, PI_ADD_LATENCY);
 		/* PI_44 PI_CASLAT_LIN_F1:RW:8:7:=0x18 */
-		mmio_clrsetbits_32(PI_REG(i, 44), 0x7f << 8,
-				   (pdram_timing->cl * 2) << 8);
+		dfs_clrsetbits_32(PI_REG(i, 44), 0x7f << 8,
+				  (pdram_timing->cl * 2) << 8);
 		/* PI_47 PI_TREF_F1:RW:16:16 */
-		mmio_clrsetbits_32(PI_REG(i, 47), 0xffff << 16,
-				   pdram_timing->trefi << 16);
+		dfs_clrsetbits_32(PI_REG(i, 47), 0xffff << 16,
+				  pdram_timing->trefi << 16);
 		/* PI_47 PI_TRFC_F1:RW:0:10 */
-		mmio_clrsetbits_32(PI_REG(i, 47), 0x3ff, pdram_timing->trfc);
+		dfs_clrsetbits_32(PI_REG(i, 47), 0x3ff, pdram_timing->trfc);
 		/* PI_67 PI_TODTL_2CMD_F1:RW:8:8 */
 		if (timing_config->dram_type == LPDDR3) {
 			tmp = get_pi_todtoff_max(pdram_timing, timing_config);
-			mmio_clrsetbits_32(PI_REG(i, 67), 0xff << 8, tmp << 8);
+			dfs_clrsetbits_32(PI_REG(i, 67), 0xff << 8, tmp << 8);
 		}
 		/* PI_72 PI_WR_TO_ODTH_F1:RW:24:6 */
 		if ((timing_config->dram_type == LPDDR3) ||
@@ -1258,7 +1364,7 @@ static void gen_rk3399_pi_params_f1(struct timing_related_config *timing_config,
 		} else if (timing_config->dram_type == DDR3) {
 			tmp = 0;
 		}
-		mmio_clrsetbits_32(PI_REG(i, 72), 0x3f << 24, tmp << 24);
+		dfs_clrsetbits_32(PI_REG(i, 72), 0x3f << 24, tmp << 24);
 		/* PI_73 PI_RD_TO_ODTH_F1:RW:16:6 */
 		if ((timing_config->dram_type == LPDDR3) ||
 		    (timing_config->dram_type == LPDDR4)) {
@@ -1275,13 +1381,13 @@ static void gen_rk3399_pi_params_f1(struct timing_related_config *timing_config,
 		} else if (timing_config->dram_type == DDR3)
 			tmp = pdram_timing->cl - pdram_timing->cwl;
 
-		mmio_clrsetbits_32(PI_REG(i, 73), 0x3f << 16, tmp << 16);
+		dfs_clrsetbits_32(PI_REG(i, 73), 0x3f << 16, tmp << 16);
 		/*P I_89 PI_RDLAT_ADJ_F1:RW:24:8 */
 		tmp = get_pi_rdlat_adj(pdram_timing);
-		mmio_clrsetbits_32(PI_REG(i, 89), 0xff << 24, tmp << 24);
+		dfs_clrsetbits_32(PI_REG(i, 89), 0xff << 24, tmp << 24);
 		/* PI_90 PI_WRLAT_ADJ_F1:RW:24:8 */
 		tmp = get_pi_wrlat_adj(pdram_timing, timing_config);
-		mmio_clrsetbits_32(PI_REG(i, 90), 0xff << 24, tmp << 24);
+		dfs_clrsetbits_32(PI_REG(i, 90), 0xff << 24, tmp << 24);
 		/* PI_91 PI_TDFI_WRCSLAT_F1:RW:24:8 */
 		tmp1 = tmp;
 		if (tmp1 == 0)
@@ -1290,19 +1396,19 @@ static void gen_rk3399_pi_params_f1(struct timing_related_config *timing_config,
 			tmp = tmp1 - 1;
 		else
 			tmp = tmp1 - 5;
-		mmio_clrsetbits_32(PI_REG(i, 91), 0xff << 24, tmp << 24);
+		dfs_clrsetbits_32(PI_REG(i, 91), 0xff << 24, tmp << 24);
 		/*PI_96 PI_TDFI_CALVL_CAPTURE_F1:RW:16:10 */
 		/* tadr=20ns */
 		tmp1 = 20000 / (1000000 / pdram_timing->mhz) + 1;
 		if ((20000 % (1000000 / pdram_timing->mhz)) != 0)
 			tmp1++;
 		tmp = (tmp1 >> 1) + (tmp1 % 2) + 5;
-		mmio_clrsetbits_32(PI_REG(i, 96), 0x3ff << 16, tmp << 16);
+		dfs_clrsetbits_32(PI_REG(i, 96), 0x3ff << 16, tmp << 16);
 		/* PI_96 PI_TDFI_CALVL_CC_F1:RW:0:10 */
 		tmp = tmp + 18;
-		mmio_clrsetbits_32(PI_REG(i, 96), 0x3ff, tmp);
+		dfs_clrsetbits_32(PI_REG(i, 96), 0x3ff, tmp);
 		/*PI_103 PI_TMRZ_F1:RW:0:5 */
-		mmio_clrsetbits_32(PI_REG(i, 103), 0x1f, pdram_timing->tmrz);
+		dfs_clrsetbits_32(PI_REG(i, 103), 0x1f, pdram_timing->tmrz);
 		/*PI_111 PI_TDFI_CALVL_STROBE_F1:RW:16:4 */
 		/* tds_train=ceil(2/ns) */
 		tmp1 = 2 * 1000 / (1000000 / pdram_timing->mhz);
@@ -1310,8 +1416,8 @@ static void gen_rk3399_pi_params_f1(struct timing_related_config *timing_config,
 			tmp1++;
 		/* pi_tdfi_calvl_strobe=tds_train+5 */
 		tmp = tmp1 + 5;
-		mmio_clrsetbits_32(PI_REG(i, 111), 0xf << 16,
-				   tmp << 16);
+		dfs_clrsetbits_32(PI_REG(i, 111), 0xf << 16,
+				  tmp << 16);
 		/* PI_116 PI_TCKEHDQS_F1:RW:24:6 */
 		tmp = 10000 / (1000000 / pdram_timing->mhz);
 		if ((10000 % (1000000 / pdram_timing->mhz)) != 0)
@@ -1320,63 +1426,63 @@ static void gen_rk3399_pi_params_f1(struct timing_related_config *timing_config,
 			tmp = tmp + 1;
 		else
 			tmp = tmp + 8;
-		mmio_clrsetbits_32(PI_REG(i, 116), 0x3f << 24,
-				   tmp << 24);
+		dfs_clrsetbits_32(PI_REG(i, 116), 0x3f << 24,
+				  tmp << 24);
 		/* PI_128 PI_MR1_DATA_F1_0:RW+:0:16 */
-		mmio_clrsetbits_32(PI_REG(i, 128), 0xffff, pdram_timing->mr[1]);
+		dfs_clrsetbits_32(PI_REG(i, 128), 0xffff, pdram_timing->mr[1]);
 		/* PI_135 PI_MR1_DATA_F1_1:RW+:8:16 */
-		mmio_clrsetbits_32(PI_REG(i, 135), 0xffff << 8,
-				   pdram_timing->mr[1] << 8);
+		dfs_clrsetbits_32(PI_REG(i, 135), 0xffff << 8,
+				  pdram_timing->mr[1] << 8);
 		/* PI_143 PI_MR1_DATA_F1_2:RW+:0:16 */
-		mmio_clrsetbits_32(PI_REG(i, 143), 0xffff, pdram_timing->mr[1]);
+		dfs_clrsetbits_32(PI_REG(i, 143), 0xffff, pdram_timing->mr[1]);
 		/* PI_150 PI_MR1_DATA_F1_3:RW+:8:16 */
-		mmio_clrsetbits_32(PI_REG(i, 150), 0xffff << 8,
-				   pdram_timing->mr[1] << 8);
+		dfs_clrsetbits_32(PI_REG(i, 150), 0xffff << 8,
+				  pdram_timing->mr[1] << 8);
 		/* PI_128 PI_MR2_DATA_F1_0:RW+:16:16 */
-		mmio_clrsetbits_32(PI_REG(i, 128), 0xffff << 16,
-				   pdram_timing->mr[2] << 16);
+		dfs_clrsetbits_32(PI_REG(i, 128), 0xffff << 16,
+				  pdram_timing->mr[2] << 16);
 		/* PI_136 PI_MR2_DATA_F1_1:RW+:0:16 */
-		mmio_clrsetbits_32(PI_REG(i, 136), 0xffff, pdram_timing->mr[2]);
+		dfs_clrsetbits_32(PI_REG(i, 136), 0xffff, pdram_timing->mr[2]);
 		/* PI_143 PI_MR2_DATA_F1_2:RW+:16:16 */
-		mmio_clrsetbits_32(PI_REG(i, 143), 0xffff << 16,
-				   pdram_timing->mr[2] << 16);
+		dfs_clrsetbits_32(PI_REG(i, 143), 0xffff << 16,
+				  pdram_timing->mr[2] << 16);
 		/* PI_151 PI_MR2_DATA_F1_3:RW+:0:16 */
-		mmio_clrsetbits_32(PI_REG(i, 151), 0xffff, pdram_timing->mr[2]);
+		dfs_clrsetbits_32(PI_REG(i, 151), 0xffff, pdram_timing->mr[2]);
 		/* PI_156 PI_TFC_F1:RW:16:10 */
-		mmio_clrsetbits_32(PI_REG(i, 156), 0x3ff << 16,
-				   pdram_timing->tfc_long << 16);
+		dfs_clrsetbits_32(PI_REG(i, 156), 0x3ff << 16,
+				  pdram_timing->tfc_long << 16);
 		/* PI_162 PI_TWR_F1:RW:8:6 */
-		mmio_clrsetbits_32(PI_REG(i, 162), 0x3f << 8,
-				   pdram_timing->twr << 8);
+		dfs_clrsetbits_32(PI_REG(i, 162), 0x3f << 8,
+				  pdram_timing->twr << 8);
 		/* PI_162 PI_TWTR_F1:RW:0:6 */
-		mmio_clrsetbits_32(PI_REG(i, 162), 0x3f, pdram_timing->twtr);
+		dfs_clrsetbits_32(PI_REG(i, 162), 0x3f, pdram_timing->twtr);
 		/* PI_161 PI_TRCD_F1:RW:24:8 */
-		mmio_clrsetbits_32(PI_REG(i, 161), 0xff << 24,
-				   pdram_timing->trcd << 24);
+		dfs_clrsetbits_32(PI_REG(i, 161), 0xff << 24,
+				  pdram_timing->trcd << 24);
 		/* PI_161 PI_TRP_F1:RW:16:8 */
-		mmio_clrsetbits_32(PI_REG(i, 161), 0xff << 16,
-				   pdram_timing->trp << 16);
+		dfs_clrsetbits_32(PI_REG(i, 161), 0xff << 16,
+				  pdram_timing->trp << 16);
 		/* PI_161 PI_TRTP_F1:RW:8:8 */
-		mmio_clrsetbits_32(PI_REG(i, 161), 0xff << 8,
-				   pdram_timing->trtp << 8);
+		dfs_clrsetbits_32(PI_REG(i, 161), 0xff << 8,
+				  pdram_timing->trtp << 8);
 		/* PI_163 PI_TRAS_MIN_F1:RW:24:8 */
-		mmio_clrsetbits_32(PI_REG(i, 163), 0xff << 24,
-				   pdram_timing->tras_min << 24);
+		dfs_clrsetbits_32(PI_REG(i, 163), 0xff << 24,
+				  pdram_timing->tras_min << 24);
 		/* PI_163 PI_TRAS_MAX_F1:RW:0:17 */
-		mmio_clrsetbits_32(PI_REG(i, 163), 0x1ffff,
-				   pdram_timing->tras_max * 99 / 100);
+		dfs_clrsetbits_32(PI_REG(i, 163), 0x1ffff,
+				  pdram_timing->tras_max * 99 / 100);
 		/* PI_164 PI_TMRD_F1:RW:16:6 */
-		mmio_clrsetbits_32(PI_REG(i, 164), 0x3f << 16,
-				   pdram_timing->tmrd << 16);
+		dfs_clrsetbits_32(PI_REG(i, 164), 0x3f << 16,
+				  pdram_timing->tmrd << 16);
 		/* PI_164 PI_TDQSCK_MAX_F1:RW:0:4 */
-		mmio_clrsetbits_32(PI_REG(i, 164), 0xf,
-				   pdram_timing->tdqsck_max);
+		dfs_clrsetbits_32(PI_REG(i, 164), 0xf,
+				  pdram_timing->tdqsck_max);
 		/* PI_189 PI_TDFI_CTRLUPD_MAX_F1:RW:0:16 */
-		mmio_clrsetbits_32(PI_REG(i, 189), 0xffff,
-				   2 * pdram_timing->trefi);
+		dfs_clrsetbits_32(PI_REG(i, 189), 0xffff,
+				  2 * pdram_timing->trefi);
 		/* PI_190 PI_TDFI_CTRLUPD_INTERVAL_F1:RW:0:32 */
-		mmio_clrsetbits_32(PI_REG(i, 190), 0xffffffff,
-				   20 * pdram_timing->trefi);
+		dfs_clrsetbits_32(PI_REG(i, 190), 0xffffffff,
+				  20 * pdram_timing->trefi);
 	}
 }
 
@@ -1514,40 +1620,40 @@ static void gen_rk3399_phy_params(struct timing_related_config *timing_config,
 		ie_enable = PI_IE_ENABLE_VALUE;
 		tsel_enable = PI_TSEL_ENABLE_VALUE;
 
-		mmio_clrsetbits_32(PHY_REG(i, 896), (0x3 << 8) | 1, fn << 8);
+		dfs_clrsetbits_32(PHY_REG(i, 896), (0x3 << 8) | 1, fn << 8);
 
 		/* PHY_LOW_FREQ_SEL */
 		/* DENALI_PHY_913 1bit offset_0 */
 		if (timing_config->freq > 400)
-			mmio_clrbits_32(PHY_REG(i, 913), 1);
+			dfs_clrbits_32(PHY_REG(i, 913), 1);
 		else
-			mmio_setbits_32(PHY_REG(i, 913), 1);
+			dfs_setbits_32(PHY_REG(i, 913), 1);
 
 		/* PHY_RPTR_UPDATE_x */
 		/* DENALI_PHY_87/215/343/471 4bit offset_16 */
 		tmp = 2500 / (1000000 / pdram_timing->mhz) + 3;
 		if ((2500 % (1000000 / pdram_timing->mhz)) != 0)
 			tmp++;
-		mmio_clrsetbits_32(PHY_REG(i, 87), 0xf << 16, tmp << 16);
-		mmio_clrsetbits_32(PHY_REG(i, 215), 0xf << 16, tmp << 16);
-		mmio_clrsetbits_32(PHY_REG(i, 343), 0xf << 16, tmp << 16);
-		mmio_clrsetbits_32(PHY_REG(i, 471), 0xf << 16, tmp << 16);
+		dfs_clrsetbits_32(PHY_REG(i, 87), 0xf << 16, tmp << 16);
+		dfs_clrsetbits_32(PHY_REG(i, 215), 0xf << 16, tmp << 16);
+		dfs_clrsetbits_32(PHY_REG(i, 343), 0xf << 16, tmp << 16);
+		dfs_clrsetbits_32(PHY_REG(i, 471), 0xf << 16, tmp << 16);
 
 		/* PHY_PLL_CTRL */
 		/* DENALI_PHY_911 13bits offset_0 */
 		/* PHY_LP4_BOOT_PLL_CTRL */
 		/* DENALI_PHY_919 13bits offset_0 */
 		tmp = (1 << 12) | (2 << 7) | (1 << 1);
-		mmio_clrsetbits_32(PHY_REG(i, 911), 0x1fff, tmp);
-		mmio_clrsetbits_32(PHY_REG(i, 919), 0x1fff, tmp);
+		dfs_clrsetbits_32(PHY_REG(i, 911), 0x1fff, tmp);
+		dfs_clrsetbits_32(PHY_REG(i, 919), 0x1fff, tmp);
 
 		/* PHY_PLL_CTRL_CA */
 		/* DENALI_PHY_911 13bits offset_16 */
 		/* PHY_LP4_BOOT_PLL_CTRL_CA */
 		/* DENALI_PHY_919 13bits offset_16 */
 		tmp = (2 << 7) | (1 << 5) | (1 << 1);
-		mmio_clrsetbits_32(PHY_REG(i, 911), 0x1fff << 16, tmp << 16);
-		mmio_clrsetbits_32(PHY_REG(i, 919), 0x1fff << 16, tmp << 16);
+		dfs_clrsetbits_32(PHY_REG(i, 911), 0x1fff << 16, tmp << 16);
+		dfs_clrsetbits_32(PHY_REG(i, 919), 0x1fff << 16, tmp << 16);
 
 		/* PHY_TCKSRE_WAIT */
 		/* DENALI_PHY_922 4bits offset_24 */
@@ -1559,14 +1665,14 @@ static void gen_rk3399_phy_params(struct timing_related_config *timing_config,
 			tmp = 4;
 		else
 			tmp = 5;
-		mmio_clrsetbits_32(PHY_REG(i, 922), 0xf << 24, tmp << 24);
+		dfs_clrsetbits_32(PHY_REG(i, 922), 0xf << 24, tmp << 24);
 		/* PHY_CAL_CLK_SELECT_0:RW8:3 */
 		div = pdram_timing->mhz / (2 * 20);
 		for (j = 2, tmp = 1; j <= 128; j <<= 1, tmp++) {
 			if (div < j)
 				break;
 		}
-		mmio_clrsetbits_32(PHY_REG(i, 947), 0x7 << 8, tmp << 8);
+		dfs_clrsetbits_32(PHY_REG(i, 947), 0x7 << 8, tmp << 8);
 
 		if (timing_config->dram_type == DDR3) {
 			mem_delay_ps = 0;
@@ -1589,25 +1695,25 @@ static void gen_rk3399_phy_params(struct timing_related_config *timing_config,
 		tmp = gate_delay_frac_ps * 0x200 / 1000;
 		/* PHY_RDDQS_GATE_SLAVE_DELAY */
 		/* DENALI_PHY_77/205/333/461 10bits offset_16 */
-		mmio_clrsetbits_32(PHY_REG(i, 77), 0x2ff << 16, tmp << 16);
-		mmio_clrsetbits_32(PHY_REG(i, 205), 0x2ff << 16, tmp << 16);
-		mmio_clrsetbits_32(PHY_REG(i, 333), 0x2ff << 16, tmp << 16);
-		mmio_clrsetbits_32(PHY_REG(i, 461), 0x2ff << 16, tmp << 16);
+		dfs_clrsetbits_32(PHY_REG(i, 77), 0x2ff << 16, tmp << 16);
+		dfs_clrsetbits_32(PHY_REG(i, 205), 0x2ff << 16, tmp << 16);
+		dfs_clrsetbits_32(PHY_REG(i, 333), 0x2ff << 16, tmp << 16);
+		dfs_clrsetbits_32(PHY_REG(i, 461), 0x2ff << 16, tmp << 16);
 
 		tmp = gate_delay_ps / 1000;
 		/* PHY_LP4_BOOT_RDDQS_LATENCY_ADJUST */
 		/* DENALI_PHY_10/138/266/394 4bit offset_0 */
-		mmio_clrsetbits_32(PHY_REG(i, 10), 0xf, tmp);
-		mmio_clrsetbits_32(PHY_REG(i, 138), 0xf, tmp);
-		mmio_clrsetbits_32(PHY_REG(i, 266), 0xf, tmp);
-		mmio_clrsetbits_32(PHY_REG(i, 394), 0xf, tmp);
+		dfs_clrsetbits_32(PHY_REG(i, 10), 0xf, tmp);
+		dfs_clrsetbits_32(PHY_REG(i, 138), 0xf, tmp);
+		dfs_clrsetbits_32(PHY_REG(i, 266), 0xf, tmp);
+		dfs_clrsetbits_32(PHY_REG(i, 394), 0xf, tmp);
 		/* PHY_GTLVL_LAT_ADJ_START */
 		/* DENALI_PHY_80/208/336/464 4bits offset_16 */
 		tmp = rddqs_delay_ps / (1000000 / pdram_timing->mhz) + 2;
-		mmio_clrsetbits_32(PHY_REG(i, 80), 0xf << 16, tmp << 16);
-		mmio_clrsetbits_32(PHY_REG(i, 208), 0xf << 16, tmp << 16);
-		mmio_clrsetbits_32(PHY_REG(i, 336), 0xf << 16, tmp << 16);
-		mmio_clrsetbits_32(PHY_REG(i, 464), 0xf << 16, tmp << 16);
+		dfs_clrsetbits_32(PHY_REG(i, 80), 0xf << 16, tmp << 16);
+		dfs_clrsetbits_32(PHY_REG(i, 208), 0xf << 16, tmp << 16);
+		dfs_clrsetbits_32(PHY_REG(i, 336), 0xf << 16, tmp << 16);
+		dfs_clrsetbits_32(PHY_REG(i, 464), 0xf << 16, tmp << 16);
 
 		cas_lat = pdram_timing->cl + PI_ADD_LATENCY;
 		rddata_en_ie_dly = ie_enable / (1000000 / pdram_timing->mhz);
@@ -1634,16 +1740,16 @@ static void gen_rk3399_phy_params(struct timing_related_config *timing_config,
 			tmp = extra_adder;
 		/* PHY_LP4_BOOT_RDDATA_EN_TSEL_DLY */
 		/* DENALI_PHY_9/137/265/393 4bit offset_16 */
-		mmio_clrsetbits_32(PHY_REG(i, 9), 0xf << 16, tmp << 16);
-		mmio_clrsetbits_32(PHY_REG(i, 137), 0xf << 16, tmp << 16);
-		mmio_clrsetbits_32(PHY_REG(i, 265), 0xf << 16, tmp << 16);
-		mmio_clrsetbits_32(PHY_REG(i, 393), 0xf << 16, tmp << 16);
+		dfs_clrsetbits_32(PHY_REG(i, 9), 0xf << 16, tmp << 16);
+		dfs_clrsetbits_32(PHY_REG(i, 137), 0xf << 16, tmp << 16);
+		dfs_clrsetbits_32(PHY_REG(i, 265), 0xf << 16, tmp << 16);
+		dfs_clrsetbits_32(PHY_REG(i, 393), 0xf << 16, tmp << 16);
 		/* PHY_RDDATA_EN_TSEL_DLY */
 		/* DENALI_PHY_86/214/342/470 4bit offset_0 */
-		mmio_clrsetbits_32(PHY_REG(i, 86), 0xf, tmp);
-		mmio_clrsetbits_32(PHY_REG(i, 214), 0xf, tmp);
-		mmio_clrsetbits_32(PHY_REG(i, 342), 0xf, tmp);
-		mmio_clrsetbits_32(PHY_REG(i, 470), 0xf, tmp);
+		dfs_clrsetbits_32(PHY_REG(i, 86), 0xf, tmp);
+		dfs_clrsetbits_32(PHY_REG(i, 214), 0xf, tmp);
+		dfs_clrsetbits_32(PHY_REG(i, 342), 0xf, tmp);
+		dfs_clrsetbits_32(PHY_REG(i, 470), 0xf, tmp);
 
 		if (tsel_adder > rddata_en_ie_dly)
 			extra_adder = tsel_adder - rddata_en_ie_dly;
@@ -1655,16 +1761,16 @@ static void gen_rk3399_phy_params(struct timing_related_config *timing_config,
 			tmp = rddata_en_ie_dly - 0 + extra_adder;
 		/* PHY_LP4_BOOT_RDDATA_EN_DLY */
 		/* DENALI_PHY_9/137/265/393 4bit offset_8 */
-		mmio_clrsetbits_32(PHY_REG(i, 9), 0xf << 8, tmp << 8);
-		mmio_clrsetbits_32(PHY_REG(i, 137), 0xf << 8, tmp << 8);
-		mmio_clrsetbits_32(PHY_REG(i, 265), 0xf << 8, tmp << 8);
-		mmio_clrsetbits_32(PHY_REG(i, 393), 0xf << 8, tmp << 8);
+		dfs_clrsetbits_32(PHY_REG(i, 9), 0xf << 8, tmp << 8);
+		dfs_clrsetbits_32(PHY_REG(i, 137), 0xf << 8, tmp << 8);
+		dfs_clrsetbits_32(PHY_REG(i, 265), 0xf << 8, tmp << 8);
+		dfs_clrsetbits_32(PHY_REG(i, 393), 0xf << 8, tmp << 8);
 		/* PHY_RDDATA_EN_DLY */
 		/* DENALI_PHY_85/213/341/469 4bit offset_24 */
-		mmio_clrsetbits_32(PHY_REG(i, 85), 0xf << 24, tmp << 24);
-		mmio_clrsetbits_32(PHY_REG(i, 213), 0xf << 24, tmp << 24);
-		mmio_clrsetbits_32(PHY_REG(i, 341), 0xf << 24, tmp << 24);
-		mmio_clrsetbits_32(PHY_REG(i, 469), 0xf << 24, tmp << 24);
+		dfs_clrsetbits_32(PHY_REG(i, 85), 0xf << 24, tmp << 24);
+		dfs_clrsetbits_32(PHY_REG(i, 213), 0xf << 24, tmp << 24);
+		dfs_clrsetbits_32(PHY_REG(i, 341), 0xf << 24, tmp << 24);
+		dfs_clrsetbits_32(PHY_REG(i, 469), 0xf << 24, tmp << 24);
 
 		if (pdram_timing->mhz <= ENPER_CS_TRAINING_FREQ) {
 			/*
@@ -1675,18 +1781,16 @@ static void gen_rk3399_phy_params(struct timing_related_config *timing_config,
 			 */
 
 			/*DENALI_PHY_84/212/340/468 1bit offset_16 */
-			mmio_clrbits_32(PHY_REG(i, 84), 0x1 << 16);
-			mmio_clrbits_32(PHY_REG(i, 212), 0x1 << 16);
-			mmio_clrbits_32(PHY_REG(i, 340), 0x1 << 16);
-			mmio_clrbits_32(PHY_REG(i, 468), 0x1 << 16);
+			dfs_clrbits_32(PHY_REG(i, 84), 0x1 << 16);
+			dfs_clrbits_32(PHY_REG(i, 212), 0x1 << 16);
+			dfs_clrbits_32(PHY_REG(i, 340), 0x1 << 16);
+			dfs_clrbits_32(PHY_REG(i, 468), 0x1 << 16);
 		} else {
-			mmio_setbits_32(PHY_REG(i, 84), 0x1 << 16);
-			mmio_setbits_32(PHY_REG(i, 212), 0x1 << 16);
-			mmio_setbits_32(PHY_REG(i, 340), 0x1 << 16);
-			mmio_setbits_32(PHY_REG(i, 468), 0x1 << 16);
+			dfs_setbits_32(PHY_REG(i, 84), 0x1 << 16);
+			dfs_setbits_32(PHY_REG(i, 212), 0x1 << 16);
+			dfs_setbits_32(PHY_REG(i, 340), 0x1 << 16);
+			dfs_setbits_32(PHY_REG(i, 468), 0x1 << 16);
 		}
-		gen_rk3399_phy_dll_bypass(pdram_timing->mhz, i, fn,
-					  timing_config->dram_type);
 	}
 }
 
@@ -1723,6 +1827,13 @@ uint32_t ddr_get_rate(void)
 	return (24 / refdiv * fbdiv / postdiv1 / postdiv2) * 1000 * 1000;
 }
 
+/* Duration of the last frequency switch, and the longest one since boot */
+void ddr_get_switch_time(uint32_t *last_us, uint32_t *max_us)
+{
+	*last_us = rk3399_dram_status.switch_us;
+	*max_us = rk3399_dram_status.switch_max_us;
+}
+
 /*
  * return: bit12: channel 1, external self-refresh
  *         bit11: channel 1, stdby_mode
@@ -1831,6 +1942,26 @@ static void dram_low_power_config(void)
 	mmio_write_32(CIC_BASE + CIC_CTRL1, 0x00150014);
 }
 
+static void dram_timing_cache_update(void)
+{
+	struct timing_related_config *config = &rk3399_dram_status.timing_config;
+	uint32_t freq = config->freq;
+	uint32_t i;
+
+	if (dram_timing_cache_odt == config->odt)
+		return;
+
+	dfs_image_invalidate();
+
+	for (i = 0; i < ARRAY_SIZE(dpll_rates_table); i++) {
+		config->freq = dpll_rates_table[i].mhz;
+		dram_get_parameter(config, &dram_timing_cache[i]);
+	}
+
+	config->freq = freq;
+	dram_timing_cache_odt = config->odt;
+}
+
 void dram_dfs_init(void)
 {
 	uint32_t trefi0, trefi1, boot_freq;
@@ -1905,6 +2036,8 @@ void dram_dfs_init(void)
 	} else {
 		rddqs_delay_ps = 3500;
 	}
+
+	dram_timing_cache_update();
 }
 
 /*
@@ -1979,8 +2112,9 @@ static void m0_configure_ddr(struct pll_div pll_div, uint32_t ddr_index)
 
 static uint32_t prepare_ddr_timing(uint32_t mhz)
 {
-	uint32_t index;
-	struct dram_timing_t dram_timing;
+	uint32_t index, ch;
+	struct dram_timing_t *dram_timing;
+	struct dfs_image *image;
 
 	rk3399_dram_status.timing_config.freq = mhz;
 
@@ -1998,14 +2132,31 @@ static uint32_t prepare_ddr_timing(uint32_t mhz)
 	 * checking if having available gate traiing timing for
 	 * target freq.
 	 */
-	dram_get_parameter(&rk3399_dram_status.timing_config, &dram_timing);
-	gen_rk3399_ctl_params(&rk3399_dram_status.timing_config,
-			      &dram_timing, index);
-	gen_rk3399_pi_params(&rk3399_dram_status.timing_config,
-			     &dram_timing, index);
-	gen_rk3399_phy_params(&rk3399_dram_status.timing_config,
-			      &rk3399_dram_status.drv_odt_lp_cfg,
-			      &dram_timing, index);
+	dram_timing_cache_update();
+	dram_timing = &dram_timing_cache[to_get_clk_index(mhz)];
+	assert(dram_timing->mhz == mhz);
+
+	image = &dfs_images[to_get_clk_index(mhz)][index];
+	if (image->count != 0) {
+		dfs_image_write(image);
+	} else {
+		if (!image->overflow)
+			dfs_image_rec = image;
+		gen_rk3399_ctl_params(&rk3399_dram_status.timing_config,
+				      dram_timing, index);
+		gen_rk3399_pi_params(&rk3399_dram_status.timing_config,
+				     dram_timing, index);
+		gen_rk3399_phy_params(&rk3399_dram_status.timing_config,
+				      &rk3399_dram_status.drv_odt_lp_cfg,
+				      dram_timing, index);
+		dfs_image_rec = NULL;
+		if (image->overflow)
+			image->count = 0;
+	}
+
+	for (ch = 0; ch < rk3399_dram_status.timing_config.ch_cnt; ch++)
+		gen_rk3399_phy_dll_bypass(mhz, ch, index,
+				rk3399_dram_status.timing_config.dram_type);
 	rk3399_dram_status.index_freq[index] = mhz;
 
 	return index;
@@ -2015,11 +2166,14 @@ uint32_t ddr_set_rate(uint32_t hz)
 {
 	uint32_t low_power, index, ddr_index;
 	uint32_t mhz = hz / (1000 * 1000);
+	uint64_t start;
 
 	if (mhz ==
 	    rk3399_dram_status.index_freq[rk3399_dram_status.current_index])
 		return mhz;
 
+	start = read_cntpct_el0();
+
 	index = to_get_clk_index(mhz);
 	mhz = dpll_rates_table[index].mhz;
 
@@ -2046,6 +2200,14 @@ uint32_t ddr_set_rate(uint32_t hz)
 	resume_low_power(low_power);
 out:
 	gen_rk3399_disable_training(rk3399_dram_status.timing_config.ch_cnt);
+
+	rk3399_dram_status.switch_us = (read_cntpct_el0() - start) *
+				       1000000 / read_cntfrq_el0();
+	if (rk3399_dram_status.switch_us > rk3399_dram_status.switch_max_us)
+		rk3399_dram_status.switch_max_us = rk3399_dram_status.switch_us;
+	VERBOSE("DDR: switched to %u MHz in %u us (max %u us)\n", mhz,
+		rk3399_dram_status.switch_us, rk3399_dram_status.switch_max_us);
+
 	return mhz;
 }
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -57,9 +57,18 @@ uintptr_t rockchip_plat_sip_handler(uint32_t smc_fid,
 				    u_register_t flags)
 {
 	uint64_t x5, x6;
+	uint32_t last_us, max_us;
 
 	switch (smc_fid) {
 	case RK_SIP_DDR_CFG:
+		/*
+		 * DRAM_GET_RATE also returns the duration of the last frequency
+		 * switch in x1, and of the longest one since boot in x2, in us.
+		 */
+		if (x3 == DRAM_GET_RATE) {
+			ddr_get_switch_time(&last_us, &max_us);
+			SMC_RET3(handle, ddr_get_rate(), last_us, max_us);
+		}
 		SMC_RET1(handle, ddr_smc_handler(x1, x2, x3, x4));
 	case RK_SIP_HDCP_CONTROL:
 		SMC_RET1(handle, dp_hdcp_ctrl(x1));
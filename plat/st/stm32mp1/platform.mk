@@ -12,6 +12,11 @@ MULTI_CONSOLE_API	:=	1
 
 STM32_TF_VERSION	?=	0
 
+# Restore the DDR training results saved in the backup registers on cold boot
+STM32MP1_DDR_FAST_BOOT	?=	0
+$(eval $(call assert_boolean,STM32MP1_DDR_FAST_BOOT))
+$(eval $(call add_define,STM32MP1_DDR_FAST_BOOT))
+
 # Not needed for Cortex-A7
 WORKAROUND_CVE_2017_5715:=	0
 
@@ -44,6 +49,7 @@ PLAT_BL_COMMON_SOURCES	+=	${XLAT_TABLES_LIB_SRCS}
 PLAT_BL_COMMON_SOURCES	+=	lib/cpus/aarch32/cortex_a7.S
 
 PLAT_BL_COMMON_SOURCES	+=	${LIBFDT_SRCS}						\
+				common/fdt_wrappers.c					\
 				drivers/arm/tzc/tzc400.c				\
 				drivers/delay_timer/delay_timer.c			\
 				drivers/delay_timer/generic_delay_timer.c		\
@@ -77,6 +83,10 @@ BL2_SOURCES		+=	drivers/mmc/mmc.c					\
 BL2_SOURCES		+=	drivers/st/ddr/stm32mp1_ddr.c				\
 				drivers/st/ddr/stm32mp1_ram.c
 
+ifeq (${STM32MP1_DDR_FAST_BOOT},1)
+BL2_SOURCES		+=	drivers/st/ddr/stm32mp1_ddr_cal.c
+endif
+
 BL2_SOURCES		+=	common/desc_image_load.c				\
 				plat/st/stm32mp1/plat_bl2_mem_params_desc.c		\
 				plat/st/stm32mp1/plat_image_load.c
@@ -221,8 +221,31 @@ enum ddr_type {
  * STM32MP1 TAMP
  ******************************************************************************/
 #define TAMP_BASE			U(0x5C00A000)
+#define TAMP_SMCR			(TAMP_BASE + U(0x20))
 #define TAMP_BKP_REGISTER_BASE		(TAMP_BASE + U(0x100))
 
+/*
+ * TAMP_SMCR: backup registers 0 to BKPRWPROT - 1 are secure read/write, and
+ * registers BKPRWPROT to BKPWPROT - 1 are secure write, non-secure read.
+ */
+#define TAMP_SMCR_BKPRWPROT_MASK	GENMASK(7, 0)
+#define TAMP_SMCR_BKPRWPROT_SHIFT	0
+#define TAMP_SMCR_BKPWPROT_MASK		GENMASK(23, 16)
+#define TAMP_SMCR_BKPWPROT_SHIFT	16
+
+/*
+ * Backup registers layout:
+ * - 0 to 3: unused,
+ * - 4 and 5: Cortex-A7 core 1 magic number and branch address, written by the
+ *   secure PSCI (stm32mp1_pm.c) and read by the ROM code (see boot_api.h),
+ * - 6 to 19: saved DDR training results (STM32MP1_DDR_FAST_BOOT), in the
+ *   secure write zone, which then also covers registers 0 to 5,
+ * - 20: boot interface (stm32mp1_context.c),
+ * - 21 and above: free for the non-secure world, e.g. the boot counter.
+ */
+#define TAMP_DDR_CAL_BACKUP_REG_ID	U(6)
+#define TAMP_DDR_CAL_BACKUP_REG_NB	U(14)
+
 #if !(defined(__LINKER__) || defined(__ASSEMBLY__))
 static inline uint32_t tamp_bkpr(uint32_t idx)
 {
@@ -12,6 +12,7 @@
 #include <platform_def.h>
 
 #include <common/debug.h>
+#include <common/fdt_wrappers.h>
 #include <drivers/st/stm32_gpio.h>
 #include <drivers/st/stm32mp1_clk.h>
 #include <drivers/st/stm32mp1_clkfunc.h>
@@ -32,6 +33,10 @@ int dt_open_and_check(void)
 
 	if (ret == 0) {
 		fdt_checked = 1;
+#if FDT_INDEX
+		/* Lookups fall back to walking the DT if this fails */
+		(void)fdtw_index_build(fdt);
+#endif
 	}
 
 	return ret;
@@ -203,7 +208,7 @@ int dt_get_node(struct dt_node_info *info, int offset, const char *compat)
 {
 	int node;
 
-	node = fdt_node_offset_by_compatible(fdt, offset, compat);
+	node = fdtw_node_offset_by_compatible(fdt, offset, compat);
 	if (node < 0) {
 		return -FDT_ERR_NOTFOUND;
 	}
@@ -241,7 +246,7 @@ int dt_get_stdout_node_offset(void)
 	int node;
 	const char *cchar;
 
-	node = fdt_path_offset(fdt, "/chosen");
+	node = fdtw_path_offset(fdt, "/chosen");
 	if (node < 0) {
 		return -FDT_ERR_NOTFOUND;
 	}
@@ -265,10 +270,10 @@ int dt_get_stdout_node_offset(void)
 		name = fdt_get_alias_namelen(fdt, cchar, len);
 
 		if (name != NULL) {
-			node = fdt_path_offset(fdt, name);
+			node = fdtw_path_offset(fdt, name);
 		}
 	} else {
-		node = fdt_path_offset(fdt, cchar);
+		node = fdtw_path_offset(fdt, cchar);
 	}
 
 	return node;
@@ -282,7 +287,7 @@ uint32_t dt_get_ddr_size(void)
 {
 	int node;
 
-	node = fdt_node_offset_by_compatible(fdt, -1, DT_DDR_COMPAT);
+	node = fdtw_node_offset_by_compatible(fdt, -1, DT_DDR_COMPAT);
 	if (node < 0) {
 		INFO("%s: Cannot read DDR node in DT\n", __func__);
 		return 0;
@@ -297,7 +302,7 @@ uint32_t dt_get_ddr_size(void)
  ******************************************************************************/
 const char *dt_get_board_model(void)
 {
-	int node = fdt_path_offset(fdt, "/");
+	int node = fdtw_path_offset(fdt, "/");
 
 	if (node < 0) {
 		return NULL;
@@ -2,11 +2,12 @@
  * Texas Instruments System Control Interface Driver
  *   Based on Linux and U-Boot implementation
  *
- * Copyright (C) 2018 Texas Instruments Incorporated - http://www.ti.com/
+ * Copyright (C) 2018-2019 Texas Instruments Incorporated - http://www.ti.com/
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <assert.h>
 #include <errno.h>
 #include <stdbool.h>
 #include <stddef.h>
@@ -15,6 +16,7 @@
 #include <platform_def.h>
 
 #include <common/debug.h>
+#include <lib/spinlock.h>
 #include <sec_proxy.h>
 
 #include "ti_sci_protocol.h"
@@ -34,10 +36,22 @@ struct ti_sci_desc {
  * struct ti_sci_info - Structure representing a TI SCI instance
  * @desc:	SoC description for this instance
  * @seq:	Seq id used for verification for tx and rx message
+ * @batch_lock:	Held by the CPU which has a batch open
+ * @batch:	A batch started by ti_sci_batch_begin() is open
+ * @no_wait:	The open batch was started by ti_sci_batch_begin_no_wait()
+ * @batch_ret:	First error reported for a message of the open batch
+ * @num_pending: Number of messages sent whose ACK has not been received
+ * @pending_seq: Seq ids of these messages
  */
 struct ti_sci_info {
 	const struct ti_sci_desc desc;
 	uint8_t seq;
+	spinlock_t batch_lock;
+	bool batch;
+	bool no_wait;
+	int batch_ret;
+	unsigned int num_pending;
+	uint8_t pending_seq[TI_SCI_MAX_PENDING];
 };
 
 static struct ti_sci_info info = {
@@ -95,7 +109,13 @@ static int ti_sci_setup_one_xfer(uint16_t msg_type, uint32_t msg_flags,
 	hdr->seq = info.seq;
 	hdr->type = msg_type;
 	hdr->host = info.desc.host_id;
-	hdr->flags = msg_flags | TI_SCI_FLAG_REQ_ACK_ON_PROCESSED;
+	hdr->flags = msg_flags;
+
+	/* A batch started without waiting doesn't ask for bare ACKs */
+	if (info.no_wait && (rx_message_size == sizeof(*hdr)))
+		hdr->flags |= TI_SCI_FLAG_REQ_GENERIC_NORESPONSE;
+	else
+		hdr->flags |= TI_SCI_FLAG_REQ_ACK_ON_PROCESSED;
 
 	xfer->tx_message.buf = tx_buf;
 	xfer->tx_message.len = tx_message_size;
@@ -149,23 +169,105 @@ static inline int ti_sci_get_response(struct ti_sci_xfer *xfer,
 	return 0;
 }
 
+/**
+ * ti_sci_collect_one() - Receive the ACK of one of the pending messages
+ *
+ * Return: 0 if the message was processed, else appropriate error message
+ */
+static int ti_sci_collect_one(void)
+{
+	struct ti_sci_msg_hdr hdr;
+	struct k3_sec_proxy_msg msg;
+	unsigned int i;
+	int ret;
+
+	msg.buf = (uint8_t *)&hdr;
+	msg.len = sizeof(hdr);
+
+	ret = k3_sec_proxy_recv(SP_RESPONSE, &msg);
+	if (ret) {
+		ERROR("Message receive failed (%d)\n", ret);
+		/* The ACKs still pending can't be matched anymore */
+		info.num_pending = 0;
+		return ret;
+	}
+
+	for (i = 0; i < info.num_pending; i++) {
+		if (info.pending_seq[i] == hdr.seq)
+			break;
+	}
+
+	if (i == info.num_pending) {
+		ERROR("Message for %d is not expected\n", hdr.seq);
+		return -EINVAL;
+	}
+
+	/* Drop the message from the pending list */
+	info.num_pending--;
+	for (; i < info.num_pending; i++)
+		info.pending_seq[i] = info.pending_seq[i + 1];
+
+	if (!(hdr.flags & TI_SCI_FLAG_RESP_GENERIC_ACK)) {
+		ERROR("Message %d type 0x%x was not processed\n",
+		      hdr.seq, hdr.type);
+		return -ENODEV;
+	}
+
+	return 0;
+}
+
+/**
+ * ti_sci_collect_all() - Receive the ACKs of all the pending messages
+ *
+ * The first error is kept in @batch_ret, to be returned by ti_sci_batch_end().
+ */
+static void ti_sci_collect_all(void)
+{
+	int ret;
+
+	while (info.num_pending) {
+		ret = ti_sci_collect_one();
+		if (ret && !info.batch_ret)
+			info.batch_ret = ret;
+	}
+}
+
 /**
  * ti_sci_do_xfer() - Do one transfer
  *
  * @xfer:	Transfer to initiate and wait for response
  *
+ * Within a batch, a message whose response is a bare ACK is only sent, and its
+ * ACK is collected later, or never requested in a batch started without
+ * waiting. Otherwise the ACKs of the messages already sent are
+ * collected first, so that the response to this message is the next one in the
+ * receive queue.
+ *
  * Return: 0 if all goes well, else appropriate error message
  */
 static inline int ti_sci_do_xfer(struct ti_sci_xfer *xfer)
 {
 	struct k3_sec_proxy_msg *msg = &xfer->tx_message;
+	bool ack_only = (xfer->rx_message.len == sizeof(struct ti_sci_msg_hdr));
 	int ret;
 
+	if (info.num_pending && !(info.batch && ack_only))
+		ti_sci_collect_all();
+
 	/* Clear any spurious messages in receive queue */
-	ret = k3_sec_proxy_clear_rx_thread(SP_RESPONSE);
-	if (ret) {
-		ERROR("Could not clear response queue (%d)\n", ret);
-		return ret;
+	if (!info.num_pending) {
+		ret = k3_sec_proxy_clear_rx_thread(SP_RESPONSE);
+		if (ret) {
+			ERROR("Could not clear response queue (%d)\n", ret);
+			return ret;
+		}
+	}
+
+	/* Make room for one more message in flight */
+	if (info.num_pending == TI_SCI_MAX_PENDING) {
+		ret = ti_sci_collect_one();
+		if (ret && !info.batch_ret)
+			info.batch_ret = ret;
 	}
 
 	/* Send the message */
@@ -175,6 +277,12 @@ static inline int ti_sci_do_xfer(struct ti_sci_xfer *xfer)
 		return ret;
 	}
 
+	if (info.batch && ack_only) {
+		if (!info.no_wait)
+			info.pending_seq[info.num_pending++] = info.seq;
+		return 0;
+	}
+
 	/* Get the response */
 	ret = ti_sci_get_response(xfer, SP_RESPONSE);
 	if (ret) {
@@ -185,6 +293,64 @@ static inline int ti_sci_do_xfer(struct ti_sci_xfer *xfer)
 	return 0;
 }
 
+/**
+ * ti_sci_batch_begin() - Start a batch of messages
+ *
+ * Until ti_sci_batch_end() is called, the messages whose response is a bare
+ * ACK are sent without waiting for the response to the previous one, keeping
+ * up to TI_SCI_MAX_PENDING messages in flight. The calls sending them return 0
+ * once the message is sent, a NAK is reported by ti_sci_batch_end(). Messages
+ * are still processed by the system controller in the order they are sent.
+ * A CPU starting a batch waits until the batch of another CPU has ended.
+ */
+void ti_sci_batch_begin(void)
+{
+	spin_lock(&info.batch_lock);
+	assert(!info.batch);
+
+	info.batch = true;
+	info.batch_ret = 0;
+}
+
+/**
+ * ti_sci_batch_begin_no_wait() - Start a batch of messages without responses
+ *
+ * Until ti_sci_batch_end() is called, the messages whose response is a bare
+ * ACK are sent without requesting a response, as needed on the paths where the
+ * caller won't be able to receive it, such as a core powering itself down. The
+ * calls sending them return 0 once the message is sent, and whether the system
+ * controller processed them is never known.
+ */
+void ti_sci_batch_begin_no_wait(void)
+{
+	ti_sci_batch_begin();
+
+	info.no_wait = true;
+}
+
+/**
+ * ti_sci_batch_end() - Wait for all the messages of a batch to be processed
+ *
+ * Return: 0 if all the messages of the batch were processed, else the error
+ * reported for the first message that wasn't
+ */
+int ti_sci_batch_end(void)
+{
+	int ret;
+
+	assert(info.batch);
+
+	ti_sci_collect_all();
+
+	ret = info.batch_ret;
+	info.batch = false;
+	info.no_wait = false;
+	info.batch_ret = 0;
+	spin_unlock(&info.batch_lock);
+
+	return ret;
+}
+
 /**
  * ti_sci_get_revision() - Get the revision of the SCI entity
  *
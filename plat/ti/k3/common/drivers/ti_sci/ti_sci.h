@@ -2,7 +2,7 @@
  * Texas Instruments System Control Interface API
  *   Based on Linux and U-Boot implementation
  *
- * Copyright (C) 2018 Texas Instruments Incorporated - http://www.ti.com/
+ * Copyright (C) 2018-2019 Texas Instruments Incorporated - http://www.ti.com/
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -206,6 +206,27 @@ int ti_sci_proc_wait_boot_status_no_wait(uint8_t proc_id,
 					 uint32_t status_flags_1_clr_all_wait,
 					 uint32_t status_flags_1_clr_any_wait);
 
+/**
+ * Message batching
+ *
+ * - ti_sci_batch_begin - Start sending the messages whose response is a bare
+ *			  ACK without waiting for the previous response
+ * - ti_sci_batch_begin_no_wait - Start sending the messages whose response is
+ *				  a bare ACK without requesting any response
+ * - ti_sci_batch_end - Wait for all the messages sent since
+ *			ti_sci_batch_begin() to be processed
+ *
+ * Inside a batch, the calls above which only expect an ACK return 0 once the
+ * message has been sent. ti_sci_batch_end() returns 0 if all the messages of
+ * the batch were processed, else the error for the first one that was not.
+ * Calls which expect data in the response wait for the whole batch first.
+ * A batch started with ti_sci_batch_begin_no_wait() is fire-and-forget:
+ * ti_sci_batch_end() returns 0 as the ACKs are never requested.
+ */
+void ti_sci_batch_begin(void);
+void ti_sci_batch_begin_no_wait(void);
+int ti_sci_batch_end(void);
+
 /**
  * ti_sci_init() - Basic initialization
  *
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -42,7 +42,7 @@ static void k3_cpu_standby(plat_local_state_t cpu_state)
 
 static int k3_pwr_domain_on(u_register_t mpidr)
 {
-	int core_id, proc, device, ret;
+	int core_id, proc, device, ret, batch_ret;
 
 	core_id = plat_core_pos_by_mpidr(mpidr);
 	if (core_id < 0) {
@@ -53,15 +53,22 @@ static int k3_pwr_domain_on(u_register_t mpidr)
 	proc = PLAT_PROC_START_ID + core_id;
 	device = PLAT_PROC_DEVICE_START_ID + core_id;
 
+	/*
+	 * Send the processor request and the boot address together. If the
+	 * request is refused, so is the boot address, and the core is not
+	 * started below.
+	 */
+	ti_sci_batch_begin();
+
 	ret = ti_sci_proc_request(proc);
-	if (ret) {
-		ERROR("Request for processor failed: %d\n", ret);
-		return PSCI_E_INTERN_FAIL;
-	}
+	if (!ret)
+		ret = ti_sci_proc_set_boot_cfg(proc, k3_sec_entrypoint, 0, 0);
 
-	ret = ti_sci_proc_set_boot_cfg(proc, k3_sec_entrypoint, 0, 0);
+	batch_ret = ti_sci_batch_end();
+	if (!ret)
+		ret = batch_ret;
 	if (ret) {
-		ERROR("Request to set core boot address failed: %d\n", ret);
+		ERROR("Request to configure core failed: %d\n", ret);
 		return PSCI_E_INTERN_FAIL;
 	}
 
@@ -85,8 +92,14 @@ void k3_pwr_domain_off(const psci_power_state_t *target_state)
 	proc = PLAT_PROC_START_ID + core_id;
 	device = PLAT_PROC_DEVICE_START_ID + core_id;
 
+	/*
+	 * This core will be off by the time the system controller processes
+	 * these messages, so send them back to back without asking for ACKs.
+	 */
+	ti_sci_batch_begin_no_wait();
+
 	/* Start by sending wait for WFI command */
-	ret = ti_sci_proc_wait_boot_status_no_wait(proc,
+	ret = ti_sci_proc_wait_boot_status(proc,
 			/*
 			 * Wait maximum time to give us the best chance to get
 			 * to WFI before this command timeouts
@@ -96,15 +109,15 @@ void k3_pwr_domain_off(const psci_power_state_t *target_state)
 			PROC_BOOT_STATUS_FLAG_ARMV8_WFI, 0, 0, 0);
 	if (ret) {
 		ERROR("Sending wait for WFI failed (%d)\n", ret);
-		return;
+	} else {
+		/* Now queue up the core shutdown request */
+		ret = ti_sci_device_put(device);
+		if (ret)
+			ERROR("Sending core shutdown message failed (%d)\n",
+			      ret);
 	}
 
-	/* Now queue up the core shutdown request */
-	ret = ti_sci_device_put_no_wait(device);
-	if (ret) {
-		ERROR("Sending core shutdown message failed (%d)\n", ret);
-		return;
-	}
+	(void)ti_sci_batch_end();
 }
 
 void k3_pwr_domain_on_finish(const psci_power_state_t *target_state)
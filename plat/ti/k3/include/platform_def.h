@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -200,5 +200,7 @@
 
 #define TI_SCI_HOST_ID			10
 #define TI_SCI_MAX_MESSAGE_SIZE		52
+/* Messages in flight in a batch, bounded by the depth of the response queue */
+#define TI_SCI_MAX_PENDING		4
 
 #endif /* PLATFORM_DEF_H */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2018-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -2279,6 +2279,25 @@ static uint32_t pm_clk_invalid_list[] = {CLK_USB0, CLK_USB1, CLK_CSU_SPB,
 	CLK_TIMESTAMP_REF,
 };
 
+/* Bitmap of the invalid clocks, built from pm_clk_invalid_list */
+static uint32_t pm_clk_invalid_bitmap[(CLK_MAX + 31U) / 32U];
+
+/**
+ * pm_api_clock_init() - Build the bitmap of invalid clocks
+ *
+ * This function must be called before any clock query is served, so that
+ * pm_clock_valid() doesn't have to search the list of invalid clocks.
+ */
+void pm_api_clock_init(void)
+{
+	unsigned int i, clock_id;
+
+	for (i = 0; i < ARRAY_SIZE(pm_clk_invalid_list); i++) {
+		clock_id = pm_clk_invalid_list[i];
+		pm_clk_invalid_bitmap[clock_id / 32U] |= BIT_32(clock_id % 32U);
+	}
+}
+
 /**
  * pm_clock_valid - Check if clock is valid or not
  * @clock_id	Id of the clock to be queried
@@ -2293,13 +2312,10 @@ static uint32_t pm_clk_invalid_list[] = {CLK_USB0, CLK_USB1, CLK_CSU_SPB,
  */
 static bool pm_clock_valid(unsigned int clock_id)
 {
-	unsigned int i;
-
-	for (i = 0; i < ARRAY_SIZE(pm_clk_invalid_list); i++)
-		if (pm_clk_invalid_list[i] == clock_id)
-			return 0;
+	if (clock_id >= CLK_MAX)
+		return 1;
 
-	return 1;
+	return !(pm_clk_invalid_bitmap[clock_id / 32U] & BIT_32(clock_id % 32U));
 }
 
 /**
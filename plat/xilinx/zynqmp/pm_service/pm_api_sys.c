@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -9,6 +9,8 @@
  * IPI interrupts
  */
 
+#include <stdbool.h>
+
 #include <arch_helpers.h>
 #include <plat/common/platform.h>
 
@@ -23,6 +25,12 @@
 /* default shutdown/reboot scope is system(2) */
 static unsigned int pm_shutdown_scope = PMF_SHUTDOWN_SUBTYPE_SYSTEM;
 
+/* Silicon ID registers, as returned by the PMU to the first PM_GET_CHIPID */
+static struct {
+	volatile bool valid;
+	uint32_t value[2];
+} pm_chipid;
+
 /**
  * pm_get_shutdown_scope() - Get the currently set shutdown scope
  *
@@ -569,10 +577,32 @@ enum pm_ret_status pm_fpga_get_status(unsigned int *value)
 enum pm_ret_status pm_get_chipid(uint32_t *value)
 {
 	uint32_t payload[PAYLOAD_ARG_CNT];
+	enum pm_ret_status ret;
+
+	/*
+	 * The silicon ID never changes, so only the first call asks the PMU.
+	 * This may be called before the MMU is enabled, so no spinlock is
+	 * used: the values are published before the flag, and CPUs racing on
+	 * the first call just ask the PMU more than once.
+	 */
+	if (pm_chipid.valid) {
+		dmbishld();
+		value[0] = pm_chipid.value[0];
+		value[1] = pm_chipid.value[1];
+		return PM_RET_SUCCESS;
+	}
 
 	/* Send request to the PMU */
 	PM_PACK_PAYLOAD1(payload, PM_GET_CHIPID);
-	return pm_ipi_send_sync(primary_proc, payload, value, 2);
+	ret = pm_ipi_send_sync(primary_proc, payload, value, 2);
+	if (ret == PM_RET_SUCCESS) {
+		pm_chipid.value[0] = value[0];
+		pm_chipid.value[1] = value[1];
+		dmbish();
+		pm_chipid.valid = true;
+	}
+
+	return ret;
 }
 
 /**
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2018-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -121,6 +121,32 @@ static uintptr_t arm_arch_svc_smc_handler(uint32_t smc_fid,
 	}
 }
 
+#if SMC_LEAF_FAST_PATH
+/*
+ * SMCCC_VERSION and SMCCC_ARCH_FEATURES are queried frequently and only return
+ * a value, so they are also registered as leaf runtime services.
+ */
+static rt_svc_leaf_ret_t arm_arch_svc_leaf_handler(uint32_t smc_fid,
+	u_register_t x1,
+	u_register_t x2,
+	u_register_t x3,
+	u_register_t flags)
+{
+	rt_svc_leaf_ret_t ret = { 0U, 0U };
+
+	if (smc_fid == SMCCC_VERSION)
+		ret.x0 = (u_register_t)smccc_version();
+	else
+		ret.x0 = (u_register_t)smccc_arch_features(x1);
+
+	return ret;
+}
+
+DECLARE_RT_SVC_LEAF(smccc_version, SMCCC_VERSION, arm_arch_svc_leaf_handler);
+DECLARE_RT_SVC_LEAF(smccc_arch_features, SMCCC_ARCH_FEATURES,
+		arm_arch_svc_leaf_handler);
+#endif /* SMC_LEAF_FAST_PATH */
+
 /* Register Standard Service Calls as runtime service */
 DECLARE_RT_SVC(
 		arm_arch_svc,
@@ -8,9 +8,12 @@
 #include <errno.h>
 #include <string.h>
 
+#include <platform_def.h>
+
 #include <common/debug.h>
 #include <common/runtime_svc.h>
 #include <lib/el3_runtime/context_mgmt.h>
+#include <lib/object_pool.h>
 #include <lib/smccc.h>
 #include <lib/spinlock.h>
 #include <lib/utils.h>
@@ -37,6 +40,13 @@ typedef enum spci_handle_status {
 } spci_handle_status_t;
 
 typedef struct spci_handle {
+	/*
+	 * Context of the Secure Partition that provides the Secure Service
+	 * referenced by this handle. It is overwritten by spci_handles_pool
+	 * while the handle is closed, so it must be the first field.
+	 */
+	sp_context_t *sp_ctx;
+
 	/* 16-bit value used as reference in all SPCI calls */
 	uint16_t handle;
 
@@ -46,12 +56,6 @@ typedef struct spci_handle {
 	/* Current status of the handle */
 	spci_handle_status_t status;
 
-	/*
-	 * Context of the Secure Partition that provides the Secure Service
-	 * referenced by this handle.
-	 */
-	sp_context_t *sp_ctx;
-
 	/*
 	 * The same handle might be used for multiple requests, keep a reference
 	 * counter of them.
@@ -59,9 +63,21 @@ typedef struct spci_handle {
 	unsigned int num_active_requests;
 } spci_handle_t;
 
-static spci_handle_t spci_handles[PLAT_SPCI_HANDLES_MAX_NUM];
+/*
+ * Number of closed handles that each CPU keeps for itself. The array has room
+ * for them on top of PLAT_SPCI_HANDLES_MAX_NUM, so that the cached handles
+ * never prevent a CPU from opening that many handles.
+ */
+#define SPCI_HANDLES_MAG_SIZE	2U
+
+static spci_handle_t spci_handles[PLAT_SPCI_HANDLES_MAX_NUM +
+				  (PLATFORM_CORE_COUNT * SPCI_HANDLES_MAG_SIZE)];
 static spinlock_t spci_handles_lock;
 
+/* Closed entries of spci_handles, which don't need spci_handles_lock. */
+OBJECT_FREE_POOL_ARRAY_PERCPU(spci_handles_pool, spci_handles,
+			      SPCI_HANDLES_MAG_SIZE);
+
 /*
  * Given a handle and a client ID, return the element of the spci_handles
  * array that contains the information of the handle. It can only return open
@@ -132,7 +148,7 @@ static uint64_t spci_service_handle_open_poll(void *handle, u_register_t x1,
 			u_register_t x2, u_register_t x3, u_register_t x4,
 			u_register_t x5, u_register_t x6, u_register_t x7)
 {
-	unsigned int i;
+	spci_handle_t *handle_info;
 	sp_context_t *sp_ptr;
 	uint16_t service_handle;
 
@@ -153,33 +169,33 @@ static uint64_t spci_service_handle_open_poll(void *handle, u_register_t x1,
 		SMC_RET2(handle, SPCI_NOT_PRESENT, 0);
 	}
 
-	/* Get lock of the array of handles */
-	spin_lock(&spci_handles_lock);
-
 	/*
 	 * We need to record the client ID and Secure Partition that correspond
-	 * to this handle. Look for the first free entry in the array.
+	 * to this handle. Take a free entry of the array.
 	 */
-	for (i = 0; i < PLAT_SPCI_HANDLES_MAX_NUM; i++) {
-		if (spci_handles[i].status == HANDLE_STATUS_CLOSED) {
-			break;
-		}
-	}
+	handle_info = pool_obj_alloc(&spci_handles_pool);
+	if (handle_info == NULL) {
+		struct object_pool_stats stats;
 
-	if (i == PLAT_SPCI_HANDLES_MAX_NUM) {
-		spin_unlock(&spci_handles_lock);
+		pool_get_stats(&spci_handles_pool, &stats);
 
 		WARN("SPCI: Can't open more handles. Client 0x%04x\n",
 		     client_id);
 		WARN("SPCI:   UUID: " PRINT_UUID_FORMAT "\n",
 		     PRINT_UUID_ARGS(uuid));
+		WARN("SPCI:   %zu handles open, %u failures\n", stats.used,
+		     stats.failures);
 
 		SMC_RET2(handle, SPCI_NO_MEMORY, 0);
 	}
 
+	/* Get lock of the array of handles */
+	spin_lock(&spci_handles_lock);
+
 	/* Create new handle value */
 	if (spci_create_handle_value(&service_handle) != 0) {
 		spin_unlock(&spci_handles_lock);
+		pool_obj_free(&spci_handles_pool, handle_info);
 
 		WARN("SPCI: Can't create a new handle value. Client 0x%04x\n",
 		     client_id);
@@ -190,11 +206,11 @@ static uint64_t spci_service_handle_open_poll(void *handle, u_register_t x1,
 	}
 
 	/* Save all information about this handle */
-	spci_handles[i].status = HANDLE_STATUS_OPEN;
-	spci_handles[i].client_id = client_id;
-	spci_handles[i].handle = service_handle;
-	spci_handles[i].num_active_requests = 0U;
-	spci_handles[i].sp_ctx = sp_ptr;
+	handle_info->status = HANDLE_STATUS_OPEN;
+	handle_info->client_id = client_id;
+	handle_info->handle = service_handle;
+	handle_info->num_active_requests = 0U;
+	handle_info->sp_ctx = sp_ptr;
 
 	/* Release lock of the array of handles */
 	spin_unlock(&spci_handles_lock);
@@ -256,12 +272,73 @@ static uint64_t spci_service_handle_close(void *handle, u_register_t x1)
 
 	spin_unlock(&spci_handles_lock);
 
+	pool_obj_free(&spci_handles_pool, handle_info);
+
 	VERBOSE("SPCI: Closed handle 0x%04x by client 0x%04x.\n",
 		service_handle, client_id);
 
 	SMC_RET1(handle, SPCI_SUCCESS);
 }
 
+#if SPM_DEFER_BLOCKING_REQUESTS
+/*******************************************************************************
+ * This function queues a blocking request that can't be served straight away
+ * as a non-blocking request, so that the caller doesn't wait for the Secure
+ * Partition in EL3. It returns SPCI_BUSY and the token to pass to
+ * SPCI_SERVICE_REQUEST_RESUME, or SPCI_NO_MEMORY if the request can't be
+ * queued. It must be called with spci_handles_lock held, and releases it.
+ ******************************************************************************/
+static uint64_t spci_service_request_defer(void *handle,
+			spci_handle_t *handle_info, uint32_t smc_fid,
+			u_register_t x1, u_register_t x2, u_register_t x3,
+			u_register_t x4, u_register_t x5, u_register_t x6,
+			uint16_t request_handle, uint16_t client_id)
+{
+	sp_context_t *sp_ctx = handle_info->sp_ctx;
+	uint32_t token;
+	int rc;
+
+	/* Prevent this handle from being closed */
+	handle_info->num_active_requests += 1;
+
+	spm_sp_request_increase(sp_ctx);
+
+	/* Create new token for this request */
+	token = spci_create_token_value();
+
+	/* Release handle lock */
+	spin_unlock(&spci_handles_lock);
+
+	struct sprt_queue_entry_message message = {
+		.type = SPRT_MSG_TYPE_SERVICE_TUN_REQUEST,
+		.client_id = client_id,
+		.service_handle = request_handle,
+		.session_id = x6,
+		.token = token,
+		.args = {smc_fid, x1, x2, x3, x4, x5}
+	};
+
+	spin_lock(&(sp_ctx->spm_sp_buffer_lock));
+	rc = sprt_push_message((void *)sp_ctx->spm_sp_buffer_base, &message,
+			       SPRT_QUEUE_NUM_NON_BLOCKING);
+	spin_unlock(&(sp_ctx->spm_sp_buffer_lock));
+	if (rc != 0) {
+		spin_lock(&spci_handles_lock);
+		handle_info->num_active_requests -= 1;
+		spin_unlock(&spci_handles_lock);
+		spm_sp_request_decrease(sp_ctx);
+
+		/* Clear x1 so that it can't be taken for a token */
+		SMC_RET2(handle, SPCI_NO_MEMORY, 0);
+	}
+
+	VERBOSE("SPCI: Deferred blocking request of client 0x%04x, token 0x%08x\n",
+		client_id, token);
+
+	SMC_RET2(handle, SPCI_BUSY, token);
+}
+#endif
+
 /*******************************************************************************
  * This function requests a Secure Service from a given handle and client ID.
  ******************************************************************************/
@@ -301,16 +378,17 @@ static uint64_t spci_service_request_blocking(void *handle,
 	cpu_ctx = &(sp_ctx->cpu_ctx);
 
 	/* Blocking requests are only allowed if the queue is empty */
-	if (handle_info->num_active_requests > 0) {
-		spin_unlock(&spci_handles_lock);
-
-		SMC_RET1(handle, SPCI_BUSY);
-	}
-
-	if (spm_sp_request_increase_if_zero(sp_ctx) == -1) {
+	if ((handle_info->num_active_requests > 0) ||
+	    (spm_sp_request_increase_if_zero(sp_ctx) == -1)) {
+#if SPM_DEFER_BLOCKING_REQUESTS
+		return spci_service_request_defer(handle, handle_info, smc_fid,
+						  x1, x2, x3, x4, x5, x6,
+						  request_handle, client_id);
+#else
 		spin_unlock(&spci_handles_lock);
 
 		SMC_RET1(handle, SPCI_BUSY);
+#endif
 	}
 
 	/* Prevent this handle from being closed */
@@ -626,6 +704,41 @@ static uint64_t spci_service_request_resume(void *handle, u_register_t x1,
 	SMC_RET4(handle, SPCI_SUCCESS, rx1, rx2, rx3);
 }
 
+/*******************************************************************************
+ * This function returns how many times CPUs waited for the Secure Partition
+ * that provides the Secure Service of a handle, because another CPU was running
+ * it, and the largest number of CPUs waiting at a time.
+ ******************************************************************************/
+static uint64_t spci_service_get_wait_stats(void *handle, u_register_t x1)
+{
+	spci_handle_t *handle_info;
+	sp_context_t *sp_ctx;
+	uint16_t client_id = x1 & 0x0000FFFFU;
+	uint16_t service_handle = (x1 >> 16) & 0x0000FFFFU;
+	unsigned int count, max_depth;
+
+	spin_lock(&spci_handles_lock);
+
+	handle_info = spci_handle_info_get(service_handle, client_id);
+	if (handle_info == NULL) {
+		spin_unlock(&spci_handles_lock);
+
+		WARN("SPCI_SERVICE_GET_WAIT_STATS: Not found.\n"
+		     "  Handle 0x%04x. Client ID 0x%04x\n", service_handle,
+		     client_id);
+
+		SMC_RET1(handle, SPCI_INVALID_PARAMETER);
+	}
+
+	sp_ctx = handle_info->sp_ctx;
+
+	spin_unlock(&spci_handles_lock);
+
+	sp_state_wait_stats(sp_ctx, &count, &max_depth);
+
+	SMC_RET3(handle, SPCI_SUCCESS, count, max_depth);
+}
+
 /*******************************************************************************
  * This function returns the response of a Secure Service given a handle, a
  * client ID and a token.
@@ -748,6 +861,9 @@ static uintptr_t spci_smc_handler(uint32_t smc_fid, u_register_t x1,
 			return spci_service_get_response(handle, x1, x7);
 		}
 
+		case SPCI_FID_SERVICE_GET_WAIT_STATS:
+			return spci_service_get_wait_stats(handle, x1);
+
 		default:
 			break;
 		}
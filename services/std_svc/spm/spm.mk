@@ -22,6 +22,7 @@ SPM_SOURCES	:=	$(addprefix services/std_svc/spm/,	\
 			spm_setup.c				\
 			spm_xlat.c				\
 			sprt.c)					\
+			lib/object_pool/object_pool.c		\
 			${SPRT_LIB_SOURCES}
 
 INCLUDES	+=	${SPRT_LIB_INCLUDES}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -113,39 +113,90 @@ sp_context_t *spm_sp_get_by_uuid(const uint32_t (*svc_uuid)[4])
 }
 
 /*******************************************************************************
- * Set state of a Secure Partition context.
+ * Set state of a Secure Partition context, and wake up the CPUs waiting in
+ * sp_state_wait_switch() so that they check the new state.
  ******************************************************************************/
 void sp_state_set(sp_context_t *sp_ptr, sp_state_t state)
 {
 	spin_lock(&(sp_ptr->state_lock));
 	sp_ptr->state = state;
 	spin_unlock(&(sp_ptr->state_lock));
+
+	dsbish();
+	sev();
+}
+
+/*
+ * Change the state of a Secure Partition if it is the specified one and it is
+ * the turn of the given ticket. Returns 0 on success, -1 otherwise.
+ */
+static int sp_state_take_turn(sp_context_t *sp_ptr, unsigned int ticket,
+			      sp_state_t from, sp_state_t to)
+{
+	int ret = -1;
+
+	spin_lock(&(sp_ptr->state_lock));
+
+	if ((sp_ptr->state == from) &&
+	    (sp_ptr->wait_ticket_serving == ticket)) {
+		sp_ptr->state = to;
+		sp_ptr->wait_ticket_serving++;
+
+		ret = 0;
+	}
+
+	spin_unlock(&(sp_ptr->state_lock));
+
+	return ret;
 }
 
 /*******************************************************************************
  * Wait until the state of a Secure Partition is the specified one and change it
- * to the desired state.
+ * to the desired state. CPUs waiting for the same partition change its state in
+ * the order they started waiting, and wait in low power with WFE in between
+ * the state changes.
  ******************************************************************************/
 void sp_state_wait_switch(sp_context_t *sp_ptr, sp_state_t from, sp_state_t to)
 {
-	int success = 0;
+	unsigned int ticket, depth;
+
+	spin_lock(&(sp_ptr->state_lock));
 
-	while (success == 0) {
-		spin_lock(&(sp_ptr->state_lock));
+	/* Nobody is waiting and the state is the expected one */
+	if ((sp_ptr->state == from) &&
+	    (sp_ptr->wait_ticket_next == sp_ptr->wait_ticket_serving)) {
+		sp_ptr->state = to;
+		spin_unlock(&(sp_ptr->state_lock));
+		return;
+	}
 
-		if (sp_ptr->state == from) {
-			sp_ptr->state = to;
+	ticket = sp_ptr->wait_ticket_next;
+	sp_ptr->wait_ticket_next++;
 
-			success = 1;
-		}
+	depth = sp_ptr->wait_ticket_next - sp_ptr->wait_ticket_serving;
+	sp_ptr->wait_count++;
+	if (depth > sp_ptr->wait_max_depth) {
+		sp_ptr->wait_max_depth = depth;
+		VERBOSE("SPM: Secure Partition %u: %u CPUs waiting\n",
+			(unsigned int)(sp_ptr - sp_ctx_array), depth);
+	}
 
-		spin_unlock(&(sp_ptr->state_lock));
+	spin_unlock(&(sp_ptr->state_lock));
+
+	/*
+	 * sp_state_set() sends an event after each state change, so a change
+	 * made after a failed check makes the following WFE return.
+	 */
+	while (sp_state_take_turn(sp_ptr, ticket, from, to) != 0) {
+		wfe();
 	}
 }
 
 /*******************************************************************************
  * Check if the state of a Secure Partition is the specified one and, if so,
- * change it to the desired state. Returns 0 on success, -1 on error.
+ * change it to the desired state. It fails if other CPUs are waiting for the
+ * partition in sp_state_wait_switch(), so that they aren't starved. Returns 0
+ * on success, -1 on error.
  ******************************************************************************/
 int sp_state_try_switch(sp_context_t *sp_ptr, sp_state_t from, sp_state_t to)
 {
@@ -153,7 +204,8 @@ int sp_state_try_switch(sp_context_t *sp_ptr, sp_state_t from, sp_state_t to)
 
 	spin_lock(&(sp_ptr->state_lock));
 
-	if (sp_ptr->state == from) {
+	if ((sp_ptr->state == from) &&
+	    (sp_ptr->wait_ticket_next == sp_ptr->wait_ticket_serving)) {
 		sp_ptr->state = to;
 
 		ret = 0;
@@ -164,6 +216,21 @@ int sp_state_try_switch(sp_context_t *sp_ptr, sp_state_t from, sp_state_t to)
 	return ret;
 }
 
+/*******************************************************************************
+ * Return how many times CPUs waited for a Secure Partition in
+ * sp_state_wait_switch(), and the largest number of CPUs waiting at a time.
+ ******************************************************************************/
+void sp_state_wait_stats(sp_context_t *sp_ptr, unsigned int *count,
+			 unsigned int *max_depth)
+{
+	spin_lock(&(sp_ptr->state_lock));
+
+	*count = sp_ptr->wait_count;
+	*max_depth = sp_ptr->wait_max_depth;
+
+	spin_unlock(&(sp_ptr->state_lock));
+}
+
 /*******************************************************************************
  * This function takes an SP context pointer and performs a synchronous entry
  * into it.
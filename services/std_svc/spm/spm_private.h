@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -65,6 +65,17 @@ typedef struct sp_context {
 	sp_state_t state;
 	spinlock_t state_lock;
 
+	/*
+	 * Tickets of the CPUs waiting for the partition to be idle, which get
+	 * it in the order they started waiting. Protected by state_lock.
+	 */
+	unsigned int wait_ticket_next;
+	unsigned int wait_ticket_serving;
+
+	/* Number of waits, and maximum number of CPUs waiting at a time */
+	unsigned int wait_count;
+	unsigned int wait_max_depth;
+
 	unsigned int request_count;
 	spinlock_t request_count_lock;
 
@@ -89,6 +100,8 @@ void spm_sp_setup(sp_context_t *sp_ctx);
 void sp_state_set(sp_context_t *sp_ptr, sp_state_t state);
 void sp_state_wait_switch(sp_context_t *sp_ptr, sp_state_t from, sp_state_t to);
 int sp_state_try_switch(sp_context_t *sp_ptr, sp_state_t from, sp_state_t to);
+void sp_state_wait_stats(sp_context_t *sp_ptr, unsigned int *count,
+			 unsigned int *max_depth);
 
 /* Functions to keep track of the number of active requests per SP */
 void spm_sp_request_increase(sp_context_t *sp_ctx);
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2018-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -35,63 +35,45 @@
  * Allocate elements of the translation contexts for the Secure Partitions.
  */
 
-/* Allocate an array of mmap_region per partition. */
-static struct mmap_region sp_mmap_regions[PLAT_SP_IMAGE_MMAP_REGIONS + 1]
-	[PLAT_SPM_MAX_PARTITIONS];
-static OBJECT_POOL(sp_mmap_regions_pool, sp_mmap_regions,
-	sizeof(mmap_region_t) * (PLAT_SP_IMAGE_MMAP_REGIONS + 1),
-	PLAT_SPM_MAX_PARTITIONS);
+/* Translation context of a partition and the arrays that it uses. */
+struct sp_xlat {
+	xlat_ctx_t ctx;
+	struct mmap_region mmap[PLAT_SP_IMAGE_MMAP_REGIONS + 1];
+	int mapped_regions[PLAT_SP_IMAGE_MAX_XLAT_TABLES];
+};
+
+static struct sp_xlat sp_xlat[PLAT_SPM_MAX_PARTITIONS];
+static OBJECT_POOL_ARRAY(sp_xlat_pool, sp_xlat);
 
-/* Allocate individual translation tables. */
-static uint64_t sp_xlat_tables[XLAT_TABLE_ENTRIES]
-	[(PLAT_SP_IMAGE_MAX_XLAT_TABLES + 1) * PLAT_SPM_MAX_PARTITIONS]
+/*
+ * The translation tables are placed in their own section. The partition that
+ * uses sp_xlat[i] uses the tables at index i too.
+ */
+static uint64_t sp_xlat_tables[PLAT_SPM_MAX_PARTITIONS]
+	[PLAT_SP_IMAGE_MAX_XLAT_TABLES][XLAT_TABLE_ENTRIES]
 	__aligned(XLAT_TABLE_SIZE) __section(PLAT_SP_IMAGE_XLAT_SECTION_NAME);
-static OBJECT_POOL(sp_xlat_tables_pool, sp_xlat_tables,
-	XLAT_TABLE_ENTRIES * sizeof(uint64_t),
-	(PLAT_SP_IMAGE_MAX_XLAT_TABLES + 1) * PLAT_SPM_MAX_PARTITIONS);
 
-/* Allocate base translation tables. */
-static uint64_t sp_xlat_base_tables
+static uint64_t sp_xlat_base_tables[PLAT_SPM_MAX_PARTITIONS]
 	[GET_NUM_BASE_LEVEL_ENTRIES(PLAT_VIRT_ADDR_SPACE_SIZE)]
-	[PLAT_SPM_MAX_PARTITIONS]
 	__aligned(GET_NUM_BASE_LEVEL_ENTRIES(PLAT_VIRT_ADDR_SPACE_SIZE)
 		  * sizeof(uint64_t))
 	__section(PLAT_SP_IMAGE_XLAT_SECTION_NAME);
-static OBJECT_POOL(sp_xlat_base_tables_pool, sp_xlat_base_tables,
-	GET_NUM_BASE_LEVEL_ENTRIES(PLAT_VIRT_ADDR_SPACE_SIZE) * sizeof(uint64_t),
-	PLAT_SPM_MAX_PARTITIONS);
-
-/* Allocate arrays. */
-static int sp_xlat_mapped_regions[PLAT_SP_IMAGE_MAX_XLAT_TABLES]
-	[PLAT_SPM_MAX_PARTITIONS];
-static OBJECT_POOL(sp_xlat_mapped_regions_pool, sp_xlat_mapped_regions,
-	sizeof(int) * PLAT_SP_IMAGE_MAX_XLAT_TABLES, PLAT_SPM_MAX_PARTITIONS);
-
-/* Allocate individual contexts. */
-static xlat_ctx_t sp_xlat_ctx[PLAT_SPM_MAX_PARTITIONS];
-static OBJECT_POOL(sp_xlat_ctx_pool, sp_xlat_ctx, sizeof(xlat_ctx_t),
-	PLAT_SPM_MAX_PARTITIONS);
 
 /* Get handle of Secure Partition translation context */
 xlat_ctx_t *spm_sp_xlat_context_alloc(void)
 {
-	xlat_ctx_t *ctx = pool_alloc(&sp_xlat_ctx_pool);
-
-	struct mmap_region *mmap = pool_alloc(&sp_mmap_regions_pool);
-
-	uint64_t *base_table = pool_alloc(&sp_xlat_base_tables_pool);
-	uint64_t **tables = pool_alloc_n(&sp_xlat_tables_pool,
-					PLAT_SP_IMAGE_MAX_XLAT_TABLES);
-
-	int *mapped_regions = pool_alloc(&sp_xlat_mapped_regions_pool);
-
-	xlat_setup_dynamic_ctx(ctx, PLAT_PHY_ADDR_SPACE_SIZE - 1,
-			       PLAT_VIRT_ADDR_SPACE_SIZE - 1, mmap,
-			       PLAT_SP_IMAGE_MMAP_REGIONS, tables,
-			       PLAT_SP_IMAGE_MAX_XLAT_TABLES, base_table,
-			       EL1_EL0_REGIME, mapped_regions);
-
-	return ctx;
+	struct sp_xlat *sp = pool_alloc(&sp_xlat_pool);
+	unsigned int i = (unsigned int)(sp - sp_xlat);
+
+	xlat_setup_dynamic_ctx(&sp->ctx, PLAT_PHY_ADDR_SPACE_SIZE - 1,
+			       PLAT_VIRT_ADDR_SPACE_SIZE - 1, sp->mmap,
+			       PLAT_SP_IMAGE_MMAP_REGIONS,
+			       (uint64_t **)sp_xlat_tables[i],
+			       PLAT_SP_IMAGE_MAX_XLAT_TABLES,
+			       sp_xlat_base_tables[i],
+			       EL1_EL0_REGIME, sp->mapped_regions);
+
+	return &sp->ctx;
 };
 
 /*******************************************************************************
@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <openssl/sha.h>
+#include <openssl/x509.h>
+
+/* Size of the identifiers of cached certificates */
+#define CACHE_ID_LEN		SHA256_DIGEST_LENGTH
+
+/* Exported API */
+int cache_init(const char *dir);
+int cache_enabled(void);
+int cache_get_image_hash(const char *filename, int md_alg,
+		unsigned char *md, unsigned int md_len);
+void cache_put_image_hash(const char *filename, int md_alg,
+		const unsigned char *md, unsigned int md_len);
+X509 *cache_get_cert(const unsigned char *id);
+void cache_put_cert(const unsigned char *id, X509 *x);
+
+#endif /* CACHE_H */
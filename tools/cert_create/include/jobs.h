@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef JOBS_H
+#define JOBS_H
+
+/* Function called by jobs_run() for each item, with its index */
+typedef void (*job_fn_t)(int idx, void *arg);
+
+/* Exported API */
+void jobs_set_num(int num);
+int jobs_get_num(void);
+void jobs_run(int num_items, job_fn_t fn, void *arg);
+double jobs_time_now(void);
+
+#endif /* JOBS_H */
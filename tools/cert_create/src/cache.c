@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#define _XOPEN_SOURCE 700
+
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <openssl/evp.h>
+#include <openssl/sha.h>
+#include <openssl/x509.h>
+
+#include "cache.h"
+#include "debug.h"
+
+/*
+ * The cache is a directory shared by all invocations of the tool, possibly
+ * running concurrently. It holds two kinds of entries, each in its own file
+ * named after a SHA-256 identifier:
+ *
+ *  - "img-<id>": the digest of an image. The identifier is computed from the
+ *    path, inode, size and modification time of the image file and the hash
+ *    algorithm, so that unchanged images are not read again.
+ *
+ *  - "crt-<id>": a certificate in DER format. The identifier is computed by the
+ *    caller from all the inputs of the certificate (see main.c), so that a
+ *    certificate is only signed again if any of its contents or keys changed.
+ *
+ * Entries are written to a temporary file first and then renamed, so that
+ * readers never see a partial entry.
+ */
+
+#define CACHE_PATH_LEN		(PATH_MAX + 80)
+
+static const char *cache_dir;
+
+int cache_init(const char *dir)
+{
+	struct stat st;
+
+	if ((mkdir(dir, 0755) != 0) && (errno != EEXIST)) {
+		ERROR("Cannot create cache directory %s\n", dir);
+		return 1;
+	}
+
+	if ((stat(dir, &st) != 0) || !S_ISDIR(st.st_mode)) {
+		ERROR("Invalid cache directory %s\n", dir);
+		return 1;
+	}
+
+	cache_dir = dir;
+
+	return 0;
+}
+
+int cache_enabled(void)
+{
+	return cache_dir != NULL;
+}
+
+static void cache_path(char *path, const char *prefix,
+		const unsigned char *id)
+{
+	int i, n;
+
+	n = snprintf(path, CACHE_PATH_LEN, "%s/%s-", cache_dir, prefix);
+	for (i = 0; i < CACHE_ID_LEN; i++) {
+		n += snprintf(path + n, CACHE_PATH_LEN - n, "%02x", id[i]);
+	}
+}
+
+/* Write 'len' bytes to the entry at 'path' through a temporary file */
+static void cache_write(const char *path, const unsigned char *data, int len)
+{
+	char tmp[CACHE_PATH_LEN + 32];
+	FILE *file;
+	int ok;
+
+	snprintf(tmp, sizeof(tmp), "%s.%ld.tmp", path, (long)getpid());
+
+	file = fopen(tmp, "wb");
+	if (file == NULL) {
+		return;
+	}
+
+	ok = (fwrite(data, 1, len, file) == (size_t)len);
+	ok = (fclose(file) == 0) && ok;
+
+	if (!ok || (rename(tmp, path) != 0)) {
+		remove(tmp);
+	}
+}
+
+/*
+ * Compute the identifier of the cached digest of an image. Returns 0 if the
+ * image cannot be found.
+ */
+static int cache_image_id(const char *filename, int md_alg, unsigned char *id)
+{
+	char real[PATH_MAX];
+	struct stat st;
+	EVP_MD_CTX *ctx;
+	long long meta[6];
+
+	if ((realpath(filename, real) == NULL) || (stat(real, &st) != 0)) {
+		return 0;
+	}
+
+	meta[0] = (long long)st.st_dev;
+	meta[1] = (long long)st.st_ino;
+	meta[2] = (long long)st.st_size;
+	meta[3] = (long long)st.st_mtim.tv_sec;
+	meta[4] = (long long)st.st_mtim.tv_nsec;
+	meta[5] = md_alg;
+
+	ctx = EVP_MD_CTX_create();
+	if (ctx == NULL) {
+		return 0;
+	}
+
+	EVP_DigestInit_ex(ctx, EVP_sha256(), NULL);
+	EVP_DigestUpdate(ctx, real, strlen(real) + 1);
+	EVP_DigestUpdate(ctx, meta, sizeof(meta));
+	EVP_DigestFinal_ex(ctx, id, NULL);
+	EVP_MD_CTX_destroy(ctx);
+
+	return 1;
+}
+
+/*
+ * Look up the digest of an image in the cache. Returns 1 and fills 'md' if
+ * found, 0 otherwise.
+ */
+int cache_get_image_hash(const char *filename, int md_alg,
+		unsigned char *md, unsigned int md_len)
+{
+	unsigned char id[CACHE_ID_LEN];
+	char path[CACHE_PATH_LEN];
+	FILE *file;
+	size_t n;
+
+	if ((cache_dir == NULL) || !cache_image_id(filename, md_alg, id)) {
+		return 0;
+	}
+
+	cache_path(path, "img", id);
+	file = fopen(path, "rb");
+	if (file == NULL) {
+		return 0;
+	}
+
+	n = fread(md, 1, md_len, file);
+	fclose(file);
+
+	return n == md_len;
+}
+
+void cache_put_image_hash(const char *filename, int md_alg,
+		const unsigned char *md, unsigned int md_len)
+{
+	unsigned char id[CACHE_ID_LEN];
+	char path[CACHE_PATH_LEN];
+
+	if ((cache_dir == NULL) || !cache_image_id(filename, md_alg, id)) {
+		return;
+	}
+
+	cache_path(path, "img", id);
+	cache_write(path, md, md_len);
+}
+
+/* Look up a certificate in the cache. Returns NULL if not found. */
+X509 *cache_get_cert(const unsigned char *id)
+{
+	char path[CACHE_PATH_LEN];
+	FILE *file;
+	X509 *x;
+
+	if (cache_dir == NULL) {
+		return NULL;
+	}
+
+	cache_path(path, "crt", id);
+	file = fopen(path, "rb");
+	if (file == NULL) {
+		return NULL;
+	}
+
+	x = d2i_X509_fp(file, NULL);
+	fclose(file);
+
+	return x;
+}
+
+void cache_put_cert(const unsigned char *id, X509 *x)
+{
+	char path[CACHE_PATH_LEN];
+	unsigned char *der = NULL;
+	int len;
+
+	if (cache_dir == NULL) {
+		return;
+	}
+
+	len = i2d_X509(x, &der);
+	if (len <= 0) {
+		return;
+	}
+
+	cache_path(path, "crt", id);
+	cache_write(path, der, len);
+	OPENSSL_free(der);
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#define _XOPEN_SOURCE 700
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "debug.h"
+#include "jobs.h"
+
+/* Upper bound on the number of worker threads */
+#define JOBS_MAX_NUM		64
+
+struct jobs_ctx {
+	pthread_mutex_t lock;
+	int next;
+	int num_items;
+	job_fn_t fn;
+	void *arg;
+};
+
+static int num_jobs = 1;
+
+void jobs_set_num(int num)
+{
+	if (num < 1) {
+		num = 1;
+	} else if (num > JOBS_MAX_NUM) {
+		num = JOBS_MAX_NUM;
+	}
+
+	num_jobs = num;
+}
+
+int jobs_get_num(void)
+{
+	return num_jobs;
+}
+
+/* Worker thread: pick up the next item until none is left */
+static void *jobs_worker(void *data)
+{
+	struct jobs_ctx *ctx = data;
+	int idx;
+
+	while (1) {
+		pthread_mutex_lock(&ctx->lock);
+		idx = ctx->next++;
+		pthread_mutex_unlock(&ctx->lock);
+
+		if (idx >= ctx->num_items) {
+			break;
+		}
+
+		ctx->fn(idx, ctx->arg);
+	}
+
+	return NULL;
+}
+
+/*
+ * Call 'fn' for every index in [0, num_items) on up to 'num_jobs' threads, and
+ * return once all calls have completed. The calling thread is one of the
+ * workers. With a single job, the items are processed in order.
+ */
+void jobs_run(int num_items, job_fn_t fn, void *arg)
+{
+	pthread_t threads[JOBS_MAX_NUM];
+	struct jobs_ctx ctx;
+	int i, num_threads;
+
+	ctx.next = 0;
+	ctx.num_items = num_items;
+	ctx.fn = fn;
+	ctx.arg = arg;
+	pthread_mutex_init(&ctx.lock, NULL);
+
+	num_threads = (num_jobs < num_items) ? num_jobs : num_items;
+
+	/* Thread 0 is the caller */
+	for (i = 1; i < num_threads; i++) {
+		if (pthread_create(&threads[i], NULL, jobs_worker, &ctx) != 0) {
+			ERROR("Cannot create worker thread\n");
+			exit(1);
+		}
+	}
+
+	jobs_worker(&ctx);
+
+	for (i = 1; i < num_threads; i++) {
+		pthread_join(threads[i], NULL);
+	}
+
+	pthread_mutex_destroy(&ctx.lock);
+}
+
+/* Monotonic wall-clock time in seconds, used to report timings */
+double jobs_time_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2019, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -14,6 +14,7 @@
 #include <openssl/conf.h>
 #include <openssl/engine.h>
 #include <openssl/err.h>
+#include <openssl/opensslv.h>
 #include <openssl/pem.h>
 #include <openssl/sha.h>
 #include <openssl/x509v3.h>
@@ -24,10 +25,12 @@
 #include <platform_oid.h>
 #endif
 
+#include "cache.h"
 #include "cert.h"
 #include "cmd_opt.h"
 #include "debug.h"
 #include "ext.h"
+#include "jobs.h"
 #include "key.h"
 #include "sha.h"
 #include "tbbr/tbb_cert.h"
@@ -72,6 +75,21 @@ static int hash_alg;
 static int new_keys;
 static int save_keys;
 static int print_cert;
+static int print_timing;
+
+/* Image hash algorithm */
+static const EVP_MD *md_info;
+static unsigned int md_len;
+
+/*
+ * Per-extension state, indexed like 'extensions': the digest of the image of
+ * hash extensions, and whether it was found in the cache.
+ */
+static unsigned char (*ext_md)[SHA512_DIGEST_LENGTH];
+static int *ext_md_cached;
+
+/* Per-certificate state: whether the certificate was found in the cache */
+static int *cert_cached;
 
 /* Info messages created in the Makefile */
 extern const char build_msg[];
@@ -260,25 +278,237 @@ PKCS#1 v2.1, 'rsa_1_5' - RSA PKCS#1 v1.5, 'ecdsa'"
 	{
 		{ "print-cert", no_argument, NULL, 'p' },
 		"Print the certificates in the standard output"
+	},
+	{
+		{ "jobs", required_argument, NULL, 'j' },
+		"Number of threads used to generate keys, hash images and \
+sign certificates (default 1)"
+	},
+	{
+		{ "cache-dir", required_argument, NULL, 'c' },
+		"Directory where image hashes and certificates are cached \
+across runs. Unchanged images are not hashed again and certificates whose \
+contents and keys are unchanged are not signed again"
+	},
+	{
+		{ "timing", no_argument, NULL, 't' },
+		"Print the time spent in each step"
 	}
 };
 
-int main(int argc, char *argv[])
+/*
+ * Hash the image of extension 'idx' of the list passed in 'arg', unless its
+ * digest is in the cache.
+ */
+static void hash_ext_job(int idx, void *arg)
+{
+	int ext_idx = ((int *)arg)[idx];
+	ext_t *ext = &extensions[ext_idx];
+
+	if (cache_get_image_hash(ext->arg, hash_alg, ext_md[ext_idx], md_len)) {
+		ext_md_cached[ext_idx] = 1;
+		return;
+	}
+
+	if (!sha_file(hash_alg, ext->arg, ext_md[ext_idx])) {
+		ERROR("Cannot calculate hash of %s\n", ext->arg);
+		exit(1);
+	}
+
+	cache_put_image_hash(ext->arg, hash_alg, ext_md[ext_idx], md_len);
+}
+
+/* Create key 'idx' of the list passed in 'arg' */
+static void create_key_job(int idx, void *arg)
+{
+	key_t *key = &keys[((int *)arg)[idx]];
+
+	NOTICE("Creating new key for '%s'\n", key->desc);
+	if (!key_create(key, key_alg)) {
+		ERROR("Error creating key '%s'\n", key->desc);
+		exit(1);
+	}
+}
+
+static void cert_id_add_str(EVP_MD_CTX *ctx, const char *str)
+{
+	if (str == NULL) {
+		str = "";
+	}
+	EVP_DigestUpdate(ctx, str, strlen(str) + 1);
+}
+
+static void cert_id_add_key(EVP_MD_CTX *ctx, EVP_PKEY *k)
+{
+	unsigned char *der = NULL;
+	int len;
+
+	len = i2d_PUBKEY(k, &der);
+	if (len <= 0) {
+		ERROR("Cannot encode public key\n");
+		exit(1);
+	}
+	EVP_DigestUpdate(ctx, &len, sizeof(len));
+	EVP_DigestUpdate(ctx, der, len);
+	OPENSSL_free(der);
+}
+
+/*
+ * Compute the cache identifier of a certificate: a digest of everything that
+ * goes into it, except for the serial number and validity dates.
+ */
+static void cert_id(const cert_t *cert, unsigned char *id)
+{
+	const cert_t *issuer_cert = &certs[cert->issuer];
+	EVP_PKEY *ikey = keys[issuer_cert->key].key;
+	EVP_PKEY *pkey = keys[cert->key].key;
+	EVP_MD_CTX *ctx;
+	ext_t *ext;
+	int j, params[6];
+
+	CHECK_NULL(ctx, EVP_MD_CTX_create());
+	EVP_DigestInit_ex(ctx, EVP_sha256(), NULL);
+
+	params[0] = key_alg;
+	params[1] = hash_alg;
+	params[2] = VAL_DAYS;
+	params[3] = cert->num_ext;
+	params[4] = (pkey == NULL);
+	/* Without the issuer certificate, the certificate is self-issued */
+	params[5] = (issuer_cert->fn == NULL);
+	EVP_DigestUpdate(ctx, params, sizeof(params));
+
+	cert_id_add_str(ctx, cert->cn);
+	cert_id_add_str(ctx, issuer_cert->cn);
+	cert_id_add_key(ctx, ikey);
+	if (pkey != NULL) {
+		cert_id_add_key(ctx, pkey);
+	}
+
+	for (j = 0 ; j < cert->num_ext ; j++) {
+		ext = &extensions[cert->ext[j]];
+
+		cert_id_add_str(ctx, ext->oid);
+		switch (ext->type) {
+		case EXT_TYPE_NVCOUNTER:
+			cert_id_add_str(ctx, ext->arg);
+			break;
+		case EXT_TYPE_HASH:
+			cert_id_add_str(ctx, (ext->arg != NULL) ? "image" :
+					(ext->optional ? "zero" : "none"));
+			EVP_DigestUpdate(ctx, ext_md[cert->ext[j]], md_len);
+			break;
+		case EXT_TYPE_PKEY:
+			cert_id_add_key(ctx, keys[ext->attr.key].key);
+			break;
+		default:
+			break;
+		}
+	}
+
+	EVP_DigestFinal_ex(ctx, id, NULL);
+	EVP_MD_CTX_destroy(ctx);
+}
+
+/* Create certificate 'idx' of the list passed in 'arg' */
+static void create_cert_job(int idx, void *arg)
 {
 	STACK_OF(X509_EXTENSION) * sk;
 	X509_EXTENSION *cert_ext = NULL;
+	unsigned char id[CACHE_ID_LEN];
+	int cert_idx = ((int *)arg)[idx];
+	cert_t *cert = &certs[cert_idx];
+	ext_t *ext;
+	int j, ext_nid, nvctr;
+
+	if (cache_enabled()) {
+		cert_id(cert, id);
+		cert->x = cache_get_cert(id);
+		if (cert->x != NULL) {
+			cert_cached[cert_idx] = 1;
+			return;
+		}
+	}
+
+	/* Create a new stack of extensions. This stack will be used
+	 * to create the certificate */
+	CHECK_NULL(sk, sk_X509_EXTENSION_new_null());
+
+	for (j = 0 ; j < cert->num_ext ; j++) {
+
+		ext = &extensions[cert->ext[j]];
+
+		/* Get OpenSSL internal ID for this extension */
+		CHECK_OID(ext_nid, ext->oid);
+
+		/*
+		 * Three types of extensions are currently supported:
+		 *     - EXT_TYPE_NVCOUNTER
+		 *     - EXT_TYPE_HASH
+		 *     - EXT_TYPE_PKEY
+		 */
+		switch (ext->type) {
+		case EXT_TYPE_NVCOUNTER:
+			if (ext->arg) {
+				nvctr = atoi(ext->arg);
+				CHECK_NULL(cert_ext, ext_new_nvcounter(ext_nid,
+					EXT_CRIT, nvctr));
+			}
+			break;
+		case EXT_TYPE_HASH:
+			if ((ext->arg == NULL) && !ext->optional) {
+				/* Do not include this hash in the certificate */
+				break;
+			}
+			/*
+			 * The digest was computed beforehand, or is filled
+			 * with zeros for optional images not specified.
+			 */
+			CHECK_NULL(cert_ext, ext_new_hash(ext_nid,
+					EXT_CRIT, md_info, ext_md[cert->ext[j]],
+					md_len));
+			break;
+		case EXT_TYPE_PKEY:
+			CHECK_NULL(cert_ext, ext_new_key(ext_nid,
+				EXT_CRIT, keys[ext->attr.key].key));
+			break;
+		default:
+			ERROR("Unknown extension type '%d' in %s\n",
+					ext->type, cert->cn);
+			exit(1);
+		}
+
+		/* Push the extension into the stack */
+		sk_X509_EXTENSION_push(sk, cert_ext);
+	}
+
+	/* Create certificate. Signed with corresponding key */
+	if (!cert_new(key_alg, hash_alg, cert, VAL_DAYS, 0, sk)) {
+		ERROR("Cannot create %s\n", cert->cn);
+		exit(1);
+	}
+
+	sk_X509_EXTENSION_free(sk);
+
+	if (cache_enabled()) {
+		cache_put_cert(id, cert->x);
+	}
+}
+
+int main(int argc, char *argv[])
+{
 	ext_t *ext;
 	key_t *key;
 	cert_t *cert;
 	FILE *file;
-	int i, j, ext_nid, nvctr;
+	int i, j, num, num_done, num_cached;
 	int c, opt_idx = 0;
+	int *list, *cert_done;
 	const struct option *cmd_opt;
 	const char *cur_opt;
+	const char *cache_dir = NULL;
 	unsigned int err_code;
-	unsigned char md[SHA512_DIGEST_LENGTH];
-	unsigned int  md_len;
-	const EVP_MD *md_info;
+	double t_start, t_keys, t_hash, t_certs, t_end;
 
 	NOTICE("CoT Generation Tool: %s\n", build_msg);
 	NOTICE("Target platform: %s\n", platform_msg);
@@ -315,7 +545,7 @@ int main(int argc, char *argv[])
 
 	while (1) {
 		/* getopt_long stores the option index here. */
-		c = getopt_long(argc, argv, "a:hknps:", cmd_opt, &opt_idx);
+		c = getopt_long(argc, argv, "a:c:hj:knps:t", cmd_opt, &opt_idx);
 
 		/* Detect the end of the options. */
 		if (c == -1) {
@@ -330,9 +560,15 @@ int main(int argc, char *argv[])
 				exit(1);
 			}
 			break;
+		case 'c':
+			cache_dir = optarg;
+			break;
 		case 'h':
 			print_help(argv[0], cmd_opt);
 			exit(0);
+		case 'j':
+			jobs_set_num(atoi(optarg));
+			break;
 		case 'k':
 			save_keys = 1;
 			break;
@@ -349,6 +585,9 @@ int main(int argc, char *argv[])
 				exit(1);
 			}
 			break;
+		case 't':
+			print_timing = 1;
+			break;
 		case CMD_OPT_EXT:
 			cur_opt = cmd_opt_get_name(opt_idx);
 			ext = ext_get_by_opt(cur_opt);
@@ -374,6 +613,27 @@ int main(int argc, char *argv[])
 	/* Check command line arguments */
 	check_cmd_params();
 
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
+	/* Older OpenSSL versions need locking callbacks to be thread-safe */
+	if (jobs_get_num() > 1) {
+		WARN("Parallel jobs require OpenSSL 1.1.0 or later\n");
+		jobs_set_num(1);
+	}
+#endif
+
+	if ((cache_dir != NULL) && (cache_init(cache_dir) != 0)) {
+		exit(1);
+	}
+
+	CHECK_NULL(list, calloc(num_keys + num_extensions + num_certs,
+				sizeof(int)));
+	CHECK_NULL(ext_md, calloc(num_extensions, sizeof(*ext_md)));
+	CHECK_NULL(ext_md_cached, calloc(num_extensions, sizeof(int)));
+	CHECK_NULL(cert_cached, calloc(num_certs, sizeof(int)));
+	CHECK_NULL(cert_done, calloc(num_certs, sizeof(int)));
+
+	t_start = jobs_time_now();
+
 	/* Indicate SHA as image hash algorithm in the certificate
 	 * extension */
 	if (hash_alg == HASH_ALG_SHA384) {
@@ -387,7 +647,11 @@ int main(int argc, char *argv[])
 		md_len  = SHA256_DIGEST_LENGTH;
 	}
 
-	/* Load private keys from files (or generate new ones) */
+	/*
+	 * Load private keys from files. Missing keys are generated afterwards,
+	 * in parallel.
+	 */
+	num = 0;
 	for (i = 0 ; i < num_keys ; i++) {
 		if (!key_new(&keys[i])) {
 			ERROR("Failed to allocate key container\n");
@@ -411,12 +675,8 @@ int main(int argc, char *argv[])
 		/* File does not exist, could not be opened or no filename was
 		 * given */
 		if (new_keys) {
-			/* Try to create a new key */
-			NOTICE("Creating new key for '%s'\n", keys[i].desc);
-			if (!key_create(&keys[i], key_alg)) {
-				ERROR("Error creating key '%s'\n", keys[i].desc);
-				exit(1);
-			}
+			/* Create a new key */
+			list[num++] = i;
 		} else {
 			if (err_code == KEY_ERR_OPEN) {
 				ERROR("Error opening '%s'\n", keys[i].fn);
@@ -427,80 +687,85 @@ int main(int argc, char *argv[])
 		}
 	}
 
-	/* Create the certificates */
-	for (i = 0 ; i < num_certs ; i++) {
-
-		cert = &certs[i];
-
-		/* Create a new stack of extensions. This stack will be used
-		 * to create the certificate */
-		CHECK_NULL(sk, sk_X509_EXTENSION_new_null());
-
-		for (j = 0 ; j < cert->num_ext ; j++) {
-
-			ext = &extensions[cert->ext[j]];
+	jobs_run(num, create_key_job, list);
+	t_keys = jobs_time_now();
+
+	/*
+	 * Calculate the hash of the images. An image passed for several
+	 * extensions is only hashed once.
+	 */
+	num = 0;
+	for (i = 0 ; i < num_extensions ; i++) {
+		ext = &extensions[i];
+		if ((ext->type != EXT_TYPE_HASH) || (ext->arg == NULL)) {
+			continue;
+		}
+		for (j = 0 ; j < num ; j++) {
+			if (strcmp(extensions[list[j]].arg, ext->arg) == 0) {
+				break;
+			}
+		}
+		if (j == num) {
+			list[num++] = i;
+		}
+	}
 
-			/* Get OpenSSL internal ID for this extension */
-			CHECK_OID(ext_nid, ext->oid);
+	jobs_run(num, hash_ext_job, list);
 
-			/*
-			 * Three types of extensions are currently supported:
-			 *     - EXT_TYPE_NVCOUNTER
-			 *     - EXT_TYPE_HASH
-			 *     - EXT_TYPE_PKEY
-			 */
-			switch (ext->type) {
-			case EXT_TYPE_NVCOUNTER:
-				if (ext->arg) {
-					nvctr = atoi(ext->arg);
-					CHECK_NULL(cert_ext, ext_new_nvcounter(ext_nid,
-						EXT_CRIT, nvctr));
-				}
-				break;
-			case EXT_TYPE_HASH:
-				if (ext->arg == NULL) {
-					if (ext->optional) {
-						/* Include a hash filled with zeros */
-						memset(md, 0x0, SHA512_DIGEST_LENGTH);
-					} else {
-						/* Do not include this hash in the certificate */
-						break;
-					}
-				} else {
-					/* Calculate the hash of the file */
-					if (!sha_file(hash_alg, ext->arg, md)) {
-						ERROR("Cannot calculate hash of %s\n",
-							ext->arg);
-						exit(1);
-					}
-				}
-				CHECK_NULL(cert_ext, ext_new_hash(ext_nid,
-						EXT_CRIT, md_info, md,
-						md_len));
-				break;
-			case EXT_TYPE_PKEY:
-				CHECK_NULL(cert_ext, ext_new_key(ext_nid,
-					EXT_CRIT, keys[ext->attr.key].key));
-				break;
-			default:
-				ERROR("Unknown extension type '%d' in %s\n",
-						ext->type, cert->cn);
-				exit(1);
+	num_cached = 0;
+	for (i = 0 ; i < num_extensions ; i++) {
+		ext = &extensions[i];
+		if ((ext->type != EXT_TYPE_HASH) || (ext->arg == NULL)) {
+			continue;
+		}
+		for (j = 0 ; j < num ; j++) {
+			if ((list[j] != i) &&
+			    (strcmp(extensions[list[j]].arg, ext->arg) == 0)) {
+				memcpy(ext_md[i], ext_md[list[j]], md_len);
 			}
+		}
+		num_cached += ext_md_cached[i];
+	}
+	t_hash = jobs_time_now();
+
+	/*
+	 * Create the requested certificates. A certificate can only be created
+	 * once its issuer certificate exists, so they are created in rounds of
+	 * certificates whose issuers are ready. A certificate whose issuer isn't
+	 * requested is self-issued, and can be created straight away.
+	 */
+	num_done = 0;
+	for (i = 0 ; i < num_certs ; i++) {
+		if (certs[i].fn == NULL) {
+			/* Certificate not requested */
+			cert_done[i] = 1;
+			num_done++;
+		}
+	}
 
-			/* Push the extension into the stack */
-			sk_X509_EXTENSION_push(sk, cert_ext);
+	while (num_done < num_certs) {
+		num = 0;
+		for (i = 0 ; i < num_certs ; i++) {
+			cert = &certs[i];
+			if (!cert_done[i] && ((cert->issuer == i) ||
+			    cert_done[cert->issuer])) {
+				list[num++] = i;
+			}
 		}
 
-		/* Create certificate. Signed with corresponding key */
-		if (cert->fn && !cert_new(key_alg, hash_alg, cert, VAL_DAYS, 0, sk)) {
-			ERROR("Cannot create %s\n", cert->cn);
+		if (num == 0) {
+			ERROR("Cannot resolve certificate issuers\n");
 			exit(1);
 		}
 
-		sk_X509_EXTENSION_free(sk);
-	}
+		jobs_run(num, create_cert_job, list);
 
+		for (j = 0 ; j < num ; j++) {
+			cert_done[list[j]] = 1;
+		}
+		num_done += num;
+	}
+	t_certs = jobs_time_now();
 
 	/* Print the certificates */
 	if (print_cert) {
@@ -535,6 +800,29 @@ int main(int argc, char *argv[])
 		}
 	}
 
+	t_end = jobs_time_now();
+
+	if (print_timing) {
+		printf("Time spent (%d jobs):\n", jobs_get_num());
+		printf("  %-24s %8.3f s\n", "Keys", t_keys - t_start);
+		printf("  %-24s %8.3f s (%d from cache)\n", "Image hashes",
+		       t_hash - t_keys, num_cached);
+		num_cached = 0;
+		for (i = 0 ; i < num_certs ; i++) {
+			num_cached += cert_cached[i];
+		}
+		printf("  %-24s %8.3f s (%d from cache)\n", "Certificates",
+		       t_certs - t_hash, num_cached);
+		printf("  %-24s %8.3f s\n", "Output", t_end - t_certs);
+		printf("  %-24s %8.3f s\n", "Total", t_end - t_start);
+	}
+
+	free(cert_done);
+	free(cert_cached);
+	free(ext_md_cached);
+	free(ext_md);
+	free(list);
+
 #ifndef OPENSSL_NO_ENGINE
 	ENGINE_cleanup();
 #endif
@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host test of the save and restore of the STM32MP1 DDR training results. The
+ * driver is built against a mock of the TAMP backup registers, which applies
+ * the secure zones of TAMP_SMCR to the accesses of the non-secure world. The
+ * scenarios below go through cold boots, and check which results are restored,
+ * and which registers the non-secure world can still read and write.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <platform_def.h>
+
+#include <drivers/st/stm32mp1_ddr.h>
+#include <drivers/st/stm32mp1_ddr_cal.h>
+#include <lib/mmio.h>
+
+#define TAMP_BKP_REG_NB		32U
+#define DDR_CAL_END		(TAMP_DDR_CAL_BACKUP_REG_ID + \
+				 TAMP_DDR_CAL_BACKUP_REG_NB)
+
+static uint32_t smcr;
+static uint32_t bkpr[TAMP_BKP_REG_NB];
+
+/* Number of writes done before the power is lost, or -1 */
+static int write_budget;
+
+static void mock_reset(void)
+{
+	smcr = 0U;
+	memset(bkpr, 0, sizeof(bkpr));
+	write_budget = -1;
+}
+
+static uint32_t *mock_reg(uintptr_t addr)
+{
+	if (addr == TAMP_SMCR) {
+		return &smcr;
+	}
+
+	if ((addr >= TAMP_BKP_REGISTER_BASE) &&
+	    (addr < tamp_bkpr(TAMP_BKP_REG_NB)) && ((addr & 3U) == 0U)) {
+		return &bkpr[(addr - TAMP_BKP_REGISTER_BASE) >> 2];
+	}
+
+	fprintf(stderr, "unexpected access to 0x%lx\n", (unsigned long)addr);
+
+	return NULL;
+}
+
+uint32_t mmio_read_32(uintptr_t addr)
+{
+	uint32_t *reg = mock_reg(addr);
+
+	return (reg != NULL) ? *reg : 0U;
+}
+
+void mmio_write_32(uintptr_t addr, uint32_t value)
+{
+	uint32_t *reg = mock_reg(addr);
+
+	if (write_budget == 0) {
+		return;
+	}
+	if (write_budget > 0) {
+		write_budget--;
+	}
+
+	if (reg != NULL) {
+		*reg = value;
+	}
+}
+
+static uint32_t rw_end(void)
+{
+	return (smcr & TAMP_SMCR_BKPRWPROT_MASK) >> TAMP_SMCR_BKPRWPROT_SHIFT;
+}
+
+static uint32_t w_end(void)
+{
+	return (smcr & TAMP_SMCR_BKPWPROT_MASK) >> TAMP_SMCR_BKPWPROT_SHIFT;
+}
+
+/* Accesses from the non-secure world, which return false if refused */
+static bool ns_read(uint32_t idx, uint32_t *value)
+{
+	if (idx < rw_end()) {
+		return false;
+	}
+
+	*value = bkpr[idx];
+
+	return true;
+}
+
+static bool ns_write(uint32_t idx, uint32_t value)
+{
+	if ((idx < rw_end()) || (idx < w_end())) {
+		return false;
+	}
+
+	bkpr[idx] = value;
+
+	return true;
+}
+
+static struct stm32mp1_ddr_config config;
+static struct stm32mp1_ddrphy_cal trained_cal;
+
+static void config_reset(void)
+{
+	memset(&config, 0, sizeof(config));
+	config.info.name = "DDR3-DDR3L 16bits 533000kHz";
+	config.info.speed = 533000U;
+	config.info.size = 0x20000000U;
+	config.c_reg.mstr = 0x00041401U;
+	config.p_timing.ptr0 = 0x0022AA5BU;
+
+	memset(&trained_cal, 0x5A, sizeof(trained_cal));
+	trained_cal.dx0dqtr = 0x01234567U;
+}
+
+/*
+ * A cold boot as done by BL2: returns true if the results were restored,
+ * otherwise trains the DDR and saves its results.
+ */
+static bool cold_boot(void)
+{
+	config.p_cal_present = stm32mp1_ddr_cal_load(&config);
+	if (config.p_cal_present) {
+		return true;
+	}
+
+	memset(&config.p_cal, 0, sizeof(config.p_cal));
+	stm32mp1_ddr_cal_save(&config, &trained_cal);
+
+	return false;
+}
+
+static unsigned int failures;
+
+#define CHECK(cond)							\
+	do {								\
+		if (!(cond)) {						\
+			printf("  FAIL %s:%d: %s\n", __func__,		\
+			       __LINE__, #cond);			\
+			failures++;					\
+		}							\
+	} while (0)
+
+/* The results saved on the first boot are restored on the next one */
+static void test_restore(void)
+{
+	CHECK(!cold_boot());
+	CHECK(cold_boot());
+	CHECK(memcmp(&config.p_cal, &trained_cal, sizeof(trained_cal)) == 0);
+	CHECK(cold_boot());
+}
+
+/* Only the secure write zone is extended, up to the end of the results */
+static void test_zones(void)
+{
+	uint32_t value;
+	uint32_t i;
+
+	smcr = 3U << TAMP_SMCR_BKPRWPROT_SHIFT;
+	CHECK(!cold_boot());
+	CHECK(rw_end() == 3U);
+	CHECK(w_end() == DDR_CAL_END);
+
+	/* The non-secure world reads all the registers of the zone... */
+	for (i = 3U; i < DDR_CAL_END; i++) {
+		CHECK(ns_read(i, &value));
+	}
+	CHECK(ns_read(TAMP_DDR_CAL_BACKUP_REG_ID, &value) && (value != 0U));
+
+	/* ...but can't change the results, and keeps the registers above */
+	CHECK(!ns_write(TAMP_DDR_CAL_BACKUP_REG_ID + 3U, 0U));
+	for (i = DDR_CAL_END; i < TAMP_BKP_REG_NB; i++) {
+		CHECK(ns_write(i, i));
+	}
+	CHECK(cold_boot());
+}
+
+/* Results found outside of the secure write zone are not used */
+static void test_unprotected(void)
+{
+	CHECK(!cold_boot());
+	CHECK(cold_boot());
+
+	/* The zone is lost, and the non-secure world writes the results */
+	smcr = 0U;
+	CHECK(ns_write(TAMP_DDR_CAL_BACKUP_REG_ID + 1U, 0U));
+	CHECK(!cold_boot());
+	CHECK(w_end() == DDR_CAL_END);
+	CHECK(cold_boot());
+	CHECK(memcmp(&config.p_cal, &trained_cal, sizeof(trained_cal)) == 0);
+}
+
+/* Results saved with another DDR configuration are not used */
+static void test_config_change(void)
+{
+	CHECK(!cold_boot());
+
+	config.info.speed = 400000U;
+	CHECK(!cold_boot());
+	CHECK(cold_boot());
+
+	config.c_reg.mstr ^= 1U;
+	CHECK(!cold_boot());
+}
+
+/* Results partially saved when the power was lost are not used */
+static void test_partial_save(void)
+{
+	uint32_t budget;
+
+	for (budget = 0U; budget < TAMP_DDR_CAL_BACKUP_REG_NB + 1U; budget++) {
+		mock_reset();
+		config_reset();
+		/* Invalidation and TAMP_SMCR, then the save */
+		write_budget = 2 + (int)budget;
+		CHECK(!cold_boot());
+		write_budget = -1;
+		CHECK(!cold_boot());
+	}
+	CHECK(cold_boot());
+}
+
+/* Corrupted or invalidated results are not used */
+static void test_corrupted(void)
+{
+	CHECK(!cold_boot());
+
+	bkpr[TAMP_DDR_CAL_BACKUP_REG_ID + 5U] ^= 0x10U;
+	CHECK(!cold_boot());
+	CHECK(cold_boot());
+
+	stm32mp1_ddr_cal_invalidate();
+	CHECK(!cold_boot());
+	CHECK(cold_boot());
+}
+
+static const struct {
+	const char *name;
+	void (*run)(void);
+} tests[] = {
+	{ "restore", test_restore },
+	{ "zones", test_zones },
+	{ "unprotected", test_unprotected },
+	{ "config_change", test_config_change },
+	{ "partial_save", test_partial_save },
+	{ "corrupted", test_corrupted },
+};
+
+int main(void)
+{
+	unsigned int i, failed;
+
+	for (i = 0U; i < (sizeof(tests) / sizeof(tests[0])); i++) {
+		failed = failures;
+		mock_reset();
+		config_reset();
+		tests[i].run();
+		printf("%s %s\n", (failures == failed) ? "PASS" : "FAIL",
+		       tests[i].name);
+	}
+
+	return (failures == 0U) ? 0 : 1;
+}
@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef PLATFORM_DEF_H
+#define PLATFORM_DEF_H
+
+#include <stdint.h>
+
+/* The TAMP definitions of stm32mp1_def.h used by the driver */
+#define U(x)				(x##U)
+#define GENMASK(h, l)			(((~0U) << (l)) & (~0U >> (31 - (h))))
+
+#define TAMP_BASE			U(0x5C00A000)
+#define TAMP_SMCR			(TAMP_BASE + U(0x20))
+#define TAMP_BKP_REGISTER_BASE		(TAMP_BASE + U(0x100))
+
+#define TAMP_SMCR_BKPRWPROT_MASK	GENMASK(7, 0)
+#define TAMP_SMCR_BKPRWPROT_SHIFT	0
+#define TAMP_SMCR_BKPWPROT_MASK		GENMASK(23, 16)
+#define TAMP_SMCR_BKPWPROT_SHIFT	16
+
+#define TAMP_DDR_CAL_BACKUP_REG_ID	U(6)
+#define TAMP_DDR_CAL_BACKUP_REG_NB	U(14)
+
+static inline uint32_t tamp_bkpr(uint32_t idx)
+{
+	return TAMP_BKP_REGISTER_BASE + (idx << 2);
+}
+
+#endif /* PLATFORM_DEF_H */
@@ -0,0 +1,280 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "el3_trace_format.h"
+
+/* Per-CPU slices start on a 64-byte boundary inside the shared buffer */
+#define SLICE_ALIGN		64U
+
+/* One decoded record, tagged with the CPU that produced it */
+struct trace_entry {
+	uint32_t cpu;
+	el3_trace_rec_t rec;
+};
+
+struct event_desc {
+	uint32_t id;
+	const char *name;
+};
+
+static const struct event_desc event_descs[] = {
+	{ EL3_TRACE_EV_SMC_ENTRY,		"smc_entry" },
+	{ EL3_TRACE_EV_SMC_EXIT,		"smc_exit" },
+	{ EL3_TRACE_EV_INTR_ROUTE,		"intr_route" },
+	{ EL3_TRACE_EV_EHF_ACTIVATE,		"ehf_activate" },
+	{ EL3_TRACE_EV_EHF_DEACTIVATE,		"ehf_deactivate" },
+	{ EL3_TRACE_EV_EHF_INTR,		"ehf_intr" },
+	{ EL3_TRACE_EV_PSCI_CPU_ON,		"psci_cpu_on" },
+	{ EL3_TRACE_EV_PSCI_CPU_ON_FINISH,	"psci_cpu_on_finish" },
+	{ EL3_TRACE_EV_PSCI_CPU_OFF,		"psci_cpu_off" },
+	{ EL3_TRACE_EV_PSCI_SUSPEND,		"psci_suspend" },
+	{ EL3_TRACE_EV_PSCI_SUSPEND_FINISH,	"psci_suspend_finish" },
+};
+
+static struct trace_entry *entries;
+static size_t num_entries;
+static uint64_t cntfrq;
+
+static const char *event_name(uint32_t id)
+{
+	size_t i;
+
+	for (i = 0U; i < sizeof(event_descs) / sizeof(event_descs[0]); i++) {
+		if (event_descs[i].id == id)
+			return event_descs[i].name;
+	}
+
+	if (id >= EL3_TRACE_EV_PLAT_BASE)
+		return "plat";
+
+	return "unknown";
+}
+
+/* Allocate a memory area of 'size' bytes. Exit the program on error. */
+static void *xmalloc(size_t size, const char *msg)
+{
+	void *d;
+
+	d = malloc(size);
+	if (d == NULL) {
+		fprintf(stderr, "error: malloc: %s\n", msg);
+		exit(1);
+	}
+
+	return d;
+}
+
+/* Read the whole content of 'filename' into memory. */
+static uint8_t *load_file(const char *filename, size_t *size)
+{
+	FILE *fp;
+	long len;
+	uint8_t *buf;
+
+	fp = fopen(filename, "rb");
+	if (fp == NULL) {
+		fprintf(stderr, "error: Cannot open %s\n", filename);
+		exit(1);
+	}
+
+	if ((fseek(fp, 0L, SEEK_END) != 0) || ((len = ftell(fp)) < 0) ||
+	    (fseek(fp, 0L, SEEK_SET) != 0)) {
+		fprintf(stderr, "error: Cannot get size of %s\n", filename);
+		exit(1);
+	}
+
+	buf = xmalloc((size_t)len + 1U, "trace buffer");
+	if (fread(buf, 1, (size_t)len, fp) != (size_t)len) {
+		fprintf(stderr, "error: Failed to read %s\n", filename);
+		exit(1);
+	}
+
+	fclose(fp);
+	*size = (size_t)len;
+
+	return buf;
+}
+
+/*
+ * Copy the valid records of one per-CPU slice into the 'entries' array. Only
+ * the last 'num_recs' records are still present in the ring.
+ */
+static void collect_slice(const el3_trace_hdr_t *hdr, const uint8_t *recs)
+{
+	uint64_t first, idx;
+	struct trace_entry *e;
+
+	first = 0U;
+	if (hdr->write_idx > hdr->num_recs)
+		first = hdr->write_idx - hdr->num_recs;
+
+	entries = realloc(entries, (num_entries +
+			(size_t)(hdr->write_idx - first)) * sizeof(*entries));
+	if ((entries == NULL) && (hdr->write_idx != first)) {
+		fprintf(stderr, "error: realloc: trace entries\n");
+		exit(1);
+	}
+
+	for (idx = first; idx < hdr->write_idx; idx++) {
+		e = &entries[num_entries++];
+		e->cpu = hdr->cpu;
+		memcpy(&e->rec, recs + ((idx % hdr->num_recs) * hdr->rec_size),
+		       sizeof(e->rec));
+	}
+
+	if (first != 0U)
+		fprintf(stderr, "cpu%u: %" PRIu64 " records lost to wrap-around\n",
+			hdr->cpu, first);
+}
+
+/*
+ * Walk the buffer looking for per-CPU slice headers. The slice size is not
+ * recorded in the buffer, so every aligned offset is checked for a valid
+ * header.
+ */
+static void scan_buffer(const uint8_t *buf, size_t size)
+{
+	size_t off;
+	el3_trace_hdr_t hdr;
+	size_t ring_size;
+
+	off = 0U;
+	while ((off + sizeof(hdr)) <= size) {
+		memcpy(&hdr, buf + off, sizeof(hdr));
+
+		if ((hdr.magic != EL3_TRACE_MAGIC) ||
+		    (hdr.version != EL3_TRACE_VERSION) ||
+		    (hdr.rec_size < sizeof(el3_trace_rec_t)) ||
+		    (hdr.num_recs == 0U)) {
+			off += SLICE_ALIGN;
+			continue;
+		}
+
+		ring_size = (size_t)hdr.num_recs * hdr.rec_size;
+		if ((off + sizeof(hdr) + ring_size) > size) {
+			fprintf(stderr, "warning: truncated slice for cpu%u\n",
+				hdr.cpu);
+			break;
+		}
+
+		cntfrq = hdr.cntfrq;
+		collect_slice(&hdr, buf + off + sizeof(hdr));
+
+		/* Skip the ring; the next slice starts on an aligned offset */
+		off += sizeof(hdr) + ring_size;
+		off = (off + SLICE_ALIGN - 1U) & ~((size_t)SLICE_ALIGN - 1U);
+	}
+}
+
+static int cmp_entry(const void *a, const void *b)
+{
+	const struct trace_entry *ea = a;
+	const struct trace_entry *eb = b;
+
+	if (ea->rec.timestamp < eb->rec.timestamp)
+		return -1;
+	if (ea->rec.timestamp > eb->rec.timestamp)
+		return 1;
+
+	return (int)ea->cpu - (int)eb->cpu;
+}
+
+static void print_entries(int raw)
+{
+	size_t i;
+	uint32_t j;
+	const struct trace_entry *e;
+	uint64_t t0;
+
+	if (num_entries == 0U) {
+		printf("No trace records found.\n");
+		return;
+	}
+
+	t0 = entries[0].rec.timestamp;
+	for (i = 0U; i < num_entries; i++) {
+		e = &entries[i];
+
+		if ((raw != 0) || (cntfrq == 0U))
+			printf("%20" PRIu64, e->rec.timestamp);
+		else
+			printf("%14.3f us", ((double)(e->rec.timestamp - t0) *
+				1000000.0) / (double)cntfrq);
+
+		printf("  cpu%-3u %-20s", e->cpu, event_name(e->rec.event));
+		if (e->rec.event >= EL3_TRACE_EV_PLAT_BASE)
+			printf("(0x%04x)", e->rec.event);
+
+		for (j = 0U; (j < e->rec.nargs) && (j < EL3_TRACE_MAX_ARGS); j++)
+			printf(" 0x%" PRIx64, e->rec.args[j]);
+		printf("\n");
+	}
+}
+
+static void usage(void)
+{
+	printf("usage: el3_trace_decode ");
+#ifdef VERSION
+	printf(VERSION);
+#else
+	/* If built from el3_trace directory, VERSION is not set. */
+	printf("version unknown");
+#endif
+	printf(" [<args>] <dump>\n\n");
+
+	printf("This tool decodes a raw dump of the EL3 trace buffer shared\n"
+	       "with the Normal world and prints the records of all CPUs\n"
+	       "sorted by time.\n\n");
+	printf("Commands supported:\n");
+	printf("  -r                   Print raw counter values instead of\n"
+	       "                       microseconds since the first record.\n");
+	printf("  -h                   Show this message.\n");
+	exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+	int ch;
+	int raw = 0;
+	uint8_t *buf;
+	size_t size;
+
+	while ((ch = getopt(argc, argv, "hr")) != -1) {
+		switch (ch) {
+		case 'r':
+			raw = 1;
+			break;
+		case 'h':
+		default:
+			usage();
+		}
+	}
+
+	argc -= optind;
+	argv += optind;
+
+	if (argc != 1) {
+		fprintf(stderr, "error: A trace dump file must be provided.\n\n");
+		usage();
+	}
+
+	buf = load_file(argv[0], &size);
+	scan_buffer(buf, size);
+	qsort(entries, num_entries, sizeof(*entries), cmp_entry);
+	print_entries(raw);
+
+	free(entries);
+	free(buf);
+
+	return 0;
+}
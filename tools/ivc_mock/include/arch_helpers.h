@@ -0,0 +1,15 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef ARCH_HELPERS_H
+#define ARCH_HELPERS_H
+
+/* Both ends of the channel run on the host, in a single thread */
+#define dmbst()		__sync_synchronize()
+#define dmbld()		__sync_synchronize()
+#define dmbish()	__sync_synchronize()
+
+#endif /* ARCH_HELPERS_H */
@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef DEBUG_H
+#define DEBUG_H
+
+#include <stdio.h>
+
+/* The driver's messages go to stderr, the test results to stdout */
+#define ERROR(...)	fprintf(stderr, "ERROR:   " __VA_ARGS__)
+#define NOTICE(...)	fprintf(stderr, "NOTICE:  " __VA_ARGS__)
+#define WARN(...)	fprintf(stderr, "WARNING: " __VA_ARGS__)
+#define INFO(...)	fprintf(stderr, "INFO:    " __VA_ARGS__)
+#define VERBOSE(...)	fprintf(stderr, "VERBOSE: " __VA_ARGS__)
+
+#endif /* DEBUG_H */
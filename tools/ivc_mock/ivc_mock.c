@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host test of the Tegra IVC driver. Two queues in memory form a channel, and
+ * both of its ends run the driver: "local" stands for BL31, "remote" for the
+ * BPMP firmware. The scenarios move frames one at a time and in batches, and
+ * check the data, the positions after wrapping around, the notifications each
+ * end sends, and that a peer corrupting the counters is caught.
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ivc.h"
+
+#define NFRAMES		8U
+#define FRAME_SIZE	IVC_ALIGN
+
+/* Header of a queue, as laid out by ivc.c */
+#define HDR_SIZE	((IVC_CHHDR_TX_FIELDS + IVC_CHHDR_RX_FIELDS) * 4U)
+#define QUEUE_SIZE	(HDR_SIZE + (NFRAMES * FRAME_SIZE))
+
+/* Offsets of the counters in a queue header */
+#define W_COUNT		0U
+#define R_COUNT		IVC_CHHDR_TX_FIELDS
+
+static uint8_t *queues;
+static struct ivc local, remote;
+/* Notifications sent by each end to its peer */
+static unsigned int local_doorbells, remote_doorbells;
+
+static void local_notify(const struct ivc *ivc)
+{
+	local_doorbells++;
+}
+
+static void remote_notify(const struct ivc *ivc)
+{
+	remote_doorbells++;
+}
+
+/* Counter of the queue written by the local end */
+static volatile uint32_t *local_tx_counter(uint32_t field)
+{
+	return (volatile uint32_t *)(queues + QUEUE_SIZE) + field;
+}
+
+/* Counter of the queue read by the local end */
+static volatile uint32_t *local_rx_counter(uint32_t field)
+{
+	return (volatile uint32_t *)queues + field;
+}
+
+/* Set up the channel and run the reset handshake of both ends */
+static int channel_setup(void)
+{
+	uintptr_t q0, q1;
+	unsigned int i;
+
+	memset(queues, 0, 2U * QUEUE_SIZE);
+	q0 = (uintptr_t)queues;
+	q1 = q0 + QUEUE_SIZE;
+
+	if ((tegra_ivc_init(&local, q0, q1, NFRAMES, FRAME_SIZE,
+			    local_notify) != 0) ||
+	    (tegra_ivc_init(&remote, q1, q0, NFRAMES, FRAME_SIZE,
+			    remote_notify) != 0)) {
+		return -EINVAL;
+	}
+
+	tegra_ivc_channel_reset(&local);
+	tegra_ivc_channel_reset(&remote);
+	for (i = 0U; i < 4U; i++) {
+		int32_t local_ret = tegra_ivc_channel_notified(&local);
+		int32_t remote_ret = tegra_ivc_channel_notified(&remote);
+
+		if ((local_ret == 0) && (remote_ret == 0)) {
+			local_doorbells = 0U;
+			remote_doorbells = 0U;
+			return 0;
+		}
+	}
+
+	return -ECONNRESET;
+}
+
+/* Send 'num' frames from the local end, holding 'first', 'first' + 1, ... */
+static int32_t local_send(uint32_t first, uint32_t num)
+{
+	void *frames[NFRAMES];
+	int32_t count, i;
+
+	count = tegra_ivc_write_get_frames(&local, frames, num);
+	if (count < 0) {
+		return count;
+	}
+
+	for (i = 0; i < count; i++) {
+		memset(frames[i], 0, FRAME_SIZE);
+		memcpy(frames[i], &first, sizeof(first));
+		first++;
+	}
+
+	if (count != 0) {
+		int32_t ret = tegra_ivc_write_advance_frames(&local,
+							     (uint32_t)count);
+		if (ret != 0) {
+			return ret;
+		}
+	}
+
+	return count;
+}
+
+/*
+ * Receive up to 'num' frames on the remote end, checking that they hold
+ * 'first', 'first' + 1, ...
+ */
+static int32_t remote_reap(uint32_t first, uint32_t num, bool *in_order)
+{
+	const void *frames[NFRAMES];
+	int32_t count, i;
+	uint32_t val;
+
+	count = tegra_ivc_read_get_frames(&remote, frames, num);
+	if (count <= 0) {
+		return count;
+	}
+
+	*in_order = true;
+	for (i = 0; i < count; i++) {
+		memcpy(&val, frames[i], sizeof(val));
+		if (val != first++) {
+			*in_order = false;
+		}
+	}
+
+	return (tegra_ivc_read_advance_frames(&remote, (uint32_t)count) == 0) ?
+		count : -EIO;
+}
+
+static unsigned int failures;
+
+#define CHECK(cond)							\
+	do {								\
+		if (!(cond)) {						\
+			printf("  FAIL %s:%d: %s\n", __func__,		\
+			       __LINE__, #cond);			\
+			failures++;					\
+		}							\
+	} while (0)
+
+/* A batch is published with one notification, and reaped in one pass */
+static void test_batch(void)
+{
+	bool in_order = false;
+
+	CHECK(local_send(100U, 5U) == 5);
+	CHECK(remote_doorbells == 0U && local_doorbells == 1U);
+
+	CHECK(remote_reap(100U, NFRAMES, &in_order) == 5);
+	CHECK(in_order);
+
+	/* The channel was not full, so reaping it notifies nobody */
+	CHECK(remote_doorbells == 0U);
+	CHECK(tegra_ivc_tx_empty(&local));
+}
+
+/* The same frames sent one at a time notify the peer once too */
+static void test_single_frames(void)
+{
+	uint32_t i;
+	bool in_order = false;
+
+	for (i = 0U; i < 5U; i++) {
+		CHECK(tegra_ivc_write(&local, &i, sizeof(i)) ==
+		      (int32_t)sizeof(i));
+	}
+	CHECK(local_doorbells == 1U);
+
+	CHECK(remote_reap(0U, NFRAMES, &in_order) == 5);
+	CHECK(in_order);
+}
+
+/* Batches keep their order when the positions wrap around */
+static void test_wrap(void)
+{
+	bool in_order = false;
+
+	CHECK(local_send(0U, 6U) == 6);
+	CHECK(remote_reap(0U, 6U, &in_order) == 6);
+	CHECK(in_order);
+
+	CHECK(local_send(6U, 7U) == 7);
+	CHECK(remote_reap(6U, 3U, &in_order) == 3);
+	CHECK(in_order);
+	CHECK(remote_reap(9U, NFRAMES, &in_order) == 4);
+	CHECK(in_order);
+}
+
+/* A full channel takes no more frames until the peer releases one */
+static void test_full(void)
+{
+	void *frames[NFRAMES];
+	bool in_order = false;
+
+	CHECK(local_send(0U, NFRAMES) == (int32_t)NFRAMES);
+	CHECK(tegra_ivc_write_get_frames(&local, frames, 1U) == -ENOMEM);
+	CHECK(tegra_ivc_write_advance_frames(&local, 1U) == -ENOMEM);
+
+	/* Releasing frames of a full channel notifies the writer once */
+	CHECK(remote_reap(0U, 2U, &in_order) == 2);
+	CHECK(in_order);
+	CHECK(remote_doorbells == 1U);
+
+	CHECK(tegra_ivc_write_get_frames(&local, frames, NFRAMES) == 2);
+	CHECK(tegra_ivc_write_advance_frames(&local, 3U) == -EINVAL);
+	CHECK(tegra_ivc_write_get_frames(&local, frames, NFRAMES + 1U) ==
+	      -EINVAL);
+}
+
+/* A peer can't make the driver hand out frames beyond the channel */
+static void test_over_full(void)
+{
+	const void *rx_frames[NFRAMES];
+	void *tx_frames[NFRAMES];
+
+	/* The remote end claims to have sent more frames than fit */
+	*local_rx_counter(W_COUNT) = NFRAMES + 3U;
+	CHECK(tegra_ivc_read_get_frames(&local, rx_frames, NFRAMES) ==
+	      -ENOMEM);
+	CHECK(tegra_ivc_read_advance_frames(&local, 1U) == -ENOMEM);
+
+	/* The remote end claims to have read frames never sent */
+	*local_tx_counter(R_COUNT) = 2U;
+	CHECK(tegra_ivc_write_get_frames(&local, tx_frames, NFRAMES) ==
+	      -ENOMEM);
+	CHECK(tegra_ivc_write_advance_frames(&local, 1U) == -ENOMEM);
+}
+
+static const struct {
+	const char *name;
+	void (*run)(void);
+} tests[] = {
+	{ "batch", test_batch },
+	{ "single_frames", test_single_frames },
+	{ "wrap", test_wrap },
+	{ "full", test_full },
+	{ "over_full", test_over_full },
+};
+
+int main(void)
+{
+	unsigned int i, failed;
+
+	queues = aligned_alloc(IVC_ALIGN, 2U * QUEUE_SIZE);
+	if (queues == NULL) {
+		return 1;
+	}
+
+	for (i = 0U; i < (sizeof(tests) / sizeof(tests[0])); i++) {
+		failed = failures;
+		if (channel_setup() != 0) {
+			printf("FAIL %s: channel setup\n", tests[i].name);
+			failures++;
+			continue;
+		}
+		tests[i].run();
+		printf("%s %s\n", (failures == failed) ? "PASS" : "FAIL",
+		       tests[i].name);
+	}
+
+	free(queues);
+
+	return (failures == 0U) ? 0 : 1;
+}
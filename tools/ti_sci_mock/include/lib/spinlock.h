@@ -0,0 +1,18 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef SPINLOCK_H
+#define SPINLOCK_H
+
+/* The mock runs the driver on a single thread */
+typedef struct spinlock {
+	volatile unsigned int lock;
+} spinlock_t;
+
+#define spin_lock(l)	((void)(l))
+#define spin_unlock(l)	((void)(l))
+
+#endif /* SPINLOCK_H */
@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host test of the K3 TI-SCI driver. The driver is built against a mock of the
+ * Secure Proxy, which stands for the system controller: every message sent is
+ * processed at once, and its response, if requested, is queued on a response
+ * thread as deep as the real one. The scenarios below check the responses the
+ * driver asks for, how many are in flight, and what the calls return.
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <platform_def.h>
+
+#include <sec_proxy.h>
+#include <ti_sci.h>
+#include <ti_sci_protocol.h>
+
+/* Depth of the response thread, which bounds the messages in flight */
+#define MOCK_RESP_DEPTH		TI_SCI_MAX_PENDING
+
+/* Responses waiting on the response thread */
+static struct ti_sci_msg_hdr resp_queue[MOCK_RESP_DEPTH];
+static unsigned int resp_head, resp_count;
+
+/* Message type which the system controller refuses, or 0 */
+static uint16_t nak_type;
+
+/* What the system controller saw since the last mock_reset() */
+static unsigned int msgs_sent, acks_requested, max_in_flight;
+static bool resp_lost;
+
+static void mock_reset(void)
+{
+	resp_head = 0;
+	resp_count = 0;
+	nak_type = 0;
+	msgs_sent = 0;
+	acks_requested = 0;
+	max_in_flight = 0;
+	resp_lost = false;
+}
+
+static void mock_queue_resp(const struct ti_sci_msg_hdr *hdr)
+{
+	if (resp_count == MOCK_RESP_DEPTH) {
+		resp_lost = true;
+		return;
+	}
+
+	resp_queue[(resp_head + resp_count) % MOCK_RESP_DEPTH] = *hdr;
+	resp_count++;
+	if (resp_count > max_in_flight)
+		max_in_flight = resp_count;
+}
+
+int k3_sec_proxy_clear_rx_thread(enum k3_sec_proxy_chan_id id)
+{
+	resp_head = 0;
+	resp_count = 0;
+
+	return 0;
+}
+
+int k3_sec_proxy_send(enum k3_sec_proxy_chan_id id,
+		      const struct k3_sec_proxy_msg *msg)
+{
+	struct ti_sci_msg_hdr hdr;
+
+	if (msg->len < sizeof(hdr) || msg->len > TI_SCI_MAX_MESSAGE_SIZE)
+		return -EINVAL;
+
+	memcpy(&hdr, msg->buf, sizeof(hdr));
+	msgs_sent++;
+
+	if (!(hdr.flags & (TI_SCI_FLAG_REQ_ACK_ON_RECEIVED |
+			   TI_SCI_FLAG_REQ_ACK_ON_PROCESSED)))
+		return 0;
+
+	acks_requested++;
+	hdr.flags = (hdr.type == nak_type) ? TI_SCI_FLAG_RESP_GENERIC_NACK :
+					     TI_SCI_FLAG_RESP_GENERIC_ACK;
+	mock_queue_resp(&hdr);
+
+	return 0;
+}
+
+int k3_sec_proxy_recv(enum k3_sec_proxy_chan_id id,
+		      struct k3_sec_proxy_msg *msg)
+{
+	if (resp_count == 0)
+		return -ETIMEDOUT;
+
+	/* Data responses carry the header followed by zeroes */
+	memset(msg->buf, 0, msg->len);
+	memcpy(msg->buf, &resp_queue[resp_head], sizeof(resp_queue[0]));
+	resp_head = (resp_head + 1) % MOCK_RESP_DEPTH;
+	resp_count--;
+
+	return 0;
+}
+
+static unsigned int failures;
+
+#define CHECK(cond)							\
+	do {								\
+		if (!(cond)) {						\
+			printf("  FAIL %s:%d: %s\n", __func__,		\
+			       __LINE__, #cond);			\
+			failures++;					\
+		}							\
+	} while (0)
+
+/* A call outside a batch waits for its own ACK */
+static void test_single(void)
+{
+	CHECK(ti_sci_device_get(1) == 0);
+	CHECK(msgs_sent == 1 && acks_requested == 1);
+	CHECK(resp_count == 0);
+}
+
+/* A batch keeps at most TI_SCI_MAX_PENDING messages in flight */
+static void test_batch_window(void)
+{
+	unsigned int i;
+
+	ti_sci_batch_begin();
+	for (i = 0; i < 3 * TI_SCI_MAX_PENDING; i++)
+		CHECK(ti_sci_proc_request(i) == 0);
+	CHECK(max_in_flight == TI_SCI_MAX_PENDING);
+	CHECK(ti_sci_batch_end() == 0);
+
+	CHECK(msgs_sent == 3 * TI_SCI_MAX_PENDING);
+	CHECK(resp_count == 0 && !resp_lost);
+}
+
+/* A NAK inside a batch is reported by ti_sci_batch_end() */
+static void test_batch_nak(void)
+{
+	nak_type = TISCI_MSG_SET_PROC_BOOT_CONFIG;
+
+	ti_sci_batch_begin();
+	CHECK(ti_sci_proc_request(0) == 0);
+	CHECK(ti_sci_proc_set_boot_cfg(0, 0x80000000ULL, 0, 0) == 0);
+	CHECK(ti_sci_proc_release(0) == 0);
+	CHECK(ti_sci_batch_end() == -ENODEV);
+
+	CHECK(resp_count == 0);
+
+	/* The next batch starts clean */
+	nak_type = 0;
+	ti_sci_batch_begin();
+	CHECK(ti_sci_proc_request(0) == 0);
+	CHECK(ti_sci_batch_end() == 0);
+}
+
+/* A call expecting data drains the batch before it is sent */
+static void test_batch_data(void)
+{
+	ti_sci_batch_begin();
+	CHECK(ti_sci_proc_request(0) == 0);
+	CHECK(ti_sci_proc_request(1) == 0);
+	CHECK(ti_sci_device_is_valid(1) == 0);
+	CHECK(max_in_flight == 2);
+	CHECK(ti_sci_proc_release(0) == 0);
+	CHECK(ti_sci_batch_end() == 0);
+
+	CHECK(msgs_sent == 4 && acks_requested == 4);
+	CHECK(resp_count == 0);
+}
+
+/* A batch started without waiting never asks for bare ACKs */
+static void test_no_wait(void)
+{
+	ti_sci_batch_begin_no_wait();
+	CHECK(ti_sci_proc_wait_boot_status(0, UINT8_MAX, 100, UINT8_MAX,
+					   UINT8_MAX,
+					   PROC_BOOT_STATUS_FLAG_ARMV8_WFI,
+					   0, 0, 0) == 0);
+	CHECK(ti_sci_device_put(1) == 0);
+	CHECK(ti_sci_clock_put(1, 0) == 0);
+	CHECK(ti_sci_batch_end() == 0);
+
+	CHECK(msgs_sent == 3 && acks_requested == 0);
+	CHECK(resp_count == 0);
+
+	/* Calls expecting data still get their response */
+	ti_sci_batch_begin_no_wait();
+	CHECK(ti_sci_device_put(1) == 0);
+	CHECK(ti_sci_device_is_valid(1) == 0);
+	CHECK(ti_sci_batch_end() == 0);
+
+	CHECK(acks_requested == 1);
+}
+
+/* A NAK for a message sent without waiting goes unnoticed */
+static void test_no_wait_nak(void)
+{
+	nak_type = TI_SCI_MSG_SET_DEVICE_STATE;
+
+	ti_sci_batch_begin_no_wait();
+	CHECK(ti_sci_device_put(1) == 0);
+	CHECK(ti_sci_batch_end() == 0);
+
+	/* The same message waited for is refused */
+	CHECK(ti_sci_device_put(1) == -ENODEV);
+}
+
+/* A stale response left on the thread is dropped before the next call */
+static void test_stale_response(void)
+{
+	struct ti_sci_msg_hdr stale = {
+		.type = TI_SCI_MSG_SET_DEVICE_STATE,
+		.seq = 0,
+		.flags = TI_SCI_FLAG_RESP_GENERIC_ACK,
+	};
+
+	mock_queue_resp(&stale);
+	CHECK(ti_sci_device_get(1) == 0);
+	CHECK(resp_count == 0);
+}
+
+static const struct {
+	const char *name;
+	void (*run)(void);
+} tests[] = {
+	{ "single", test_single },
+	{ "batch_window", test_batch_window },
+	{ "batch_nak", test_batch_nak },
+	{ "batch_data", test_batch_data },
+	{ "no_wait", test_no_wait },
+	{ "no_wait_nak", test_no_wait_nak },
+	{ "stale_response", test_stale_response },
+};
+
+int main(void)
+{
+	unsigned int i, failed;
+
+	mock_reset();
+	if (ti_sci_init() != 0) {
+		printf("FAIL: ti_sci_init\n");
+		return 1;
+	}
+
+	for (i = 0; i < sizeof(tests) / sizeof(tests[0]); i++) {
+		failed = failures;
+		mock_reset();
+		tests[i].run();
+		printf("%s %s\n", (failures == failed) ? "PASS" : "FAIL",
+		       tests[i].name);
+	}
+
+	return (failures == 0) ? 0 : 1;
+}